@@ -0,0 +1,55 @@
+#include <stdint.h>
+#include "anim.h"
+
+int anim_play(AnimPlayer *p, const AnimClip *clip, uint32_t now)
+{
+	// Start clip from its first frame, carrying on if it is already playing.
+	// Returns 1 if the frame to show changed.
+	if (p->clip == clip)
+		return 0;
+	p->clip = clip;
+	p->frame = 0;
+	p->frame_start = now;
+	return 1;
+}
+int anim_update(AnimPlayer *p, uint32_t now)
+{
+	// Move the playhead on to now. Returns 1 if the frame to show changed, which is
+	// the only time the sprite needs drawing again.
+	uint8_t was = p->frame;
+	if (p->clip == 0)
+		return 0;
+	// Never more than one pass through the clip, after a long stall just pick up from now
+	for (int i = 0; i < p->clip->count; i++)
+	{
+		const AnimFrame *f = &p->clip->frames[p->frame];
+		if (f->ms == 0 || (now - p->frame_start) < f->ms)
+			return p->frame != was;
+		if (p->frame + 1 >= p->clip->count && !p->clip->loop)
+			return p->frame != was;
+		p->frame_start += f->ms;
+		p->frame = (p->frame + 1 >= p->clip->count) ? 0 : p->frame + 1;
+	}
+	p->frame_start = now;
+	return p->frame != was;
+}
+void anim_hold(AnimPlayer *p, uint32_t now)
+{
+	// Keep the current frame up and start its time again, e.g. while the knight stands still
+	p->frame_start = now;
+}
+int anim_done(const AnimPlayer *p, uint32_t now)
+{
+	// A clip that doesn't loop is done once its last frame has had its time
+	const AnimFrame *f;
+	if (p->clip == 0)
+		return 1;
+	if (p->clip->loop || p->frame + 1 < p->clip->count)
+		return 0;
+	f = &p->clip->frames[p->frame];
+	return f->ms != 0 && (now - p->frame_start) >= f->ms;
+}
+const AnimFrame *anim_frame(const AnimPlayer *p)
+{
+	return &p->clip->frames[p->frame];
+}
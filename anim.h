@@ -0,0 +1,38 @@
+#ifndef ANIM_H
+#define ANIM_H
+#include <stdint.h>
+
+#define ANIM_HFLIP 1
+#define ANIM_VFLIP 2
+
+// One frame of a clip: the sprite, how long it stays up in milliseconds (0 holds it for
+// good) and how it is flipped on top of whatever way the entity is facing
+typedef struct
+{
+	const uint16_t *image;
+	uint16_t ms;
+	uint8_t flags;
+} AnimFrame;
+
+// A run of frames, a clip that doesn't loop stays on its last frame
+typedef struct
+{
+	const AnimFrame *frames;
+	uint8_t count;
+	uint8_t loop;
+} AnimClip;
+
+// Where one entity is in its clip
+typedef struct
+{
+	const AnimClip *clip;
+	uint8_t frame;
+	uint32_t frame_start; // milliseconds_uptime when the frame went up
+} AnimPlayer;
+
+int anim_play(AnimPlayer *p, const AnimClip *clip, uint32_t now);
+int anim_update(AnimPlayer *p, uint32_t now);
+void anim_hold(AnimPlayer *p, uint32_t now);
+int anim_done(const AnimPlayer *p, uint32_t now);
+const AnimFrame *anim_frame(const AnimPlayer *p);
+#endif
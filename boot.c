@@ -0,0 +1,103 @@
+#include <stm32f031x6.h>
+#include "boot.h"
+#include "serial.h"
+
+// Reset flags in RCC->CSR
+#define CSR_RMVF (1u << 24)     // write 1 to clear the flags
+#define CSR_OBLRSTF (1u << 25)  // option byte load
+#define CSR_PINRSTF (1u << 26)  // NRST pin, also set by a power on reset
+#define CSR_PORRSTF (1u << 27)  // power on or brown out
+#define CSR_SFTRSTF (1u << 28)  // software (SYSRESETREQ, also what a debugger uses)
+#define CSR_IWDGRSTF (1u << 29) // independent watchdog
+#define CSR_WWDGRSTF (1u << 30) // window watchdog
+#define CSR_LPWRRSTF (1u << 31) // low power management
+// Power was lost or the chip was reconfigured, so neither RAM nor the panel can be trusted
+#define COLD_CAUSES (CSR_PORRSTF | CSR_LPWRRSTF | CSR_OBLRSTF)
+#define WARM_CAUSES (CSR_PINRSTF | CSR_SFTRSTF | CSR_IWDGRSTF | CSR_WWDGRSTF)
+#define INTRO_SEEN 0x4b51a5e1 // "KQ" and a pattern unlikely to be left in RAM at power on
+
+extern volatile uint32_t milliseconds_uptime;
+
+// Kept through a warm reset because the startup code only zeroes .bss. RAM holds
+// garbage after power on, so only the exact value counts and a cold boot clears it.
+static uint32_t intro_seen __attribute__((section(".noinit")));
+
+static uint32_t cause = 0; // RCC->CSR as it was at start up
+static int cold = 1;
+static uint32_t times[BOOT_MILESTONES];
+static uint8_t reached = 0; // bit per milestone already marked
+static const char *const names[BOOT_MILESTONES] = {"peripherals", "panel on", "first frame", "interactive"};
+
+static const char *cause_name(void);
+
+void boot_start()
+{
+	// Read and clear the reset flags, they would otherwise pile up over later resets.
+	// Flags from a debugger or anything unexpected count as cold to be safe.
+	cause = RCC->CSR;
+	RCC->CSR |= CSR_RMVF;
+	cold = (cause & COLD_CAUSES) || !(cause & WARM_CAUSES);
+	if (cold)
+		intro_seen = 0;
+}
+int boot_cold()
+{
+	return cold;
+}
+int boot_watchdog_reset()
+{
+	return (cause & CSR_IWDGRSTF) != 0;
+}
+int boot_intro_seen()
+{
+	return intro_seen == INTRO_SEEN;
+}
+void boot_set_intro_seen()
+{
+	intro_seen = INTRO_SEEN;
+}
+void boot_mark(int milestone)
+{
+	// Only the first time each is reached counts. The log goes out in one go once the
+	// game is interactive, each line at 9600 baud would hold up the boot otherwise.
+	if (reached & (1 << milestone))
+		return;
+	reached |= 1 << milestone;
+	times[milestone] = milliseconds_uptime;
+	if (milestone != BOOT_INTERACTIVE)
+		return;
+	eputs("Boot: ");
+	eputs(cold ? "cold" : "warm");
+	eputs(" start after ");
+	eputs((char *)cause_name());
+	eputs("\r\n");
+	for (int i = 0; i < BOOT_MILESTONES; i++)
+	{
+		if ((reached & (1 << i)) == 0)
+			continue;
+		eputs("Boot: ");
+		eputs((char *)names[i]);
+		eputs(" ");
+		printDecimal((int32_t)times[i]);
+		eputs("ms\r\n");
+	}
+}
+const char *cause_name()
+{
+	// Most telling first, a power on reset sets the pin flag too
+	if (cause & CSR_PORRSTF)
+		return "power on";
+	if (cause & CSR_LPWRRSTF)
+		return "low power reset";
+	if (cause & CSR_OBLRSTF)
+		return "option byte load";
+	if (cause & CSR_IWDGRSTF)
+		return "watchdog";
+	if (cause & CSR_WWDGRSTF)
+		return "window watchdog";
+	if (cause & CSR_SFTRSTF)
+		return "software reset";
+	if (cause & CSR_PINRSTF)
+		return "reset pin";
+	return "unknown reset";
+}
@@ -0,0 +1,17 @@
+#include <stdint.h>
+// Start up: why the chip was reset, what survived it, and how long the way to the first
+// screen that takes input took.
+
+// Milestones, in the order they are normally reached
+#define BOOT_PERIPHERALS 0 // sound, serial, power and the profilers are running
+#define BOOT_PANEL_ON 1    // the panel is out of reset, black and switched on
+#define BOOT_FIRST_FRAME 2 // the first scene's first frame has been drawn
+#define BOOT_INTERACTIVE 3 // a screen that reacts to the buttons is up
+#define BOOT_MILESTONES 4
+
+void boot_start(void);
+int boot_cold(void);
+int boot_watchdog_reset(void);
+int boot_intro_seen(void);
+void boot_set_intro_seen(void);
+void boot_mark(int milestone);
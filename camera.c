@@ -0,0 +1,316 @@
+#include <stdint.h>
+#include "display.h"
+#include "serial.h"
+#include "camera.h"
+
+// Vertically the panel does the scrolling. The GRAM lines below CAMERA_TOP are set up as
+// a ring in which every level row has a fixed line, so moving the camera only changes
+// which line is shown first and a step costs just the rows that came into view.
+// The ST7735 can't scroll sideways, but the level is sprites on black, so the camera
+// remembers where it drew them. A sideways move rubs those out at the old offset and
+// has the level draw the view at the new one, all in the same frame. That costs the
+// sprites in view rather than the whole view, so the camera jumps to centre the knight.
+
+#define SCREEN_HEIGHT 160
+#define COLUMN 8              // the camera moves sideways in steps of this
+#define MAX_SHOWN 20          // sprites remembered, more than a view holds
+#define MARGIN_X 32           // how close the knight may get to the sides of the view
+#define MARGIN_Y 40           // and to its top and bottom
+#define KNIGHT_WIDTH 12
+#define KNIGHT_HEIGHT 16
+
+static uint16_t level_width = CAMERA_VIEW_WIDTH;
+static uint16_t level_height = SCREEN_HEIGHT;
+static int16_t cam_x = 0, cam_y = 0;      // level position of the screen, the view starts at row cam_y + CAMERA_TOP
+static int16_t shown_x = 0, shown_y = 0; // cam_x the screen is drawn for and cam_y the ring holds
+static CameraRedraw redraw = 0;
+// Parts of the view drawn with something other than black, in level pixels. Runs past
+// MAX_SHOWN only in a very busy view, then a sideways move clears all of it.
+typedef struct
+{
+	int16_t x, y;
+	uint8_t w, h;
+} Shown;
+static Shown shown[MAX_SHOWN];
+static uint8_t shown_count = 0;
+static uint8_t shown_overflow = 0;
+static int16_t clip_left, clip_top, clip_right, clip_bottom; // the view, or the part being redrawn
+static uint32_t pushed = 0;              // pixels drawn through the camera
+// Cost of streaming since the last report
+static uint32_t steps = 0, step_pixels = 0, worst_step = 0, shifts = 0;
+
+static void view_clip(void);
+static uint16_t ring_line(int16_t row);
+static int16_t clamp(int16_t v, int16_t lo, int16_t hi);
+static void expose(int16_t x, int16_t y, uint16_t w, uint16_t h);
+static void draw(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image, int hflip, int vflip, uint16_t colour);
+static void shown_add(int16_t left, int16_t top, int16_t right, int16_t bottom);
+static void shown_clear(int16_t left, int16_t top, int16_t right, int16_t bottom);
+static void shown_forget(void);
+
+void camera_init(uint16_t width, uint16_t height, uint16_t focus_x, uint16_t focus_y, CameraRedraw level_redraw)
+{
+	// Start centred on focus_x,focus_y. The screen is expected to be black already, the
+	// caller draws the view as it would for a single screen level.
+	level_width = (width > CAMERA_VIEW_WIDTH) ? width : CAMERA_VIEW_WIDTH;
+	level_height = (height > SCREEN_HEIGHT) ? height : SCREEN_HEIGHT;
+	redraw = level_redraw;
+	cam_x = clamp((int16_t)((focus_x + KNIGHT_WIDTH / 2 - CAMERA_VIEW_WIDTH / 2) & ~(COLUMN - 1)), 0, level_width - CAMERA_VIEW_WIDTH);
+	cam_y = clamp((int16_t)(focus_y + KNIGHT_HEIGHT / 2 - CAMERA_TOP - CAMERA_VIEW_HEIGHT / 2), 0, level_height - SCREEN_HEIGHT);
+	shown_x = cam_x;
+	shown_y = cam_y;
+	shown_forget();
+	view_clip();
+	display_scroll_area(CAMERA_TOP, CAMERA_VIEW_HEIGHT);
+	display_scroll_to(ring_line(cam_y + CAMERA_TOP));
+}
+void camera_release()
+{
+	// Back to a fixed screen so the other scenes can draw in screen coordinates
+	level_width = CAMERA_VIEW_WIDTH;
+	level_height = SCREEN_HEIGHT;
+	cam_x = cam_y = shown_x = shown_y = 0;
+	shown_forget();
+	redraw = 0;
+	view_clip();
+	display_scroll_to(CAMERA_TOP);
+}
+void camera_follow(uint16_t x, uint16_t y)
+{
+	// Keep the knight at x,y inside the margins. Only works out where the camera should
+	// be, camera_stream does the drawing.
+	int16_t new_x = cam_x;
+	int16_t new_y = cam_y;
+	if ((int16_t)x < cam_x + MARGIN_X || (int16_t)x + KNIGHT_WIDTH > cam_x + CAMERA_VIEW_WIDTH - MARGIN_X)
+	{
+		// Sideways moves are expensive, so centre him and leave him a long walk before the next
+		new_x = (int16_t)((x + KNIGHT_WIDTH / 2 - CAMERA_VIEW_WIDTH / 2) & ~(COLUMN - 1));
+		new_x = clamp(new_x, 0, level_width - CAMERA_VIEW_WIDTH);
+	}
+	if ((int16_t)y < cam_y + CAMERA_TOP + MARGIN_Y)
+		new_y = (int16_t)y - CAMERA_TOP - MARGIN_Y;
+	else if ((int16_t)y + KNIGHT_HEIGHT > cam_y + SCREEN_HEIGHT - MARGIN_Y)
+		new_y = (int16_t)y + KNIGHT_HEIGHT - SCREEN_HEIGHT + MARGIN_Y;
+	new_y = clamp(new_y, 0, level_height - SCREEN_HEIGHT);
+	cam_x = new_x;
+	cam_y = new_y;
+	view_clip();
+}
+void camera_position(int16_t *x, int16_t *y)
+{
+	// Level pixel shown at the top left of the screen, the view starts CAMERA_TOP rows below it
+	*x = cam_x;
+	*y = cam_y;
+}
+void camera_stream()
+{
+	// Bring the screen up to date with the camera: scroll and fill in the rows that came
+	// into view. After a sideways move rub out what the screen shows first, the rows
+	// that came into view are cleared along with it and the level draws the lot.
+	uint32_t start = pushed;
+	int sideways = (cam_x != shown_x);
+	if (sideways)
+	{
+		int16_t new_x = cam_x;
+		cam_x = shown_x; // black at the old offset, only the rows still in view
+		view_clip();
+		if (shown_overflow)
+			draw(cam_x, cam_y + CAMERA_TOP, CAMERA_VIEW_WIDTH, CAMERA_VIEW_HEIGHT, 0, 0, 0, 0);
+		else
+			for (int i = shown_count - 1; i >= 0; i--)
+				draw(shown[i].x, shown[i].y, shown[i].w, shown[i].h, 0, 0, 0, 0);
+		shown_forget();
+		cam_x = shown_x = new_x;
+		view_clip();
+	}
+	if (cam_y != shown_y)
+	{
+		int16_t dy = cam_y - shown_y;
+		int16_t y = (dy > 0) ? shown_y + SCREEN_HEIGHT : cam_y + CAMERA_TOP;
+		uint16_t h = (dy > 0) ? dy : -dy;
+		display_scroll_to(ring_line(cam_y + CAMERA_TOP));
+		if (h >= CAMERA_VIEW_HEIGHT)
+		{
+			y = cam_y + CAMERA_TOP;
+			h = CAMERA_VIEW_HEIGHT;
+		}
+		if (sideways)
+			draw(cam_x, y, CAMERA_VIEW_WIDTH, h, 0, 0, 0, 0);
+		else
+			expose(cam_x, y, CAMERA_VIEW_WIDTH, h);
+		shown_y = cam_y;
+		// Whatever scrolled out has gone from the screen
+		for (int i = shown_count - 1; i >= 0; i--)
+		{
+			int16_t top = (shown[i].y > clip_top) ? shown[i].y : clip_top;
+			int16_t bottom = (shown[i].y + shown[i].h < clip_bottom) ? shown[i].y + shown[i].h : clip_bottom;
+			if (top >= bottom)
+				shown[i] = shown[--shown_count];
+			else
+			{
+				shown[i].y = top;
+				shown[i].h = (uint8_t)(bottom - top);
+			}
+		}
+	}
+	if (sideways)
+	{
+		if (redraw)
+			redraw(cam_x, cam_y + CAMERA_TOP, CAMERA_VIEW_WIDTH, CAMERA_VIEW_HEIGHT);
+		shifts++;
+	}
+	if (pushed != start)
+	{
+		steps++;
+		step_pixels += pushed - start;
+		if (pushed - start > worst_step)
+			worst_step = pushed - start;
+	}
+}
+void camera_put_image(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image, int hflip, int vflip)
+{
+	draw(x, y, w, h, image, hflip, vflip, 0);
+}
+void camera_fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t colour)
+{
+	draw(x, y, w, h, 0, 0, 0, colour);
+}
+void camera_report()
+{
+	// Pixels pushed per frame that scrolled, against 17152 for redrawing the whole view
+	eputs("Camera: steps ");
+	printDecimal((int32_t)steps);
+	eputs(" mean ");
+	printDecimal((int32_t)(steps ? step_pixels / steps : 0));
+	eputs("px worst ");
+	printDecimal((int32_t)worst_step);
+	eputs("px shifts ");
+	printDecimal((int32_t)shifts);
+	eputs("\r\n");
+	steps = step_pixels = worst_step = shifts = 0;
+}
+void view_clip()
+{
+	clip_left = cam_x;
+	clip_right = cam_x + CAMERA_VIEW_WIDTH;
+	clip_top = cam_y + CAMERA_TOP;
+	clip_bottom = cam_y + SCREEN_HEIGHT;
+}
+uint16_t ring_line(int16_t row)
+{
+	// GRAM line that holds level row (at or below CAMERA_TOP). Rows are at most a couple
+	// of rings apart, cheaper to subtract than to divide on the M0.
+	int16_t r = row - CAMERA_TOP;
+	while (r >= CAMERA_VIEW_HEIGHT)
+		r -= CAMERA_VIEW_HEIGHT;
+	return (uint16_t)(CAMERA_TOP + r);
+}
+int16_t clamp(int16_t v, int16_t lo, int16_t hi)
+{
+	if (v > hi)
+		v = hi;
+	if (v < lo)
+		v = lo;
+	return v;
+}
+void expose(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	// Clear a part of the view and have the level draw into it, clipped so nothing
+	// outside it is drawn twice
+	if (x > clip_left)
+		clip_left = x;
+	if (y > clip_top)
+		clip_top = y;
+	if (x + w < clip_right)
+		clip_right = x + w;
+	if (y + h < clip_bottom)
+		clip_bottom = y + h;
+	draw(x, y, w, h, 0, 0, 0, 0);
+	if (redraw)
+		redraw(x, y, w, h);
+	view_clip();
+}
+void draw(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image, int hflip, int vflip, uint16_t colour)
+{
+	// Clip to the view and split at the point where the rows wrap round the ring
+	int16_t left = (x > clip_left) ? x : clip_left;
+	int16_t right = (x + w < clip_right) ? x + w : clip_right;
+	int16_t top = (y > clip_top) ? y : clip_top;
+	int16_t bottom = (y + h < clip_bottom) ? y + h : clip_bottom;
+	uint16_t line;
+	if (left >= right || top >= bottom)
+		return;
+	if (image == 0 && colour == 0)
+		shown_clear(left, top, right, bottom);
+	else
+		shown_add(left, top, right, bottom);
+	line = ring_line(top);
+	while (top < bottom)
+	{
+		uint16_t rows = bottom - top;
+		if (rows > CAMERA_TOP + CAMERA_VIEW_HEIGHT - line)
+			rows = CAMERA_TOP + CAMERA_VIEW_HEIGHT - line;
+		if (image == 0)
+			fillRectangle(left - cam_x, line, right - left, rows, colour);
+		else if (right - left == w && rows == h)
+			putImage(left - cam_x, line, w, h, image, hflip, vflip);
+		else
+			putImageRegion(left - cam_x, line, w, h, image, hflip, vflip, left - x, top - y, right - left, rows);
+		pushed += (uint32_t)(right - left) * rows;
+		top += rows;
+		line = CAMERA_TOP;
+	}
+}
+void shown_add(int16_t left, int16_t top, int16_t right, int16_t bottom)
+{
+	// Remember a part of the view that was drawn on. Anything it covers is forgotten,
+	// so a sprite moving along, whose old strips get cleared, keeps to one entry.
+	for (int i = shown_count - 1; i >= 0; i--)
+	{
+		if (shown[i].x >= left && shown[i].x + shown[i].w <= right && shown[i].y >= top && shown[i].y + shown[i].h <= bottom)
+			shown[i] = shown[--shown_count];
+	}
+	if (shown_count == MAX_SHOWN)
+	{
+		shown_overflow = 1;
+		return;
+	}
+	shown[shown_count].x = left;
+	shown[shown_count].y = top;
+	shown[shown_count].w = (uint8_t)(right - left);
+	shown[shown_count].h = (uint8_t)(bottom - top);
+	shown_count++;
+}
+void shown_clear(int16_t left, int16_t top, int16_t right, int16_t bottom)
+{
+	// A black fill: forget what it covers and trim what it cuts a whole side off.
+	// Anything else is left as it is, clearing it again later is only wasted effort.
+	for (int i = shown_count - 1; i >= 0; i--)
+	{
+		Shown *s = &shown[i];
+		int16_t s_right = s->x + s->w, s_bottom = s->y + s->h;
+		int across = (left <= s->x && right >= s_right);
+		int down = (top <= s->y && bottom >= s_bottom);
+		if (across && down)
+			*s = shown[--shown_count];
+		else if (down && left <= s->x && right > s->x)
+		{
+			s->w = (uint8_t)(s_right - right);
+			s->x = right;
+		}
+		else if (down && left < s_right && right >= s_right)
+			s->w = (uint8_t)(left - s->x);
+		else if (across && top <= s->y && bottom > s->y)
+		{
+			s->h = (uint8_t)(s_bottom - bottom);
+			s->y = bottom;
+		}
+		else if (across && top < s_bottom && bottom >= s_bottom)
+			s->h = (uint8_t)(top - s->y);
+	}
+}
+void shown_forget()
+{
+	shown_count = 0;
+	shown_overflow = 0;
+}
@@ -0,0 +1,24 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+#include <stdint.h>
+
+// Levels can be bigger than the screen. Positions are in level pixels and the camera
+// decides which part of the level the screen shows. The rows above CAMERA_TOP hold the
+// HUD and never scroll.
+#define CAMERA_TOP 26
+#define CAMERA_VIEW_WIDTH 128
+#define CAMERA_VIEW_HEIGHT (160 - CAMERA_TOP)
+
+// Called for a part of the level that has just come into view and been cleared to black,
+// it should draw everything that overlaps the rectangle. Drawing is clipped to it.
+typedef void (*CameraRedraw)(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+void camera_init(uint16_t width, uint16_t height, uint16_t focus_x, uint16_t focus_y, CameraRedraw redraw);
+void camera_release(void);
+void camera_follow(uint16_t x, uint16_t y);
+void camera_position(int16_t *x, int16_t *y);
+void camera_stream(void);
+void camera_put_image(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image, int hflip, int vflip);
+void camera_fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t colour);
+void camera_report(void);
+#endif
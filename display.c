@@ -1,8 +1,21 @@
 #include <stm32f031x6.h>
 #include "font5x7.h"
 #include "display.h"
+#include "profile.h"
+#include "format.h"
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 160
+#define PANEL_LINES 160 // lines of GRAM the scroll area is defined over, 162 on panels run in 132x162 mode
+#define PANEL_COLUMNS 128 // columns of GRAM, 132 on panels run in 132x162 mode
+#define MADCTL_DEFAULT 0x08 // BGR pixel order, rows and columns counting up
+#define MADCTL_MX 0x40 // columns count down
+#define MADCTL_MY 0x80 // rows count down
+
+// Every byte sent to the panel and the state of the D/C pin go through PANEL_TAP, which
+// tools/blit_test.c defines to feed its model of the ST7735. Nothing on the chip.
+#ifndef PANEL_TAP
+#define PANEL_TAP(byte, dc) ((void)0)
+#endif
 
 
 
@@ -12,6 +25,7 @@ static void drawLineLowSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1,
 static void drawLineHighSlope(uint16_t x0, uint16_t y0, uint16_t x1,uint16_t y1, uint16_t Colour);
 static int iabs(int x);
 static void openAperture(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+static void blit(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, uint16_t stride, int hOrientation, int vOrientation);
 static void CSLow(void);
 static void CSHigh(void);
 static void DCLow(void);
@@ -24,13 +38,53 @@ static void data(uint8_t data);
 static void ResetLow(void);
 static void ResetHigh(void);
 
+// Power up sequence: a command, its arguments and how long to leave the panel alone
+// afterwards. PANEL_CLEAR is not sent, it blacks out GRAM before the display is switched
+// on so whatever was left in it never shows.
+#define PANEL_CLEAR 0xff
+typedef struct
+{
+	uint8_t cmd;
+	uint8_t argc;
+	uint8_t wait_ms;
+	uint8_t args[6];
+} PanelStep;
+static const PanelStep panel_init[] =
+{
+	{0x01, 0, 120, {0}}, // software reset, 120ms before sleep out
+	{0x11, 0, 120, {0}}, // exit sleep, the booster takes 120ms to settle. A warm boot starts here
+	{0x13, 0, 0, {0}},   // normal display mode, undoes any scrolling left from before a warm reset
+	{0xb1, 3, 0, {0x05, 0x3c, 0x3c}}, // frame rate in normal mode
+	{0xb2, 3, 0, {0x05, 0x3c, 0x3c}}, // in idle mode
+	{0xb3, 6, 0, {0x05, 0x3c, 0x3c, 0x05, 0x3c, 0x3c}}, // in partial mode
+	{0xb4, 1, 0, {0x03}}, // dot invert
+	{0x36, 1, 0, {MADCTL_DEFAULT}}, // pixel and RGB order
+	{0x3a, 1, 0, {0x05}}, // 16 bit colour
+	{PANEL_CLEAR, 0, 0, {0}},
+	{0x29, 0, 0, {0}}, // display on
+};
+#define PANEL_STEPS (sizeof(panel_init) / sizeof(panel_init[0]))
+#define PANEL_RESETTING 0xff // panel_stage while the reset pin is held low
+#define PANEL_WARM_START 1 // the panel may have been left asleep, but needs no reset
 
+extern volatile uint32_t milliseconds_uptime;
 
+static uint8_t panel_stage = PANEL_STEPS; // next entry of panel_init to send
+static uint32_t panel_due = 0;            // when it may be sent
 
-void display_begin()
-{
 
+
+
+void display_begin(int cold)
+{
+	// Pins, SPI and the start of the reset pulse. The rest of the power up is run a step
+	// at a time by display_poll so the other peripherals can start while the panel waits.
+	// After a warm reset the panel has kept its power, so the reset is skipped and it is
+	// only woken and set up again.
 	RCC->AHBENR |= (1 << 17);  // Turn on GPIO A
+	// Reset and CS are set high before they become outputs, a glitch low would reset the panel
+	ResetHigh();
+	CSHigh();
 	// Configure PA3 for Reset pin
 	GPIOA->MODER |= (1 << 6);
 	GPIOA->MODER &= ~(1u << 7);
@@ -41,91 +95,79 @@ void display_begin()
 	GPIOA->MODER |= (1 << 12);
 	GPIOA->MODER &= ~(1u << 13);
 	initSPI();
-	//  hw_test();
-	// Lots of CS toggling here seems to have made the boot up more reliable
-	CSHigh();
-	ResetHigh();	
-	delay(10);
+	if (!cold)
+	{
+		CSLow(); // a new CS cycle drops whatever transfer the reset cut short
+		panel_stage = PANEL_WARM_START;
+		panel_due = milliseconds_uptime;
+		return;
+	}
 	ResetLow();
-	delay(200);
-	ResetHigh();
-	CSHigh();
-	delay(200);
-	CSLow();
-	delay(20);
-	command(0x01); // software reset
-	delay(100);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
+	panel_stage = PANEL_RESETTING;
+	panel_due = milliseconds_uptime + 1; // the pulse only has to be 10us, a tick is plenty
+}
+int display_poll(uint32_t now)
+{
+	// Carry on with the power up. Runs every step whose wait is over, so it costs nothing
+	// but a compare while the panel is busy. Returns 1 once the panel is on and black.
+	while (panel_stage != PANEL_STEPS && (int32_t)(now - panel_due) >= 0)
+	{
+		const PanelStep *step;
+		if (panel_stage == PANEL_RESETTING)
+		{
+			ResetHigh();
+			CSLow(); // held low from here on, nothing else shares the bus
+			panel_stage = 0;
+			panel_due = now + 120; // out of reset 120ms later
+			continue;
+		}
+		step = &panel_init[panel_stage];
+		if (step->cmd == PANEL_CLEAR)
+			fillRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0x0);
+		else
+		{
+			command(step->cmd);
+			for (uint8_t i = 0; i < step->argc; i++)
+				data(step->args[i]);
+		}
+		panel_due = now + step->wait_ms;
+		panel_stage++;
+	}
+	return panel_stage == PANEL_STEPS;
+}
+void display_sleep()
+{
+	// Blank the panel and put its controller to sleep. GRAM is kept so nothing
+	// needs redrawing when it wakes.
+	command(0x28); // display off
+	command(0x10); // enter sleep
+}
+void display_wake()
+{
 	command(0x11); // exit sleep
-	delay(120);
-	// set frame rate
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb1);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb2);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb3);
-	data(0x05);
-	data(0x3c);
-	data(0x3c);	
-	data(0x05);
-	data(0x3c);
-	data(0x3c);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0xb4); // dot invert
-	data(0x03);
-	CSHigh();
-	delay(1);			
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x36);// Set pixel and RGB order
-	data(0x08); 	
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);		
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x3a);// Set colour mode        
-	data(0x5); 	
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x29);    // display on
-	delay(100);
-	CSHigh();
-	delay(1);
-	CSLow();
-	delay(1);
-	command(0x2c);   // put display in to write mode
-
-	fillRectangle(0,0,SCREEN_WIDTH, SCREEN_HEIGHT, 0x0);  // black out the screen
+	delay(120);    // panel needs 120ms after sleep out before further commands
+	command(0x29); // display on
+}
+void display_scroll_area(uint16_t top, uint16_t height)
+{
+	// Lines above top and below top+height stay where they are, the ones in between
+	// scroll as a ring when display_scroll_to moves the start line
+	uint16_t bottom = PANEL_LINES - top - height;
+	command(0x33); // VSCRDEF
+	data(top >> 8);
+	data(top & 0xff);
+	data(height >> 8);
+	data(height & 0xff);
+	data(bottom >> 8);
+	data(bottom & 0xff);
+}
+void display_scroll_to(uint16_t line)
+{
+	// GRAM line shown at the top of the scroll area, top (as given to
+	// display_scroll_area) shows everything where it was drawn
+	command(0x37); // VSCSAD
+	data(line >> 8);
+	data(line & 0xff);
 }
 void ResetLow()
 {
@@ -178,6 +220,7 @@ uint8_t transferSPI8(uint8_t data)
     unsigned Timeout = 1000000;
     uint8_t ReturnValue;
     volatile uint8_t *preg=(volatile uint8_t*)&SPI1->DR;
+	PANEL_TAP(data, (GPIOA->ODR >> 6) & 1);
 	
     while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));
     *preg = data;
@@ -191,6 +234,8 @@ uint16_t transferSPI16(uint16_t data)
 {
     unsigned Timeout = 1000000;
     uint32_t ReturnValue;    
+	PANEL_TAP(data >> 8, 1);
+	PANEL_TAP(data & 0xff, 1);
 	
     while (((SPI1->SR & (1 << 7))!=0)&&(Timeout--));
     SPI1->DR = data;
@@ -249,64 +294,54 @@ void putPixel(uint16_t x, uint16_t y, uint16_t colour)
 }
 void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
 {
-    uint16_t Colour;
-	  uint32_t offset = 0;
-    openAperture(x, y, x + width - 1, y + height - 1);
-    DCHigh();
-	  if (hOrientation == 0)
-		{
-			if (vOrientation == 0)
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=y*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+x];
-								transferSPI16(Colour);
-						}
-				}
-			}
-			else
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=(height-(y+1))*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+x];
-								transferSPI16(Colour);
-						}
-				}
-			}
-		}
-		else
-		{
-			if (vOrientation == 0)
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=y*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+(width-x-1)];
-								transferSPI16(Colour);
-						}
-				}
-			}
-			else
-			{
-				for (y = 0; y < height; y++)
-				{
-						offset=(height-(y+1))*width;
-						for (x = 0; x < width; x++)
-						{
-								Colour = Image[offset+(width-x-1)];
-								transferSPI16(Colour);
-						}
-				}
-			}
-		}
+	PROFILE_BEGIN(PROF_PUTIMAGE);
+	blit(x, y, width, height, Image, width, hOrientation, vOrientation);
+	PROFILE_END(PROF_PUTIMAGE);
+}
+void putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh)
+{
+	// Draw only the sw x sh part of the (already flipped) image starting at sx,sy, at x,y.
+	// Used for sprites that are partly off screen or split by the scroll area.
+	uint16_t col = hOrientation ? width - sx - sw : sx;
+	uint16_t row = vOrientation ? height - sy - sh : sy;
+	PROFILE_BEGIN(PROF_PUTIMAGE);
+	blit(x, y, sw, sh, Image + row * width + col, width, hOrientation, vOrientation);
+	PROFILE_END(PROF_PUTIMAGE);
+}
+void blit(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, uint16_t stride, int hOrientation, int vOrientation)
+{
+	// One pass over the pixels in the order they are stored. Flips are left to the panel:
+	// the MX and MY bits of MADCTL run its column and row counters backwards, so the
+	// window is opened on the mirrored coordinates and filled front to back as usual.
+	uint8_t madctl = MADCTL_DEFAULT;
+	if (hOrientation)
+	{
+		madctl |= MADCTL_MX;
+		x = PANEL_COLUMNS - x - width;
+	}
+	if (vOrientation)
+	{
+		madctl |= MADCTL_MY;
+		y = PANEL_LINES - y - height;
+	}
+	if (madctl != MADCTL_DEFAULT)
+	{
+		command(0x36);
+		data(madctl);
+	}
+	openAperture(x, y, x + width - 1, y + height - 1);
+	DCHigh();
+	for (uint16_t row = 0; row < height; row++)
+	{
+		for (uint16_t col = 0; col < width; col++)
+			transferSPI16(Image[col]);
+		Image += stride;
+	}
+	if (madctl != MADCTL_DEFAULT)
+	{
+		command(0x36);
+		data(MADCTL_DEFAULT);
+	}
 }
 void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour)
 {
@@ -514,37 +549,17 @@ void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour,
 }
 void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
 {
-	// This function converts the supplied number into a character string and then calls on puText to
-    // write it to the display
-    char Buffer[6]; // Maximum value = 65535
-    Buffer[5]=0;
-    Buffer[4] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[3] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[2] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[1] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[0] = Number % 10 + '0';
+	// Five digits with leading zeros, the widest a uint16_t can be
+    char Buffer[6];
+    fmt_uint_pad(Buffer, Number, 5, '0');
     printText(Buffer, x, y, ForeColour, BackColour);
 }
 void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
 {
-     // This function converts the supplied number into a character string and then calls on puText to
-    // write it to the display
-    char Buffer[6]; // Maximum value = 65535
-    Buffer[5]=0;
-    Buffer[4] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[3] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[2] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[1] = Number % 10 + '0';
-    Number = Number / 10;
-    Buffer[0] = Number % 10 + '0';
-    printTextX2(Buffer, x, y, ForeColour, BackColour);	
+	// Five digits with leading zeros, the widest a uint16_t can be
+    char Buffer[6];
+    fmt_uint_pad(Buffer, Number, 5, '0');
+    printTextX2(Buffer, x, y, ForeColour, BackColour);
 }
 uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B)
 {
@@ -1,8 +1,14 @@
-void display_begin(void);
+void display_begin(int cold);
+int display_poll(uint32_t now);
+void display_sleep(void);
+void display_wake(void);
+void display_scroll_area(uint16_t top, uint16_t height);
+void display_scroll_to(uint16_t line);
 void delay(uint32_t dly);
 void fillRectangle(uint16_t x,uint16_t y,uint16_t width, uint16_t height, uint16_t colour);
 void putPixel(uint16_t x, uint16_t y, uint16_t colour);
 void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation,int vOrientation);
+void putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh);
 void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour);
 void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour);
 void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour);
@@ -0,0 +1,243 @@
+#include <stdint.h>
+#include "camera.h"
+#include "grid.h"
+#include "path.h"
+#include "enemy.h"
+#include "profile.h"
+#include "watchdog.h"
+
+#define MAX_CATCH_UP 4   // most ticks run in one update after a stall
+
+// Pixels away a skeleton can spot the knight from per difficulty (index 0 is unset),
+// 0 never chases. Tuned with tools/balance: from 64 the greedy bot won 0.1% of
+// Nightmare runs, at 24 about 18% against Hard's 70%.
+static const uint8_t chase_ranges[] = {0, 0, 0, 0, 24};
+
+static uint32_t tick_ms = 30; // one pixel per tick, roughly the old speed of one pixel per frame
+static const AnimClip *run_clip = 0;
+static const AnimClip *attack_clip = 0;
+
+static void enemy_step(const EnemyWorld *w, Enemy *e, uint16_t knight_x, uint16_t knight_y);
+static int step_towards(int16_t *pos, int target);
+static int inside(const Enemy *e, int px, int py);
+
+void enemy_world_init(EnemyWorld *w, uint32_t now)
+{
+	// An empty grid, no field yet and the first tick a whole tick away
+	grid_clear(&w->grid);
+	flow_init(&w->flow, &w->grid);
+	w->last_tick = now;
+}
+void enemy_init(Enemy *e, const Waypoint *path, uint8_t path_len, int difficulty)
+{
+	// Start on the first waypoint and walk towards the second
+	e->path = path;
+	e->path_len = path_len;
+	e->x = path[0].x;
+	e->y = path[0].y;
+	e->target = (path_len > 1) ? 1 : 0;
+	e->mode = ENEMY_PATROL;
+	if (difficulty < 0 || difficulty > 4)
+		difficulty = 0;
+	e->chase_range = chase_ranges[difficulty];
+	e->facing = 0;
+	e->drawn_x = -1;
+	e->drawn_y = -1;
+	e->drawn_image = 0;
+	e->drawn_flip = 0;
+	e->anim.clip = 0; // starts running on the first update
+}
+void enemy_set_tick(uint32_t ms)
+{
+	if (ms == 0)
+		ms = 1;
+	tick_ms = ms;
+}
+void enemy_set_clips(const AnimClip *run, const AnimClip *attack)
+{
+	run_clip = run;
+	attack_clip = attack;
+}
+void enemy_attack(Enemy *e, uint32_t now)
+{
+	// Play the attack through once, then go back to running
+	anim_play(&e->anim, attack_clip, now);
+}
+int enemy_dirty(const Enemy *e)
+{
+	// 1 if enemies_draw will draw this one, because it moved or its frame changed
+	const AnimFrame *f = anim_frame(&e->anim);
+	return e->drawn_x < 0 || e->x != e->drawn_x || e->y != e->drawn_y ||
+	       f->image != e->drawn_image || (e->facing ^ (f->flags & ANIM_HFLIP)) != e->drawn_flip;
+}
+int enemy_hits(const Enemy *e, uint16_t knight_x, uint16_t knight_y)
+{
+	// 1 if the skeleton touches one of four points on the knight's body, his shoulders
+	// and his middle, so a corner of his sprite brushing past doesn't count
+	return inside(e, knight_x, knight_y + 5) || inside(e, knight_x + 12, knight_y + 5) ||
+	       inside(e, knight_x + 5, knight_y + 11) || inside(e, knight_x + 7, knight_y + 11);
+}
+void enemies_update(EnemyWorld *w, Enemy *e, int count, uint16_t knight_x, uint16_t knight_y, uint32_t now)
+{
+	// Enemies move on their own tick so their speed does not depend on how long a frame takes
+	int ticks = 0;
+	int chasers = 0;
+	WATCHDOG_ZONE_ENTER(PROF_ENEMIES);
+	PROFILE_BEGIN(PROF_ENEMIES);
+	for (int i = 0; i < count; i++)
+	{
+		if (e[i].anim.clip != run_clip && anim_done(&e[i].anim, now))
+			anim_play(&e[i].anim, run_clip, now);
+		else
+			anim_update(&e[i].anim, now);
+	}
+	// Anyone who can chase shares one flow field towards the knight, a slice of
+	// which is computed every frame
+	for (int i = 0; i < count; i++)
+		chasers |= e[i].chase_range;
+	if (chasers)
+	{
+		flow_target(&w->flow, (knight_x + 6) / GRID_TILE, (knight_y + 8) / GRID_TILE);
+		flow_step(&w->flow);
+	}
+	if ((now - w->last_tick) > tick_ms * MAX_CATCH_UP)
+		w->last_tick = now - tick_ms * MAX_CATCH_UP;
+	while ((now - w->last_tick) >= tick_ms)
+	{
+		w->last_tick += tick_ms;
+		ticks++;
+	}
+	while (ticks--)
+	{
+		for (int i = 0; i < count; i++)
+			enemy_step(w, &e[i], knight_x, knight_y);
+	}
+	PROFILE_END(PROF_ENEMIES);
+	WATCHDOG_ZONE_LEAVE(PROF_ENEMIES);
+}
+void enemies_draw(Enemy *e, int count)
+{
+	// Only redraw enemies that moved or changed frame. Rather than clearing the whole old
+	// sprite just clear the strips it uncovered, the new sprite covers the rest.
+	for (int i = 0; i < count; i++)
+	{
+		int dx = e[i].x - e[i].drawn_x;
+		int dy = e[i].y - e[i].drawn_y;
+		const AnimFrame *f = anim_frame(&e[i].anim);
+		if (!enemy_dirty(&e[i]))
+			continue;
+		if (e[i].drawn_x >= 0)
+		{
+			if (dx >= ENEMY_WIDTH || dx <= -ENEMY_WIDTH || dy >= ENEMY_HEIGHT || dy <= -ENEMY_HEIGHT)
+			{
+				camera_fill(e[i].drawn_x, e[i].drawn_y, ENEMY_WIDTH, ENEMY_HEIGHT, 0);
+			}
+			else
+			{
+				if (dx > 0)
+					camera_fill(e[i].drawn_x, e[i].drawn_y, dx, ENEMY_HEIGHT, 0);
+				if (dx < 0)
+					camera_fill(e[i].x + ENEMY_WIDTH, e[i].drawn_y, -dx, ENEMY_HEIGHT, 0);
+				if (dy > 0)
+					camera_fill(e[i].drawn_x, e[i].drawn_y, ENEMY_WIDTH, dy, 0);
+				if (dy < 0)
+					camera_fill(e[i].drawn_x, e[i].y + ENEMY_HEIGHT, ENEMY_WIDTH, -dy, 0);
+			}
+		}
+		e[i].drawn_flip = e[i].facing ^ (f->flags & ANIM_HFLIP);
+		camera_put_image(e[i].x, e[i].y, ENEMY_WIDTH, ENEMY_HEIGHT, f->image, e[i].drawn_flip, (f->flags & ANIM_VFLIP) != 0);
+		e[i].drawn_image = f->image;
+		e[i].drawn_x = e[i].x;
+		e[i].drawn_y = e[i].y;
+	}
+}
+void enemies_invalidate(Enemy *e, int count)
+{
+	// Force a full redraw, e.g. after the screen has been cleared
+	for (int i = 0; i < count; i++)
+		e[i].drawn_x = -1;
+}
+void enemy_step(const EnemyWorld *w, Enemy *e, uint16_t knight_x, uint16_t knight_y)
+{
+	int target_x = knight_x;
+	int target_y = knight_y;
+	if (e->chase_range)
+	{
+		// Start chasing once the knight is close and nothing on the grid is in the way.
+		// Keep chasing while he stays close, going round spikes with the flow field
+		// when he is out of sight. The field starts again each time he moves to a new
+		// tile, until it is ready again wait where we are rather than give up.
+		int dx = (int)knight_x - e->x;
+		int dy = (int)knight_y - e->y;
+		int range = e->chase_range;
+		int close = (dx < range && dx > -range && dy < range && dy > -range);
+		int cx = e->x + ENEMY_WIDTH / 2;
+		int cy = e->y + ENEMY_HEIGHT / 2;
+		int fx, fy, way = PATH_NONE;
+		if (close && grid_line_of_sight(&w->grid, cx, cy, knight_x + 6, knight_y + 8))
+		{
+			e->mode = ENEMY_CHASE;
+		}
+		else if (close && e->mode == ENEMY_CHASE && (way = flow_direction(&w->flow, cx / GRID_TILE, cy / GRID_TILE, &fx, &fy)) != PATH_NONE)
+		{
+			target_x = e->x;
+			target_y = e->y;
+			if (way == PATH_FOUND)
+			{
+				// Head for the next tile on the way, centred in it
+				target_x = (cx / GRID_TILE + fx) * GRID_TILE + (GRID_TILE - ENEMY_WIDTH) / 2;
+				target_y = (cy / GRID_TILE + fy) * GRID_TILE + (GRID_TILE - ENEMY_HEIGHT) / 2;
+			}
+		}
+		else
+		{
+			e->mode = ENEMY_PATROL;
+		}
+	}
+	if (e->mode != ENEMY_CHASE)
+	{
+		target_x = e->path[e->target].x;
+		target_y = e->path[e->target].y;
+	}
+	if (target_x > e->x)
+		e->facing = 0;
+	else if (target_x < e->x)
+		e->facing = 1;
+	// Each axis moves independently which gives vertical and diagonal movement for free
+	int moved = step_towards(&e->x, target_x);
+	moved |= step_towards(&e->y, target_y);
+	if (!moved && e->mode == ENEMY_PATROL)
+	{
+		// Reached the waypoint, turn for the next one without losing a tick
+		e->target++;
+		if (e->target >= e->path_len)
+			e->target = 0;
+		target_x = e->path[e->target].x;
+		target_y = e->path[e->target].y;
+		if (target_x > e->x)
+			e->facing = 0;
+		else if (target_x < e->x)
+			e->facing = 1;
+		step_towards(&e->x, target_x);
+		step_towards(&e->y, target_y);
+	}
+}
+int step_towards(int16_t *pos, int target)
+{
+	if (*pos < target)
+	{
+		(*pos)++;
+		return 1;
+	}
+	if (*pos > target)
+	{
+		(*pos)--;
+		return 1;
+	}
+	return 0;
+}
+int inside(const Enemy *e, int px, int py)
+{
+	// Edges included, as isInside in main.c
+	return px >= e->x && px <= e->x + ENEMY_WIDTH && py >= e->y && py <= e->y + ENEMY_HEIGHT;
+}
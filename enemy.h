@@ -0,0 +1,55 @@
+#ifndef ENEMY_H
+#define ENEMY_H
+#include <stdint.h>
+#include "anim.h"
+#include "grid.h"
+#include "path.h"
+#define MAX_ENEMIES 16
+#define ENEMY_WIDTH 12
+#define ENEMY_HEIGHT 16
+
+// Behaviour modes
+#define ENEMY_PATROL 0
+#define ENEMY_CHASE 1
+
+// A point on a patrol route, top left corner of the sprite
+typedef struct
+{
+	uint8_t x, y;
+} Waypoint;
+
+typedef struct
+{
+	int16_t x, y;             // current position
+	int16_t drawn_x, drawn_y; // where the sprite was last drawn, drawn_x < 0 if it needs a full draw
+	const uint16_t *drawn_image; // frame last drawn and which way it was flipped
+	uint8_t drawn_flip;
+	AnimPlayer anim;          // running, or attacking until the attack clip is done
+	const Waypoint *path;     // patrol route, walked in order and then looped
+	uint8_t path_len;
+	uint8_t target;           // index of the waypoint being walked to
+	uint8_t mode;             // ENEMY_PATROL or ENEMY_CHASE
+	uint8_t chase_range;      // chase the knight when he is in sight this close, 0 never
+	uint8_t facing;           // 0 facing right, 1 facing left (hOrientation for putImage)
+} Enemy;
+
+// What a level's enemies share: the grid they see through, the flow field the chasers
+// follow and when they last moved. One per level being played.
+typedef struct
+{
+	Grid grid;
+	FlowField flow;
+	uint32_t last_tick;
+} EnemyWorld;
+
+void enemy_world_init(EnemyWorld *w, uint32_t now);
+void enemy_init(Enemy *e, const Waypoint *path, uint8_t path_len, int difficulty);
+void enemy_set_tick(uint32_t ms);
+void enemy_set_clips(const AnimClip *run, const AnimClip *attack);
+void enemy_attack(Enemy *e, uint32_t now);
+int enemy_dirty(const Enemy *e);
+int enemy_hits(const Enemy *e, uint16_t knight_x, uint16_t knight_y);
+void enemies_update(EnemyWorld *w, Enemy *e, int count, uint16_t knight_x, uint16_t knight_y, uint32_t now);
+void enemies_draw(Enemy *e, int count);
+void enemies_invalidate(Enemy *e, int count);
+#endif
@@ -0,0 +1,110 @@
+#include <stdint.h>
+#include "fastmath.h"
+
+uint32_t divu10(uint32_t n)
+{
+	// n * 0.8 built from shifts and adds, then / 8, comes out at most one low. Multiplying
+	// back gives the remainder, which is 10 to 15 when it is.
+	// Reference : Hacker's Delight, 2nd edition, figure 10-12
+	uint32_t q, r;
+	q = (n >> 1) + (n >> 2);
+	q += q >> 4;
+	q += q >> 8;
+	q += q >> 16;
+	q >>= 3;
+	r = n - q * 10;
+	return q + ((r + 6) >> 4);
+}
+uint32_t divmodu10(uint32_t n, uint32_t *rem)
+{
+	uint32_t q = divu10(n);
+	*rem = n - q * 10;
+	return q;
+}
+int digits10(uint32_t value, char *out)
+{
+	// Writes the decimal digits of value to out, most significant first and without a
+	// NUL, and returns how many there were: 1 to 10
+	char reversed[10];
+	int n = 0;
+	int len = 0;
+	do
+	{
+		uint32_t digit;
+		value = divmodu10(value, &digit);
+		reversed[n++] = (char)('0' + digit);
+	} while (value);
+	while (n)
+		out[len++] = reversed[--n];
+	return len;
+}
+
+#ifdef PROFILE
+#include <stm32f031x6.h>
+#include "serial.h"
+
+#define BENCH_CALLS 1000
+
+static volatile uint32_t bench_sink;
+static volatile uint32_t bench_ten = 10; // read at run time so the library has to divide
+
+static void bench_report(const char *what, uint32_t cycles, uint32_t empty);
+
+void fastmath_bench()
+{
+	// Cycles per call, averaged over BENCH_CALLS calls with the loop's own cost taken
+	// off. TIM2 counts cycles once profile_init has run.
+	uint32_t start, empty, cycles;
+	char out[10];
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = i * 4294967u;
+	empty = TIM2->CNT - start;
+	eputs("fastmath: cycles per call\r\n");
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = (i * 4294967u) / bench_ten;
+	cycles = TIM2->CNT - start;
+	bench_report("n / 10 ", cycles, empty);
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = divu10(i * 4294967u);
+	cycles = TIM2->CNT - start;
+	bench_report("divu10(n) ", cycles, empty);
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+	{
+		// Ten digits the usual way, a divide and a remainder each
+		uint32_t value = i * 4294967u;
+		for (int d = 0; d < 10; d++)
+		{
+			out[d] = (char)('0' + value % bench_ten);
+			value /= bench_ten;
+		}
+		bench_sink = out[0];
+	}
+	cycles = TIM2->CNT - start;
+	bench_report("10 digits with / and % ", cycles, empty);
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = digits10(i * 4294967u, out);
+	cycles = TIM2->CNT - start;
+	bench_report("digits10(n) ", cycles, empty);
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = (i & 0xff) / (bench_ten + 3);
+	cycles = TIM2->CNT - start;
+	bench_report("n / 13 ", cycles, empty);
+	start = TIM2->CNT;
+	for (uint32_t i = 0; i < BENCH_CALLS; i++)
+		bench_sink = DIVU8(i & 0xff, 13);
+	cycles = TIM2->CNT - start;
+	bench_report("DIVU8(n, 13) ", cycles, empty);
+}
+static void bench_report(const char *what, uint32_t cycles, uint32_t empty)
+{
+	eputs((char *)what);
+	printDecimal((int32_t)((cycles > empty) ? (cycles - empty) / BENCH_CALLS : 0));
+	eputs("\r\n");
+}
+#endif
@@ -0,0 +1,23 @@
+#include <stdint.h>
+#include "profile.h"
+// Division by constants without the library's divide routine, which the M0 has to run
+// in software for want of a divide instruction (tools/fastmath_test.c checks these
+// against the real thing over their whole input ranges).
+
+// n / d and n % d for n from 0 to 255 and a constant d from 1 to 256: multiply by
+// ceil(65536 / d), which is folded at compile time, and shift. The reciprocal is out by
+// less than d / 65536 so the product is never out by a whole step below 256 * 256.
+#define DIVU8(n, d) (((uint32_t)(n) * ((65536u + (d) - 1) / (d))) >> 16)
+#define MODU8(n, d) ((uint32_t)(n) - DIVU8(n, d) * (d))
+
+uint32_t divu10(uint32_t n);
+uint32_t divmodu10(uint32_t n, uint32_t *rem);
+int digits10(uint32_t value, char *out);
+
+// With PROFILE defined, fastmath_bench times these against the library over serial
+#ifdef PROFILE
+void fastmath_bench(void);
+#define FASTMATH_BENCH() fastmath_bench()
+#else
+#define FASTMATH_BENCH() ((void)0)
+#endif
@@ -0,0 +1,75 @@
+#include <stdint.h>
+#include "format.h"
+#include "fastmath.h"
+
+// The M0 has no divide instruction, so decimal digits come from divu10's shifts and
+// adds instead of the library's division routine.
+
+int fmt_uint_pad(char *out, uint32_t value, int width, char pad)
+{
+	// Right aligns value in at least width characters, filling on the left with pad
+	char digits[10];
+	int len = digits10(value, digits);
+	int n = 0;
+	while (width-- > len)
+		out[n++] = pad;
+	for (int i = 0; i < len; i++)
+		out[n++] = digits[i];
+	out[n] = 0;
+	return n;
+}
+int fmt_uint(char *out, uint32_t value)
+{
+	return fmt_uint_pad(out, value, 0, ' ');
+}
+int fmt_int(char *out, int32_t value)
+{
+	if (value < 0)
+	{
+		out[0] = '-';
+		// Negate as unsigned so INT32_MIN comes out right
+		return 1 + fmt_uint(out + 1, 0u - (uint32_t)value);
+	}
+	return fmt_uint(out, (uint32_t)value);
+}
+int fmt_hex(char *out, uint32_t value, int digits)
+{
+	// Upper case hex, zero padded to digits characters (0 for as few as needed)
+	int n = 0;
+	int started = 0;
+	for (int shift = 28; shift >= 0; shift -= 4)
+	{
+		uint32_t nibble = (value >> shift) & 0x0f;
+		if (nibble || started || shift == 0 || (shift >> 2) < digits)
+		{
+			out[n++] = (char)((nibble < 10) ? ('0' + nibble) : ('A' + nibble - 10));
+			started = 1;
+		}
+	}
+	out[n] = 0;
+	return n;
+}
+int fmt_fixed(char *out, int32_t value, int frac_bits, int decimals)
+{
+	// Signed fixed point with frac_bits fractional bits (up to 27, e.g. 16 for the Q16.16
+	// motion values), truncated to the given number of decimal places
+	uint32_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+	uint32_t mask = (1u << frac_bits) - 1;
+	uint32_t frac = magnitude & mask;
+	int n = 0;
+	if (value < 0)
+		out[n++] = '-';
+	n += fmt_uint(out + n, magnitude >> frac_bits);
+	if (decimals > 0)
+	{
+		out[n++] = '.';
+		while (decimals--)
+		{
+			frac *= 10;
+			out[n++] = (char)('0' + (frac >> frac_bits));
+			frac &= mask;
+		}
+	}
+	out[n] = 0;
+	return n;
+}
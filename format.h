@@ -0,0 +1,9 @@
+#include <stdint.h>
+// Allocation free number formatting. Every function writes a NUL terminated string to
+// out and returns its length. out must have room for the result: 12 bytes covers any
+// 32 bit decimal with its sign.
+int fmt_uint(char *out, uint32_t value);
+int fmt_int(char *out, int32_t value);
+int fmt_uint_pad(char *out, uint32_t value, int width, char pad);
+int fmt_hex(char *out, uint32_t value, int digits);
+int fmt_fixed(char *out, int32_t value, int frac_bits, int decimals);
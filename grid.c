@@ -0,0 +1,73 @@
+#include <stdint.h>
+#include "grid.h"
+
+void grid_clear(Grid *g)
+{
+	for (int i = 0; i < GRID_ROWS; i++)
+		g->row[i] = 0;
+	g->version++; // costs worked out for the old layout no longer hold
+}
+void grid_block(Grid *g, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	// Mark every tile touched by the pixel rectangle x,y,w,h as blocked
+	int tx0 = x / GRID_TILE;
+	int ty0 = y / GRID_TILE;
+	int tx1 = (x + w - 1) / GRID_TILE;
+	int ty1 = (y + h - 1) / GRID_TILE;
+	if (tx1 >= GRID_COLS)
+		tx1 = GRID_COLS - 1;
+	if (ty1 >= GRID_ROWS)
+		ty1 = GRID_ROWS - 1;
+	for (int ty = ty0; ty <= ty1; ty++)
+		for (int tx = tx0; tx <= tx1; tx++)
+			g->row[ty] |= (uint8_t)(1 << tx);
+	g->version++;
+}
+int grid_blocked(const Grid *g, int tx, int ty)
+{
+	if (tx < 0 || ty < 0 || tx >= GRID_COLS || ty >= GRID_ROWS)
+		return 1;
+	return (g->row[ty] >> tx) & 1;
+}
+int grid_line_of_sight(const Grid *g, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+	// Walk the tiles between two pixel positions and report 1 if none are blocked.
+	// Reference : https://en.wikipedia.org/wiki/Bresenham%27s_line_algorithm
+	int tx = x0 / GRID_TILE;
+	int ty = y0 / GRID_TILE;
+	int tx1 = x1 / GRID_TILE;
+	int ty1 = y1 / GRID_TILE;
+	int dx = tx1 - tx;
+	int dy = ty1 - ty;
+	int sx = 1;
+	int sy = 1;
+	if (dx < 0)
+	{
+		dx = -dx;
+		sx = -1;
+	}
+	if (dy < 0)
+	{
+		dy = -dy;
+		sy = -1;
+	}
+	int err = dx - dy;
+	while (1)
+	{
+		if (grid_blocked(g, tx, ty))
+			return 0;
+		if (tx == tx1 && ty == ty1)
+			return 1;
+		int e2 = 2 * err;
+		if (e2 > -dy)
+		{
+			err -= dy;
+			tx += sx;
+		}
+		if (e2 < dx)
+		{
+			err += dx;
+			ty += sy;
+		}
+	}
+}
@@ -0,0 +1,21 @@
+#ifndef GRID_H
+#define GRID_H
+#include <stdint.h>
+// Coarse tile grid over the 128x160 screen used for enemy visibility and pathing
+#define GRID_TILE 16
+#define GRID_COLS 8
+#define GRID_ROWS 10
+
+// One level's grid. The caller owns it, so several can be in use at once (the balance
+// simulator keeps one per thread).
+typedef struct
+{
+	uint8_t row[GRID_ROWS]; // bit n set means column n is blocked
+	uint8_t version;        // changes whenever a tile does, see flow_target
+} Grid;
+
+void grid_clear(Grid *g);
+void grid_block(Grid *g, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+int grid_blocked(const Grid *g, int tx, int ty);
+int grid_line_of_sight(const Grid *g, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+#endif
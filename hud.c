@@ -0,0 +1,79 @@
+#include <stdint.h>
+#include "display.h"
+#include "hud.h"
+#include "format.h"
+
+#define CELL_WIDTH 7  // printText advances 5 pixels of font plus 2 of gap per character
+#define CELL_HEIGHT 7
+#define ICON_WIDTH 12
+#define ICON_HEIGHT 16
+
+void hud_counter_init(HudCounter *c, uint16_t x, uint16_t y, uint8_t digits)
+{
+	c->x = x;
+	c->y = y;
+	c->digits = (digits > HUD_MAX_DIGITS) ? HUD_MAX_DIGITS : digits;
+	c->valid = 0;
+}
+void hud_counter_set(HudCounter *c, uint32_t value, uint16_t colour)
+{
+	char text[HUD_MAX_DIGITS + 1];
+	char cell[2] = {0, 0};
+	int len = fmt_uint(text, value);
+	if (len > c->digits)
+		len = c->digits;
+	if (colour != c->colour)
+		c->valid = 0;
+	for (int i = 0; i < c->digits; i++)
+	{
+		char ch = (i < len) ? text[i] : ' ';
+		uint16_t x = c->x + i * CELL_WIDTH;
+		if (c->valid && c->shown[i] == ch)
+			continue;
+		if (ch == ' ')
+		{
+			fillRectangle(x, c->y, CELL_WIDTH, CELL_HEIGHT, 0);
+		}
+		else
+		{
+			cell[0] = ch;
+			printText(cell, x, c->y, colour, 0);
+		}
+		c->shown[i] = ch;
+	}
+	c->colour = colour;
+	c->valid = 1;
+}
+void hud_icons_init(HudIcons *b, uint16_t x, uint16_t y, uint16_t spacing, uint8_t slots, const uint16_t *image, const uint16_t *used_image)
+{
+	b->x = x;
+	b->y = y;
+	b->spacing = spacing;
+	b->slots = slots;
+	b->image = image;
+	b->used_image = used_image;
+	b->used = 0;
+	b->valid = 0;
+}
+void hud_icons_set(HudIcons *b, int used)
+{
+	int from = 0, to = b->slots;
+	if (used > b->slots)
+		used = b->slots;
+	if (used < 0)
+		used = 0;
+	if (b->valid)
+	{
+		// Only the slots between the old and new count change picture
+		if (used == b->used)
+			return;
+		from = (used < b->used) ? used : b->used;
+		to = (used < b->used) ? b->used : used;
+	}
+	for (int i = from; i < to; i++)
+	{
+		putImage(b->x + i * b->spacing, b->y, ICON_WIDTH, ICON_HEIGHT, (i < used) ? b->used_image : b->image, 0, 0);
+	}
+	b->used = (uint8_t)used;
+	b->valid = 1;
+}
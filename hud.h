@@ -0,0 +1,34 @@
+#ifndef HUD_H
+#define HUD_H
+#include <stdint.h>
+
+#define HUD_MAX_DIGITS 10 // enough for any uint32_t
+
+// A number drawn with the 5x7 font. The characters on screen are remembered so a new
+// value only redraws the digits that changed.
+typedef struct
+{
+	uint16_t x, y;
+	uint8_t digits;               // widest value shown
+	uint8_t valid;                // 0 until drawn, forces a full redraw
+	uint16_t colour;
+	char shown[HUD_MAX_DIGITS];   // characters on screen, ' ' for an empty cell
+} HudCounter;
+
+// A row of icons, e.g. hearts or key slots. The first 'used' slots show used_image and
+// the rest show image, only slots whose picture changes are redrawn.
+typedef struct
+{
+	uint16_t x, y, spacing;
+	uint8_t slots;
+	uint8_t used;
+	uint8_t valid;
+	const uint16_t *image;
+	const uint16_t *used_image;
+} HudIcons;
+
+void hud_counter_init(HudCounter *c, uint16_t x, uint16_t y, uint8_t digits);
+void hud_counter_set(HudCounter *c, uint32_t value, uint16_t colour);
+void hud_icons_init(HudIcons *b, uint16_t x, uint16_t y, uint16_t spacing, uint8_t slots, const uint16_t *image, const uint16_t *used_image);
+void hud_icons_set(HudIcons *b, int used);
+#endif
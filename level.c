@@ -0,0 +1,35 @@
+#include <stdint.h>
+#include "level.h"
+
+// Fixed layouts for the three levels. Nightmare swaps these for generated ones with the same counts.
+const LevelLayout level_layouts[LEVEL_COUNT] =
+{
+	{ // Level 1
+		1, 1, 0,
+		{{53, 125}, {100, 80}},
+		{115, 90},
+		{{10, 35}},
+		{{10, 60}},
+		{{{0, 0}}},
+		{0}
+	},
+	{ // Level 2, one skeleton starting in the middle and walking back and forth
+		2, 2, 1,
+		{{5, 125}, {80, 120}},
+		{115, 130},
+		{{10, 35}, {100, 35}},
+		{{10, 55}, {90, 37}},
+		{{{75, 65}, {115, 65}, {30, 65}}},
+		{3}
+	},
+	{ // Level 3, two skeletons in a level four screens big with the door in the far corner
+		3, 3, 2,
+		{{110, 40}, {115, 40}},
+		{230, 225},
+		{{5, 140}, {230, 40}, {20, 225}},
+		{{25, 140}, {170, 60}, {120, 185}},
+		{{{75, 100}, {230, 100}, {10, 100}}, {{75, 150}, {230, 150}, {40, 150}}},
+		{3, 3},
+		256, 256
+	}
+};
@@ -0,0 +1,34 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+#include <stdint.h>
+#include "enemy.h"
+
+#define LEVEL_COUNT 3
+#define LEVEL_MAX_KEYS 3
+#define LEVEL_MAX_SPIKES 6
+#define LEVEL_MAX_ENEMIES 4
+#define LEVEL_MAX_WAYPOINTS 3
+#define LEVEL_SPAWNS 2
+#define LEVEL_MAX_WIDTH 256  // positions are kept in a byte
+#define LEVEL_MAX_HEIGHT 256
+
+// Everything that makes one level different from another. Positions are the top left
+// corner of the 12x16 sprite, in level pixels. A level bigger than the screen scrolls.
+// Tiles for enemy pathing only cover the first screen, so levels that let skeletons
+// chase are kept to one screen.
+typedef struct
+{
+	uint8_t num_keys;
+	uint8_t num_spikes;
+	uint8_t num_enemies;
+	Waypoint spawn[LEVEL_SPAWNS]; // places the knight starts and respawns
+	Waypoint door;
+	Waypoint keys[LEVEL_MAX_KEYS];
+	Waypoint spikes[LEVEL_MAX_SPIKES];
+	Waypoint patrol[LEVEL_MAX_ENEMIES][LEVEL_MAX_WAYPOINTS];
+	uint8_t patrol_len[LEVEL_MAX_ENEMIES];
+	uint16_t width, height; // size of the level, 0 for a single screen
+} LevelLayout;
+
+extern const LevelLayout level_layouts[LEVEL_COUNT];
+#endif
@@ -0,0 +1,267 @@
+#include <stdint.h>
+#include "rng.h"
+#include "level.h"
+#include "levelgen.h"
+#include "fastmath.h"
+
+// Objects are placed on 16px tiles, keeping to the part of the screen the knight can reach
+#define TILE 16
+#define FIRST_COL 1
+#define FIRST_ROW 2
+#define COLS 6
+#define ROWS 7
+#define MAX_ATTEMPTS 16
+#define SPRITE_W 12
+#define SPRITE_H 16
+
+// Reachability is checked by flood filling every knight position on an 8px grid.
+// Sprites are at least 12x16 and a step is 8px, so the positions at either end of
+// a step cover everything the knight touched on the way.
+#define STEP 8
+#define KNIGHT_MIN_X 10
+#define KNIGHT_MAX_X 110
+#define KNIGHT_MIN_Y 32
+#define KNIGHT_MAX_Y 140
+#define LATTICE_W (((KNIGHT_MAX_X - KNIGHT_MIN_X) / STEP) + 1)
+#define LATTICE_H (((KNIGHT_MAX_Y - KNIGHT_MIN_Y) / STEP) + 1)
+#define VISITED 1
+#define BLOCKED 2
+
+static int place(uint8_t occupied[ROWS][COLS], int col, int row, Waypoint *w);
+static int random_tile(uint8_t occupied[ROWS][COLS], Waypoint *w, int away_col, int away_row);
+static void nearest(const Waypoint *w, int *i, int *j);
+static int overlaps(int ax, int ay, int bx, int by);
+static int touches_any(int x, int y, const Waypoint *list, int count);
+
+int levelgen_generate(uint32_t seed, int keys, int spikes, int enemies, LevelLayout *out)
+{
+	// Fill out with a layout for seed. The same seed always gives the same layout.
+	// Returns the number of attempts it took (at least 1), LEVELGEN_ATTEMPTS + 1 if
+	// none worked and out is the fallback room. The caller's random sequence is left
+	// as it was.
+	uint32_t saved = rng_save();
+	int attempt;
+	if (keys > LEVEL_MAX_KEYS)
+		keys = LEVEL_MAX_KEYS;
+	if (spikes > LEVEL_MAX_SPIKES)
+		spikes = LEVEL_MAX_SPIKES;
+	if (enemies > LEVEL_MAX_ENEMIES)
+		enemies = LEVEL_MAX_ENEMIES;
+	rng_seed(seed);
+	for (attempt = 1; attempt <= LEVELGEN_ATTEMPTS; attempt++)
+	{
+		uint8_t occupied[ROWS][COLS] = {{0}};
+		int ok = 1;
+		// Give up on spikes if nothing solvable turns up, an open room always is
+		if (attempt > MAX_ATTEMPTS)
+			spikes = 0;
+		out->num_keys = (uint8_t)keys;
+		out->num_spikes = (uint8_t)spikes;
+		out->num_enemies = (uint8_t)enemies;
+		out->width = out->height = 0; // always a single screen
+		ok &= random_tile(occupied, &out->spawn[0], -1, -1);
+		ok &= random_tile(occupied, &out->spawn[1], -1, -1);
+		// Keep the door a fair walk from where the knight starts
+		ok &= random_tile(occupied, &out->door, (out->spawn[0].x - 2) / TILE, out->spawn[0].y / TILE);
+		for (int i = 0; i < keys; i++)
+			ok &= random_tile(occupied, &out->keys[i], -1, -1);
+		for (int i = 0; i < spikes; i++)
+		{
+			// Spikes may not touch a spawn point
+			Waypoint w;
+			int tries = 0;
+			do
+			{
+				w.x = (uint8_t)((FIRST_COL + rng_below(COLS)) * TILE + 2);
+				w.y = (uint8_t)((FIRST_ROW + rng_below(ROWS)) * TILE);
+			} while ((occupied[w.y / TILE - FIRST_ROW][(w.x - 2) / TILE - FIRST_COL] ||
+			          touches_any(w.x, w.y, out->spawn, LEVEL_SPAWNS)) && ++tries < 64);
+			ok &= place(occupied, (w.x - 2) / TILE, w.y / TILE, &out->spikes[i]);
+		}
+		for (int i = 0; i < enemies; i++)
+		{
+			// Skeletons walk a stretch of a row clear of spikes and spawn points
+			int row, a, b, clear = 0;
+			for (int tries = 0; tries < 16 && !clear; tries++)
+			{
+				row = FIRST_ROW + (int)rng_below(ROWS);
+				a = FIRST_COL + (int)rng_below(COLS - 2);
+				b = a + 2 + (int)rng_below(COLS - (a - FIRST_COL) - 2);
+				clear = 1;
+				for (int c = a; c <= b; c++)
+				{
+					int x = c * TILE + 2;
+					int y = row * TILE;
+					if (touches_any(x, y, out->spikes, spikes) || touches_any(x, y, out->spawn, LEVEL_SPAWNS))
+						clear = 0;
+				}
+			}
+			ok &= clear;
+			out->patrol[i][0].x = (uint8_t)(a * TILE + 2);
+			out->patrol[i][0].y = (uint8_t)(row * TILE);
+			out->patrol[i][1].x = (uint8_t)(b * TILE + 2);
+			out->patrol[i][1].y = (uint8_t)(row * TILE);
+			out->patrol_len[i] = 2;
+		}
+		if (ok && levelgen_validate(out))
+			break;
+	}
+	// Skeletons can still fail to find a clear row every time, so after a hard limit
+	// settle for a room that is known to work
+	if (attempt > LEVELGEN_ATTEMPTS)
+		levelgen_fallback(keys, out);
+	rng_restore(saved);
+	return attempt;
+}
+void levelgen_fallback(int keys, LevelLayout *out)
+{
+	// An open room with no spikes or skeletons: spawns in opposite corners, the door
+	// in a third and the keys between them
+	static const Waypoint key_tiles[LEVEL_MAX_KEYS] = {{1, 8}, {3, 5}, {4, 3}};
+	if (keys > LEVEL_MAX_KEYS)
+		keys = LEVEL_MAX_KEYS;
+	out->num_keys = (uint8_t)keys;
+	out->num_spikes = 0;
+	out->num_enemies = 0;
+	out->width = out->height = 0;
+	out->spawn[0].x = FIRST_COL * TILE + 2;
+	out->spawn[0].y = FIRST_ROW * TILE;
+	out->spawn[1].x = (FIRST_COL + COLS - 1) * TILE + 2;
+	out->spawn[1].y = (FIRST_ROW + ROWS - 1) * TILE;
+	out->door.x = (FIRST_COL + COLS - 1) * TILE + 2;
+	out->door.y = FIRST_ROW * TILE;
+	for (int i = 0; i < keys; i++)
+	{
+		out->keys[i].x = (uint8_t)(key_tiles[i].x * TILE + 2);
+		out->keys[i].y = (uint8_t)(key_tiles[i].y * TILE);
+	}
+}
+int levelgen_validate(const LevelLayout *layout)
+{
+	// Flood fill from the first spawn point avoiding spikes. Every key, the door and
+	// the second spawn point must be reachable. The lattice is static to keep its
+	// 364 bytes off the stack, nothing calls this from an interrupt.
+	static uint8_t cell[LATTICE_W * LATTICE_H];
+	static uint8_t queue[LATTICE_W * LATTICE_H];
+	int head = 0, tail = 0;
+	int keys_found = 0;
+	int door_found = 0;
+	uint8_t key_found[LEVEL_MAX_KEYS] = {0};
+	int spawn_found = 0;
+	int sx, sy, tx, ty;
+	for (int i = 0; i < LEVEL_SPAWNS; i++)
+		if (touches_any(layout->spawn[i].x, layout->spawn[i].y, layout->spikes, layout->num_spikes))
+			return 0;
+	for (int j = 0; j < LATTICE_H; j++)
+	{
+		for (int i = 0; i < LATTICE_W; i++)
+		{
+			int x = KNIGHT_MIN_X + i * STEP;
+			int y = KNIGHT_MIN_Y + j * STEP;
+			cell[j * LATTICE_W + i] = touches_any(x, y, layout->spikes, layout->num_spikes) ? BLOCKED : 0;
+		}
+	}
+	// Start from the lattice point nearest the spawn
+	nearest(&layout->spawn[0], &sx, &sy);
+	nearest(&layout->spawn[1], &tx, &ty);
+	if (cell[sy * LATTICE_W + sx] & BLOCKED)
+		return 0;
+	cell[sy * LATTICE_W + sx] |= VISITED;
+	queue[tail++] = (uint8_t)(sy * LATTICE_W + sx);
+	while (head < tail)
+	{
+		int c = queue[head++];
+		int i = MODU8(c, LATTICE_W); // c is a byte, see queue
+		int j = DIVU8(c, LATTICE_W);
+		int x = KNIGHT_MIN_X + i * STEP;
+		int y = KNIGHT_MIN_Y + j * STEP;
+		for (int k = 0; k < layout->num_keys; k++)
+		{
+			if (!key_found[k] && overlaps(x, y, layout->keys[k].x, layout->keys[k].y))
+			{
+				key_found[k] = 1;
+				keys_found++;
+			}
+		}
+		if (overlaps(x, y, layout->door.x, layout->door.y))
+			door_found = 1;
+		if (i == tx && j == ty)
+			spawn_found = 1;
+		if (door_found && spawn_found && keys_found == layout->num_keys)
+			return 1;
+		if (i > 0 && !cell[c - 1])
+		{
+			cell[c - 1] = VISITED;
+			queue[tail++] = (uint8_t)(c - 1);
+		}
+		if (i < LATTICE_W - 1 && !cell[c + 1])
+		{
+			cell[c + 1] = VISITED;
+			queue[tail++] = (uint8_t)(c + 1);
+		}
+		if (j > 0 && !cell[c - LATTICE_W])
+		{
+			cell[c - LATTICE_W] = VISITED;
+			queue[tail++] = (uint8_t)(c - LATTICE_W);
+		}
+		if (j < LATTICE_H - 1 && !cell[c + LATTICE_W])
+		{
+			cell[c + LATTICE_W] = VISITED;
+			queue[tail++] = (uint8_t)(c + LATTICE_W);
+		}
+	}
+	return 0;
+}
+int place(uint8_t occupied[ROWS][COLS], int col, int row, Waypoint *w)
+{
+	if (occupied[row - FIRST_ROW][col - FIRST_COL])
+		return 0;
+	occupied[row - FIRST_ROW][col - FIRST_COL] = 1;
+	w->x = (uint8_t)(col * TILE + 2);
+	w->y = (uint8_t)(row * TILE);
+	return 1;
+}
+int random_tile(uint8_t occupied[ROWS][COLS], Waypoint *w, int away_col, int away_row)
+{
+	// Pick a free tile, at least 4 tiles (by rows plus columns) from away_col,away_row if given
+	for (int tries = 0; tries < 64; tries++)
+	{
+		int col = FIRST_COL + (int)rng_below(COLS);
+		int row = FIRST_ROW + (int)rng_below(ROWS);
+		if (away_col >= 0)
+		{
+			int d = (col > away_col ? col - away_col : away_col - col) + (row > away_row ? row - away_row : away_row - row);
+			if (d < 4)
+				continue;
+		}
+		if (place(occupied, col, row, w))
+			return 1;
+	}
+	return 0;
+}
+void nearest(const Waypoint *w, int *i, int *j)
+{
+	// Lattice point closest to w
+	*i = (w->x - KNIGHT_MIN_X + STEP / 2) / STEP;
+	*j = (w->y - KNIGHT_MIN_Y + STEP / 2) / STEP;
+	if (*i < 0)
+		*i = 0;
+	if (*j < 0)
+		*j = 0;
+	if (*i >= LATTICE_W)
+		*i = LATTICE_W - 1;
+	if (*j >= LATTICE_H)
+		*j = LATTICE_H - 1;
+}
+int overlaps(int ax, int ay, int bx, int by)
+{
+	// Same test as isInside on the corners, edges touching count
+	return (ax <= bx + SPRITE_W) && (bx <= ax + SPRITE_W) && (ay <= by + SPRITE_H) && (by <= ay + SPRITE_H);
+}
+int touches_any(int x, int y, const Waypoint *list, int count)
+{
+	for (int i = 0; i < count; i++)
+		if (overlaps(x, y, list[i].x, list[i].y))
+			return 1;
+	return 0;
+}
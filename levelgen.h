@@ -0,0 +1,12 @@
+#include <stdint.h>
+#include "level.h"
+
+// Attempts levelgen_generate makes before it gives up on random layouts and returns
+// levelgen_fallback's, which bounds how long a level can take to generate
+#ifndef LEVELGEN_ATTEMPTS
+#define LEVELGEN_ATTEMPTS 32
+#endif
+
+int levelgen_generate(uint32_t seed, int keys, int spikes, int enemies, LevelLayout *out);
+int levelgen_validate(const LevelLayout *layout);
+void levelgen_fallback(int keys, LevelLayout *out);
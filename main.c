@@ -19,9 +19,32 @@
 #include <stm32f031x6.h> // Include the STM32F0xx Standard Peripheral Library
 #include "display.h" // Include the display header for screen operations
 #include "sound.h" // Include the sound header for audio functionalities
-#include "musical_notes.h" // Include definitions for musical notes
+#include "note_periods.h" // Include the timer periods for musical notes, generated by tools/gen_tables.c
+#include "palette.h" // Include the game's colours ready packed for the panel, generated by tools/gen_tables.c
 #include "prbs.h" // Include the pseudo-random binary sequence header
+#include "rng.h" // Include the xorshift generator behind it, for random ranges
 #include "serial.h" // Include the serial communication header for data transmission and logging functionalities
+#include "power.h" // Include the power management header for sleeping while waiting on buttons
+#include "motion.h" // Include the fixed-point movement model for the knight
+#include "grid.h" // Include the coarse level grid used for enemy line of sight
+#include "enemy.h" // Include the enemy behaviour module (patrols and chasing)
+#include "path.h" // Include the grid pathfinder used by chasing enemies
+#include "level.h" // Include the level layout description
+#include "levelgen.h" // Include the procedural level generator used in Nightmare
+#include "profile.h" // Include the per-zone cycle profiler (compiled out unless PROFILE is defined)
+#include "sampler.h" // Include the statistical PC sampler (compiled out unless SAMPLER is defined)
+#include "hud.h" // Include the HUD widgets that only redraw what changed
+#include "format.h" // Include the number formatting used in place of sprintf
+#include "fastmath.h" // Include division by constants without the library's divide routine
+#include "scene.h" // Include the scene state machine that runs the screens
+#include "transition.h" // Include the screen transitions spread over several frames
+#include "camera.h" // Include the camera that scrolls levels bigger than the screen
+#include "anim.h" // Include the animation clips and playheads
+#include "sprites.h" // Include the sprite atlas and its metadata table
+#include "boot.h" // Include the boot manager: reset cause, warm boot state and start up milestones
+#include "watchdog.h" // Include the IWDG supervisor and the crash record it leaves for the next boot
+#include "timebase.h" // Include the microsecond clock and the software timers run from SysTick
+#include "stack.h" // Include the painted stack that records how deep the stack has been
 
 
 // Preprocessor directives defining musical notes for different game levels
@@ -36,45 +59,24 @@
 #define DIFFICULTY_AMOUNT 4
 #define BADGES_AMOUNT 4
 
-// Define the number of keys and random locations for player in level 1
-#define NUM_OF_KEYS_1_DISPLAYED 1
-#define NUMOF_KEYS_1 1
-#define NUM_OF_RANDOM_LOCATIONS 2
-
-// Define the number of keys, spikes, and random locations for player in level 2
-#define NUM_OF_KEYS_2_DISPLAYED 2
-#define NUMOF_KEYS_2 2
-#define NUMOF_SPIKES_2 2
-
-// Define the number of keys, spikes, enemies, and random locations for player in level 3
-#define NUM_OF_KEYS_3_DISPLAYED 3
-#define NUMOF_KEYS_3 3
-#define NUMOF_SPIKES_3 3
-#define NUM_OF_ENEMY_3 2
-
-void RightButtonPressed(uint16_t* x,int* hmoved, int* hinverted);
-void LeftButtonPressed(uint16_t* x,int* hmoved, int* hinverted);
-void UpButtonPressed(uint16_t* y,int* vmoved, int* vinverted);
-void DownButtonPressed(uint16_t* y,int* vmoved, int* vinverted);
+// Every scene gets one update and render per frame
+#define FRAME_MS 30
+
+// Buttons, active low with pull-ups
+#define BUTTON_RIGHT (1 << 0) // PB4
+#define BUTTON_LEFT  (1 << 1) // PB5
+#define BUTTON_UP    (1 << 2) // PA11, also the 'down' arrow on the menus
+#define BUTTON_DOWN  (1 << 3) // PA8
+
 void initClock(void);
-void initSysTick(void);
-void SysTick_Handler(void);
 void delay(volatile uint32_t dly);
 void setupIO();
 int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, uint16_t px, uint16_t py);
 void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber);
 void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode);
-void intro(void);
-void main_menu(void);
-void gameover(int *start_game, int *current_difficulty_choice,int *difficulty);
-int Level1_Start(uint16_t x,uint16_t y,uint16_t oldx,uint16_t oldy,uint16_t* px,uint16_t* py,int hearts_used,int difficulty);
-int Level2_Start(uint16_t x,uint16_t y,uint16_t oldx,uint16_t oldy,uint16_t* px,uint16_t* py,int hearts_used,int difficulty);
-int Level3_Start(uint16_t x,uint16_t y,uint16_t oldx,uint16_t oldy,uint16_t* px,uint16_t* py,int hearts_used,int difficulty);
-void play_music(int [],int);
-void Difficulty_choice(int* difficulty,int choice,int *hearts_used);
+void game_init(void);
+void game_frame(uint32_t now);
 void Difficulty_Display(int difficulty);
-void Difficulty_Nightmare(int* difficulty,int choice,int *hearts_used);
-void gameend(int *start_game, int *current_difficulty_choice,int *difficulty);
 
 // Red LED that tells you, that you are not in a level and the game is running. 
 void RedOn(void);
@@ -85,520 +87,84 @@ void GreenOn();
 void GreenOff();
 // Serial Communication
 void serial_log(char log[]);
-volatile uint32_t milliseconds;  // Global variable to store milliseconds for timing
-volatile uint32_t milliseconds_timer;  // Timer variable for specific timing tasks
-uint32_t max_time = 60000;  // Maximum time limit in milliseconds (1 minute)
-int timer = 60;  // Timer variable for Nightmare Mode, set to 60 seconds
-
-// knight_animation1: Array to store the first animation frame of the knight sprite
-const uint16_t knight_animation1[] =
-{
-	0,0,0,0,34617,34617,34617,34617,34617,0,0,
-	0,0,0,0,34617,43866,4492,4492,54437,54437,
-	34617,0,0,0,0,0,34617,43866,4492,34617,34617,
-	34617,34617,0,0,0,0,0,34617,43866,4492,4492,34617,
-	54437,34617,0,0,0,0,0,34617,43866,4492,4492,34617,54437,
-	34617,0,0,0,34617,34617,34617,34617,34617,34617,34617,34617,
-	34617,34617,0,34617,65288,65288,65288,65288,65288,65288,4492,
-	34617,54437,54437,34617,34617,65288,65288,65288,65288,65288,
-	65288,4492,4492,34617,54437,34617,34617,65288,65288,16135,16135,
-	65288,65288,4492,4492,34617,54437,34617,34617,65288,65288,16135,
-	16135,65288,65288,4492,4492,34617,54437,34617,34617,65288,65288,
-	65288,65288,65288,65288,4492,4492,34617,34617,34617,0,34617,65288,
-	65288,65288,65288,34617,43866,4492,4492,34617,0,0,0,34617,65288,65288,
-	34617,34617,34617,4492,4492,34617,0,0,0,0,34617,34617,34617,0,0,34617,
-	4492,34617,0,0,0,0,34617,43866,34617,0,0,34617,4492,34617,0,0,0,0,34617,
-	43866,0,0,0,0,4492,34617,0,
-};
-
-// knight_animation2: Array to store the second animation frame of the knight sprite
-const uint16_t	knight_animation2[] = 
-{
-	0,0,0,0,34617,34617,34617,
-	34617,34617,0,0,0,0,0,0,34617,
-	43866,4492,4492,54437,54437,34617,
-	0,0,0,0,0,34617,43866,4492,34617,34617,
-	34617,34617,0,0,0,0,0,34617,43866,4492,
-	4492,34617,54437,34617,0,0,0,0,0,34617,43866,
-	4492,4492,34617,54437,34617,0,0,0,0,34617,34617,
-	34617,34617,34617,34617,34617,34617,34617,0,0,34617,
-	65288,65288,65288,65288,65288,65288,34617,54437,54437,
-	34617,0,34617,65288,65288,65288,65288,65288,65288,4492,
-	34617,54437,34617,0,34617,65288,65288,16135,16135,65288,
-	65288,4492,34617,54437,54437,0,34617,65288,65288,16135,16135,
-	65288,65288,4492,34617,34617,34617,0,34617,65288,65288,65288,
-	65288,65288,65288,4492,34617,0,0,0,0,34617,65288,65288,65288,
-	65288,34617,4492,4492,34617,0,0,0,0,34617,65288,65288,34617,
-	43866,4492,4492,34617,0,0,0,0,34617,34617,34617,0,0,0,34617,
-	4492,34617,0,0,0,34617,43866,34617,0,0,0,34617,4492,34617,0,
-	0,34617,43866,34617,0,0,0,0,0,0,0,
-};
-
-// knight_animation3: Array to store the third animation frame of the knight sprite
-const uint16_t knight_animation3[] = 
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,34617,
-	34617,34617,34617,0,0,0,0,0,0,0,34617,34617,
-	34617,34617,34617,34617,0,0,0,0,4492,4492,34617,
-	34617,34617,34617,34617,34617,4492,4492,0,0,34617,
-	34617,34617,34617,34617,34617,34617,34617,34617,34617,
-	0,0,4492,4492,34617,34617,34617,34617,34617,34617,4492,
-	4492,0,0,0,0,0,34617,34617,34617,34617,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-const uint16_t spike[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,50737,
-	0,0,0,0,0,0,0,0,0,0,0,50737,0,0,0,0,0,0,0,0,0,0,0,50737,50737,
-	0,0,0,0,0,0,0,0,0,50737,65535,50737,0,0,0,0,0,0,0,0,0,50737,65535,
-	50737,0,0,0,0,0,0,0,0,0,50737,65535,50737,50737,0,0,0,0,0,0,0,0,50737,
-	65535,50737,50737,0,0,0,0,0,0,0,50737,65535,20612,50737,50737,0,0,0,0,
-	0,0,0,50737,65535,20612,50737,50737,0,0,0,0,0,0,0,50737,65535,20612,43866,
-	50737,50737,0,0,0,0,0,0,50737,65535,20612,43866,50737,50737,0,0,0,0,0,50737,
-	65535,20612,20612,43866,50737,50737,0,0,0,0,0,50737,65535,20612,43866,43866,
-	50737,50737,50737,0,0,0,0,50737,65535,20612,43866,43866,43866,43866,50737,0,0,0,
-};
-
-// spike: Array to store the graphical representation of a spike obstacle
-const uint16_t nightmare_spike[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,7960,0,0,0,
-	0,0,0,0,0,0,0,0,7960,0,0,0,0,0,0,0,0,0,0,0,7960,7960,0,0,0,0,0,0,0,
-	0,0,7960,7960,7960,0,0,0,0,0,0,0,0,0,7960,7960,50737,0,0,0,0,0,0,0,
-	0,0,50737,7960,50737,7960,0,0,0,0,0,0,0,0,50737,7960,50737,50737,0,
-	0,0,0,0,0,0,50737,7960,20612,50737,50737,0,0,0,0,0,0,0,50737,7960,
-	20612,50737,50737,0,0,0,0,0,0,0,50737,7960,20612,43866,50737,50737,
-	0,0,0,0,0,0,50737,7960,20612,43866,50737,50737,0,0,0,0,0,50737,7960,
-	20612,20612,43866,50737,50737,0,0,0,0,0,50737,7960,20612,43866,43866,
-	50737,50737,50737,0,0,0,0,50737,7960,20612,43866,43866,43866,43866,50737
-	,0,0,0,
-};
-
-// heart: Array to represent a heart (life) in the game
-const uint16_t heart[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,7936,7936,0,
-	0,0,7936,7936,0,0,0,0,7936,7936,7936,7936,0,7936,7936,7936,7936,0,0,
-	0,7936,56253,7936,7936,7936,7936,7936,7936,7936,0,0,0,7936,7936,7936,
-	7936,7936,7936,7936,7936,7936,0,0,0,7936,7936,7936,7936,7936,7936,7936,
-	7936,7936,0,0,0,7936,7936,7936,7936,7936,7936,7936,7936,7936,0,0,0,0,7936,
-	7936,7936,7936,7936,7936,7936,0,0,0,0,0,0,7936,7936,7936,7936,7936,0,0,0,0,
-	0,0,0,0,7936,7936,7936,0,0,0,0,0,0,0,0,0,0,7936,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,
-};
-
-// nightmare_heart: Heart representation for Nightmare Mode
-const uint16_t nightmare_heart[] = 
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,12192,12192,0,0,0,
-	12192,12192,0,0,0,0,12192,12192,12192,12192,0,12192,12192,12192,12192,0,
-	0,0,12192,56253,12192,12192,12192,12192,12192,12192,12192,0,0,0,12192,
-	12192,12192,12192,12192,12192,12192,12192,12192,0,0,0,12192,12192,12192,
-	12192,12192,12192,12192,12192,12192,0,0,0,12192,12192,12192,12192,12192,
-	12192,12192,12192,12192,0,0,0,0,12192,12192,12192,12192,12192,12192,12192,
-	0,0,0,0,0,0,12192,12192,12192,12192,12192,0,0,0,0,0,0,0,0,12192,12192,12192,
-	0,0,0,0,0,0,0,0,0,0,12192,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// hearts_empty: Array to represent an empty heart (lost life)
-const uint16_t hearts_empty[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,44395,44395,0,0,0,
-	44395,44395,0,0,0,0,44395,44395,44395,44395,0,44395,44395,44395,44395,0,
-	0,0,44395,56253,44395,44395,44395,44395,44395,44395,44395,0,0,0,44395,44395,
-	44395,44395,44395,44395,44395,44395,44395,0,0,0,44395,44395,44395,44395,44395,
-	44395,44395,44395,44395,0,0,0,44395,44395,44395,44395,44395,44395,44395,44395,
-	44395,0,0,0,0,44395,44395,44395,44395,44395,44395,44395,0,0,0,0,0,0,44395,44395,
-	44395,44395,44395,0,0,0,0,0,0,0,0,44395,44395,44395,0,0,0,0,0,0,0,0,0,0,44395,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// key: Array to represent a key in Level 1
-const uint16_t key[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,24326,7943,0,0,0,0,0,
-	0,0,0,0,0,24326,7943,0,0,0,0,0,0,0,0,0,0,24326,7943,0,0,0,0,0,0,0,0,0,0,24326,
-	7943,7943,7943,0,0,0,0,0,0,0,0,24326,7943,7943,0,0,0,0,0,0,0,0,0,24326,7943,0,0,
-	0,0,0,0,0,0,0,0,24326,7943,0,0,0,0,0,0,0,0,0,0,24326,7943,0,0,0,0,0,0,0,0,0,0,
-	24326,7943,0,0,0,0,0,0,0,0,0,0,24326,7943,0,0,0,0,0,0,0,0,0,7943,0,0,7943,0,0,
-	0,0,0,0,0,0,24326,0,0,7943,0,0,0,0,0,0,0,0,24326,7943,7943,24326,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,
-};
+extern volatile uint32_t milliseconds_uptime;  // Free running millisecond count since boot, kept by timebase.c
+volatile int timer = 60;  // Seconds left in Nightmare Mode, counted down by countdown_timer
 
-// taken_key: Array to represent a collected key
-const uint16_t taken_key[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,26954,44395,0,0,0,
-	0,0,0,0,0,0,0,26954,44395,0,0,0,0,0,0,0,0,0,0,26954,44395,0,0,0,0,0,0,0,0,0,
-	0,26954,44395,44395,44395,0,0,0,0,0,0,0,0,26954,44395,44395,0,0,0,0,0,0,0,0,
-	0,26954,44395,0,0,0,0,0,0,0,0,0,0,26954,44395,0,0,0,0,0,0,0,0,0,0,26954,44395,
-	0,0,0,0,0,0,0,0,0,0,26954,44395,0,0,0,0,0,0,0,0,0,0,26954,44395,0,0,0,0,0,0,0,
-	0,0,44395,0,0,44395,0,0,0,0,0,0,0,0,26954,0,0,44395,0,0,0,0,0,0,0,0,26954,26954,
-	44395,26954,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// door: Array to represent a door in the game
-const uint16_t door[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,18233,18233,
-	18233,18233,0,0,0,0,0,0,0,18233,37640,60672,37640,
-	37640,18233,0,0,0,0,0,18233,60672,37640,60672,60672,
-	37640,37640,18233,0,0,0,18233,60672,60672,37640,60672,
-	60672,37640,60672,37640,18233,0,0,18233,37640,60672,37640,
-	60672,37640,37640,60672,37640,18233,0,0,18233,60672,60672,
-	37640,60672,60672,37640,37640,37640,18233,0,0,18233,44395,
-	44395,44395,44395,44395,44395,44395,44395,18233,0,0,18233,
-	44395,44395,44395,44395,44395,44395,44395,44395,18233,0,0,
-	18233,60672,60672,37640,37640,60672,37640,60672,37640,18233,
-	0,0,18233,60672,60672,37640,60672,60672,37640,60672,37640,18233,
-	0,0,18233,60672,37640,37640,60672,60672,37640,60672,37640,18233,
-	0,0,18233,44395,44395,44395,44395,44395,44395,24326,44395,18233,
-	0,0,18233,44395,44395,44395,44395,44395,44395,24326,44395,18233,
-	0,0,18233,37640,60672,37640,60672,60672,37640,37640,37640,18233,
-	0,0,18233,60672,60672,37640,37640,60672,37640,60672,37640,18233,
-	0,0,18233,18233,18233,18233,18233,18233,18233,18233,18233,18233,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// skeleton_run: Array for the running animation of a skeleton enemy
-const uint16_t skeleton_run[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,10306,0,0,0,0,0,39374,39374,39374,39374,
-	39374,0,10306,27218,27218,0,0,39374,65535,65535,65535,65535,65535,
-	0,10306,27218,27218,0,0,39374,65535,0,65535,0,65535,0,10306,27218,
-	10306,0,0,39374,65535,65535,39374,65535,65535,0,51977,10306,0,0,0,
-	0,0,39374,39374,39374,39374,0,51977,0,0,0,0,39374,65535,65535,65535,
-	39374,0,0,4114,0,0,0,0,39374,65535,0,0,39374,39374,0,4114,0,0,0,0,
-	39374,65535,65535,65535,39374,39374,39374,4114,0,0,0,0,39374,65535,
-	0,0,39374,0,0,4114,0,0,0,0,0,65535,65535,39374,39374,0,0,4114,0,0,0,
-	0,65535,65535,0,0,0,39374,0,4114,0,0,0,65535,0,0,0,0,0,0,0,4114,0,0,0,
-};
-
-// skeleton_attack1: First attack frame of the skeleton enemy
-const uint16_t skeleton_attack1[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,39374,39374,39374,39374,39374,0,0,0,
-	10306,0,0,39374,65535,65535,65535,65535,65535,0,0,0,10306,0,0,39374,
-	65535,0,65535,0,65535,0,0,10306,27218,27218,27218,39374,65535,65535,
-	39374,65535,65535,0,0,10306,27218,27218,0,0,0,39374,39374,39374,39374,
-	0,51977,10306,27218,10306,0,39374,65535,65535,65535,39374,0,51977,51977,
-	0,0,0,0,39374,39374,0,0,39374,39374,4114,0,0,0,0,0,0,39374,39374,65535,
-	39374,4114,4114,0,0,0,0,0,0,65535,39374,39374,39374,4114,0,0,0,0,0,0,0,
-	65535,65535,39374,4114,4114,0,0,0,0,0,0,0,65535,0,0,4114,0,0,0,0,0,0,0,0,
-	39374,0,4114,4114,0,0,0,0,0,0,0,
-};
-
-// skeleton_attack2: Second attack frame of the skeleton enemy
-const uint16_t skeleton_attack2[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,39374,39374,39374,39374,39374,0,0,0,
-	0,0,0,39374,65535,65535,65535,65535,65535,0,0,0,0,0,0,39374,65535,0,
-	65535,0,65535,0,0,0,0,0,0,39374,65535,65535,39374,65535,65535,0,0,0,
-	0,0,0,0,0,39374,39374,39374,39374,0,0,0,0,0,0,39374,65535,65535,65535,
-	39374,0,0,0,0,0,0,0,0,39374,0,0,39374,39374,0,0,0,0,0,4114,4114,4114,
-	65535,4114,4114,65535,51977,10306,10306,10306,10306,0,0,65535,39374,
-	39374,39374,0,10306,27218,27218,27218,0,0,0,65535,65535,39374,39374,0,
-	0,10306,27218,27218,0,0,0,65535,0,0,39374,0,0,0,0,0,0,0,0,39374,0,0,
-	39374,0,0,0,0,0,0,
-};
-
-// night_skeleton_run: Running animation for the skeleton in Nightmare Mode
-const uint16_t night_skeleton_run[] = 
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,10306,0,0,0,0,0,30168,30168,30168,30168,30168,
-	0,10306,27218,27218,0,0,30168,48123,48123,48123,48123,48123,0,10306,
-	27218,27218,0,0,30168,48123,7960,48123,7960,48123,0,10306,27218,10306,
-	0,0,30168,48123,48123,30168,48123,48123,0,51977,10306,0,0,0,0,0,30168,
-	30168,30168,30168,0,51977,0,0,0,0,30168,48123,48123,48123,30168,0,0,4114,
-	0,0,0,0,30168,48123,0,0,30168,30168,0,4114,0,0,0,0,30168,48123,48123,48123,
-	30168,30168,30168,4114,0,0,0,0,30168,48123,0,0,30168,0,0,4114,0,0,0,0,0,48123,
-	48123,30168,30168,0,0,4114,0,0,0,0,48123,48123,0,0,0,30168,0,4114,0,0,0,48123,
-	0,0,0,0,0,0,0,4114,0,0,0,
-};
-
-// night_skeleton_attack1: First attack frame of the skeleton in Nightmare Mode
-const uint16_t night_skeleton_attack1[] = 
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,30168,30168,30168,30168,30168,0,0,0,10306,
-	0,0,30168,48123,48123,48123,48123,48123,0,0,0,
-	10306,0,0,30168,48123,7960,48123,7960,48123,0,0,
-	10306,27218,27218,27218,30168,48123,48123,30168,
-	48123,48123,0,0,10306,27218,27218,0,0,0,30168,30168,
-	30168,30168,0,51977,10306,27218,10306,0,30168,48123,
-	48123,48123,30168,0,51977,51977,0,0,0,0,30168,30168,
-	0,0,30168,30168,4114,0,0,0,0,0,0,30168,30168,48123,
-	30168,4114,4114,0,0,0,0,0,0,48123,30168,30168,30168,
-	4114,0,0,0,0,0,0,0,48123,48123,30168,4114,4114,0,0,0,
-	0,0,0,0,48123,0,0,4114,0,0,0,0,0,0,0,0,30168,0,4114,
-	4114,0,0,0,0,0,0,0,
-};
-
-// night_skeleton_attack2: Second attack frame of the skeleton in Nightmare Mode
-const uint16_t night_skeleton_attack2[] = 
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	30168,30168,30168,30168,30168,0,0,0,0,0,0,30168,48123,
-	48123,48123,48123,48123,0,0,0,0,0,0,30168,48123,7960,
-	48123,7960,48123,0,0,0,0,0,0,30168,48123,48123,30168,
-	48123,48123,0,0,0,0,0,0,0,0,30168,30168,30168,30168,0,
-	0,0,0,0,0,30168,48123,48123,48123,30168,0,0,0,0,0,0,0,
-	0,30168,0,0,30168,30168,0,0,0,0,0,4114,4114,4114,48123,
-	4114,4114,48123,51977,10306,10306,10306,10306,0,0,48123,
-	30168,30168,30168,0,10306,27218,27218,27218,0,0,0,48123,
-	48123,30168,30168,0,0,10306,27218,27218,0,0,0,48123,0,0,
-	30168,0,0,0,0,0,0,0,0,30168,0,0,30168,0,0,0,0,0,0,
-};
-
-// easy_skull: Skull representation for the easy difficulty level
-const uint16_t easy_skull[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-	14005,39374,39374,39374,39374,14005,0,0,0,0,0,14005,
-	14005,14005,14005,14005,14005,14005,14005,0,0,0,14005,
-	14005,14005,14005,14005,14005,14005,14005,14005,14005,
-	0,0,14005,14005,14005,14005,14005,14005,14005,14005,
-	14005,14005,0,0,14005,0,0,0,14005,14005,0,0,0,14005,0,
-	0,14005,0,40966,40966,14005,14005,40966,40966,0,14005,0,
-	0,39374,0,40966,40966,14005,14005,40966,40966,0,39374,0,
-	0,0,14005,14005,14005,0,0,14005,14005,14005,0,0,0,0,14005,
-	14005,14005,14005,14005,14005,14005,14005,0,0,0,0,14005,
-	14005,14005,14005,14005,14005,14005,14005,0,0,0,0,14005,
-	14005,14005,14005,14005,14005,14005,14005,0,0,0,0,0,39374,
-	14005,14005,14005,14005,39374,0,0,0,0,0,0,0,14005,39374,39374,
-	14005,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// normal_skull: Skull representation for the normal difficulty level
-const uint16_t normal_skull[] =
-{
-	0,0,0,0,0,0,0,0,0,0,0,0,0,11627,0,0,0,0,0,0,0,0,11627,0,11627,11627,
-	11627,14005,39374,39374,39374,39374,14005,11627,11627,11627,0,11627,
-	14005,14005,14005,14005,14005,14005,14005,14005,11627,0,0,14005,14005,
-	14005,14005,14005,14005,14005,14005,14005,14005,0,0,14005,14005,14005,
-	14005,14005,14005,14005,14005,14005,14005,0,0,14005,0,0,0,14005,14005,
-	0,0,0,14005,0,0,14005,0,15950,15950,14005,14005,15950,15950,0,14005,0,
-	0,39374,0,15950,15950,14005,14005,15950,15950,0,39374,0,0,0,14005,14005,
-	14005,0,0,14005,14005,14005,0,0,0,0,14005,14005,14005,14005,14005,14005,
-	14005,14005,0,0,0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
-	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,0,0,0,39374,14005,
-	14005,14005,14005,39374,0,0,0,0,0,0,0,14005,39374,39374,14005,0,0,0,0,0,0,
-	0,0,0,0,0,0,0,0,0,0,
-};
-
-// hard_skull: Skull representation for the hard difficulty level
-const uint16_t hard_skull[] =
-{
-	11627,0,0,0,0,0,0,0,0,0,0,11627,11627,11627,0,0,0,0,0,0,0,0,
-	11627,11627,11627,11627,11627,14005,39374,39374,39374,39374,
-	14005,11627,11627,11627,0,11627,14005,14005,14005,14005,14005,
-	14005,14005,14005,11627,0,0,14005,14005,14005,14005,14005,14005,
-	14005,14005,14005,14005,0,0,14005,14005,14005,14005,14005,14005,
-	14005,14005,14005,14005,0,0,14005,0,0,0,14005,14005,0,0,0,14005,
-	0,0,14005,0,40705,40705,14005,14005,40705,40705,0,14005,0,0,39374,
-	0,40705,40705,14005,14005,40705,40705,0,39374,0,0,0,14005,14005,
-	14005,0,0,14005,14005,14005,0,0,0,0,14005,14005,14005,14005,14005,
-	14005,14005,14005,0,0,0,0,14005,14005,14005,14005,14005,14005,14005,
-	14005,0,0,0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,0,
-	0,0,39374,14005,14005,14005,14005,39374,0,0,0,0,0,0,0,14005,39374,39374,
-	14005,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-// nightmare_skull: Skull representation for the Nightmare Mode
-const uint16_t nightmare_skull[] =
-{
-	11627,0,0,0,0,0,0,0,0,0,0,11627,11627,11627,0,0,0,0,0,
-	0,0,0,11627,11627,11627,11627,11627,30168,30961,30961,
-	30961,30961,30168,11627,11627,11627,0,11627,30168,30168,
-	30168,30168,30168,30168,30168,30168,11627,0,0,30168,30168,
-	30168,30168,30168,30168,30168,30168,30168,30168,0,0,30168,
-	30168,30168,30168,30168,30168,30168,30168,30168,30168,0,0,
-	30168,0,0,0,30168,30168,0,0,0,30168,0,0,30168,0,7960,7960,
-	30168,30168,7960,7960,0,30168,0,0,30961,0,7960,7960,30168,
-	30168,7960,7960,0,30961,0,0,0,30168,30168,30168,0,0,30168,
-	30168,30168,0,0,0,0,30168,30168,30168,30168,30168,30168,30168,
-	30168,0,0,0,0,30168,30168,30168,30168,30168,30168,30168,30168,0,
-	0,0,0,30168,30168,30168,30168,30168,30168,30168,30168,0,0,0,0,
-	0,30961,30168,30168,30168,30168,30961,0,0,0,0,0,0,0,30168,30961,
-	30961,30168,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,
-};
-
-int music_flag = 0;  // Flag to control music playback
 int current_level = 1;  // Variable to track the current game level
-int start_movement = 0;  // Flag to start player movement
 int badges[BADGES_AMOUNT] = {0,0,0,0};  // Array to store badge status for player achievements
-char timer_string[NUM_OF_CHAR];  // String to display timer information
 
 // Nightmare Mode 
 int nightmare_enabled = 0;
-int nightmare_flag = 0;
 
 //Seed for picking random player locations.
 uint32_t seed = 0; 
 
+// Game state shared between the scenes
+static int difficulty = 0; // Difficulty level, 0 until one is picked
+static int num_of_hearts = 0; // Number of hearts (lives)
+static uint16_t player_x = 53; // Player's X position
+static uint16_t player_y = 125; // Player's Y position
+static uint8_t buttons_held = 0; // Buttons down this frame
+static uint8_t buttons_pressed = 0; // Buttons that went down since the last frame
+static EnemyWorld enemy_world; // The level's grid and the skeletons' flow field
+
 int main() 
 {
-    // Initialize variables
-    int start_game = 0;
-    int intro_seen = 0;
-    int hinverted = 0; // Horizontal inversion flag
-    int vinverted = 0; // Vertical inversion flag
-    int toggle = 0; // Toggle for animation
-    int hmoved = 0; // Horizontal movement flag
-    int vmoved = 0; // Vertical movement flag
-    int difficulty = 0; // Difficulty level
-    int current_diff_choice = 0; // Current difficulty choice
-    int num_of_hearts = 0; // Number of hearts (lives)
-    char system_log[] = "Game has been intialised";
-    uint16_t x = 53; // Player's X position
-    uint16_t y = 125; // Player's Y position
-    uint16_t oldx = x; // Previous X position
-    uint16_t oldy = y; // Previous Y position
-    uint16_t oldx_OG = x; // Original X position
-    uint16_t oldy_OG = y; // Original Y position
-
-    // Initialize system components
+    int panel_ready = 0;
+    // Initialize system components. setupIO only starts the panel's reset, the rest of
+    // its power up runs from the loop below while everything else gets going.
+    boot_start(); // before anything else can reset the chip and mix up the flags
+    stack_paint(); // while the stack is still shallow
     initClock();
-    initSysTick();
+    timebase_init();
     setupIO();
     initSound();
     initSerial();
-
-    // Log system initialization
-    serial_log(system_log);
-
-    // Indicate the game is running and not in a level
-    RedOn();
-
-    // Main game loop
+    initPower();
+    PROFILE_INIT();
+    FASTMATH_BENCH(); // Only with PROFILE, cycles for the divisions it replaces
+    SAMPLER_START(997); // Samples per second, kept off a multiple of the 1ms SysTick
+    path_set_budget_us(&enemy_world.flow,&enemy_world.grid,400); // Pathfinding may use at most 0.4ms of each frame
+    transition_set_budget(4096); // Screen changes may push at most 4096 pixels (~4ms) a frame
+    if (boot_watchdog_reset())
+        watchdog_report(); // What was running when the last boot hung
+    watchdog_start();
+    game_init();
+    boot_mark(BOOT_PERIPHERALS);
+
+    // Main game loop, one frame every FRAME_MS whatever scene is showing
     while(1) 
-	{
-        // Display intro if not seen
-        if (intro_seen == 0) {
-            intro();
-            start_game = 1;
-            intro_seen = 1;
+    {
+        uint32_t frame_start = milliseconds_uptime;
+        uint32_t frame_ms = FRAME_MS;
+        watchdog_frame(scene_current() ? scene_current()->name : "boot");
+        if (!panel_ready) {
+            // Until the panel is on a frame is one tick, so no power up step waits longer than it must
+            frame_ms = 1;
+            panel_ready = display_poll(frame_start);
+            if (panel_ready)
+                boot_mark(BOOT_PANEL_ON);
         }
-        // Display main menu after intro
-        if (start_game == 0 && intro_seen == 1) {
-            main_menu();
-            x = oldx_OG;
-            y = oldy_OG;
-            start_game = 1;
+        if (panel_ready) {
+            WATCHDOG_ZONE_ENTER(PROF_FRAME);
+            PROFILE_BEGIN(PROF_FRAME);
+            game_frame(frame_start);
+            PROFILE_END(PROF_FRAME);
+            WATCHDOG_ZONE_LEAVE(PROF_FRAME);
+            boot_mark(BOOT_FIRST_FRAME); // only the first one counts
         }
-
-        // Difficulty selection
-        Difficulty_choice(&difficulty, current_diff_choice, &num_of_hearts);
-        if (nightmare_enabled == 1 && difficulty == 3) {
-            Difficulty_Nightmare(&difficulty, current_diff_choice, &num_of_hearts);
+        // Sleep out the rest of the frame. Screens that only wait on a button may
+        // also power the panel down if they are left alone.
+        while ((milliseconds_uptime - frame_start) < frame_ms) {
+            if (panel_ready && scene_current()->idle)
+                power_idle();
+            else
+                power_sleep();
         }
-
-	// Level handling
-	switch (current_level) 
-	{
-		case 1:
-		{
-			start_movement = 1;
-			int game = Level1_Start(x,y,oldx_OG,oldy_OG,&x,&y,num_of_hearts,difficulty);
-			if (game == 1)
-			{
-				gameover(&start_game,&current_diff_choice,&difficulty);
-			}
-			game = 0;
-			break;
-		}
-		case 2:
-		{
-			start_movement = 1;
-			int game = Level2_Start(x,y,oldx_OG,oldy_OG,&x,&y,num_of_hearts,difficulty);
-			if (game == 1)
-			{
-				gameover(&start_game,&current_diff_choice,&difficulty);
-			}
-			game = 0;
-			break;
-		}
-		case 3:
-		{
-			start_movement = 1;
-			int game = Level3_Start(x,y,oldx_OG,oldy_OG,&x,&y,num_of_hearts,difficulty);
-			if (game == 1)
-			{
-				gameover(&start_game,&current_diff_choice,&difficulty);
-			}
-			game = 0;
-			break;
-		}
-		case 4:
-		{
-			gameend(&start_game,&current_diff_choice,&difficulty);
-		}
-		default:
-		{
-			break;
-		}
-	}
-
-        // Handle player movement and input
-        if (start_game == 1) {
-            hmoved = vmoved = 0;
-            hinverted = vinverted = 0;
-            RightButtonPressed(&x, &hmoved, &hinverted);
-            LeftButtonPressed(&x, &hmoved, &hinverted);
-            UpButtonPressed(&y, &vmoved, &vinverted);
-            DownButtonPressed(&y, &vmoved, &vinverted);
-
-            if (vmoved || hmoved) {
-                // Redraw only if there has been movement to reduce flicker
-                fillRectangle(oldx, oldy, 12, 16, 0);
-                oldx = x;
-                oldy = y;
-                if (hmoved) {
-                    // Alternate between knight animations for horizontal movement
-                    if (toggle)
-                        putImage(x, y, 12, 16, knight_animation1, hinverted, 0);
-                    else
-                        putImage(x, y, 12, 16, knight_animation2, hinverted, 0);
-                    
-                    toggle = toggle ^ 1;
-                } else {
-                    // Use a different animation for vertical movement
-                    putImage(x, y, 12, 16, knight_animation3, 0, vinverted);
-                }
-            }
-        }
-
-        delay(30); // Short delay for game loop timing
     }
     return 0;
 }
 
-void initSysTick(void)
-{
-	SysTick->LOAD = 48000;
-	SysTick->CTRL = 7;
-	SysTick->VAL = 10;
-	__asm(" cpsie i "); // enable interrupts
-}
-void SysTick_Handler(void)
-{
-	milliseconds++;
-	milliseconds_timer++;
-}
 void initClock(void)
 {
 // This is potentially a dangerous function as it could
@@ -629,9 +195,9 @@ void initClock(void)
 }
 void delay(volatile uint32_t dly)
 {
-	uint32_t end_time = dly + milliseconds;
-	while(milliseconds != end_time)
-		__asm(" wfi "); // sleep
+	uint32_t end_time = dly + milliseconds_uptime;
+	while (!TIME_REACHED(milliseconds_uptime, end_time))
+		power_sleep(); // sleep until the next tick
 }
 
 void enablePullUp(GPIO_TypeDef *Port, uint32_t BitNumber)
@@ -651,6 +217,7 @@ int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, uint16_t px, uint
 {
 	// checks to see if point px,py is within the rectange defined by x,y,w,h
 	uint16_t x2,y2;
+	PROFILE_BEGIN(PROF_ISINSIDE);
 	x2 = x1+w;
 	y2 = y1+h;
 	int rvalue = 0;
@@ -660,13 +227,14 @@ int isInside(uint16_t x1, uint16_t y1, uint16_t w, uint16_t h, uint16_t px, uint
 		if ( (py >= y1) && (py <= y2))
 			rvalue = 1;
 	}
+	PROFILE_END(PROF_ISINSIDE);
 	return rvalue;
 }
 
 void setupIO()
 {
 	RCC->AHBENR |= (1 << 18) + (1 << 17); // enable Ports A and B
-	display_begin();
+	display_begin(boot_cold()); // a warm boot finds the panel powered and skips its reset
 	pinMode(GPIOB,4,0);
 	pinMode(GPIOB,5,0);
 	pinMode(GPIOA,8,0);
@@ -678,1301 +246,842 @@ void setupIO()
 	enablePullUp(GPIOA,11);
 	enablePullUp(GPIOA,8);
 }
-// Function for handling right button press. Moves the player to the right.
-void RightButtonPressed(uint16_t* x,int* hmoved, int* hinverted) {
-    if ((GPIOB->IDR & (1 << 4))==0) { // Check if the right button is pressed
-        if (*x < 110) { // Ensure the player doesn't move out of the screen bounds
-            *x = (*x + 1); // Move the player to the right
-            *hmoved = 1; // Flag to indicate horizontal movement
-            *hinverted = 0; // Flag to manage sprite inversion (flipping)
-        }                        
-    }
+
+static LevelLayout nightmare_layout; // Generated from the seed when the level starts in Nightmare
+
+// Animation clips: sprite, milliseconds on screen (0 holds it) and extra flips
+static const AnimFrame knight_walk_frames[] = {{SPRITE(SPRITE_KNIGHT1), 100, 0}, {SPRITE(SPRITE_KNIGHT2), 100, 0}};
+static const AnimFrame knight_climb_frames[] = {{SPRITE(SPRITE_KNIGHT3), 0, 0}};
+static const AnimFrame skeleton_run_frames[] = {{SPRITE(SPRITE_SKELETON_RUN), 0, 0}};
+static const AnimFrame skeleton_attack_frames[] = {{SPRITE(SPRITE_SKELETON_ATTACK1), 150, 0}, {SPRITE(SPRITE_SKELETON_ATTACK2), 250, 0}};
+static const AnimFrame night_skeleton_run_frames[] = {{SPRITE(SPRITE_NIGHT_SKELETON_RUN), 0, 0}};
+static const AnimFrame night_skeleton_attack_frames[] = {{SPRITE(SPRITE_NIGHT_SKELETON_ATTACK1), 150, 0}, {SPRITE(SPRITE_NIGHT_SKELETON_ATTACK2), 250, 0}};
+static const AnimClip knight_walk = {knight_walk_frames, 2, 1};
+static const AnimClip knight_climb = {knight_climb_frames, 1, 1};
+static const AnimClip skeleton_running = {skeleton_run_frames, 1, 1};
+static const AnimClip skeleton_attack = {skeleton_attack_frames, 2, 0};
+static const AnimClip night_skeleton_running = {night_skeleton_run_frames, 1, 1};
+static const AnimClip night_skeleton_attack = {night_skeleton_attack_frames, 2, 0};
+
+// Musical notes for each level
+static const uint16_t level1_notes[LEVEL_1_MUSIC] = {PERIOD_C4,PERIOD_D4,PERIOD_E4,PERIOD_G4,PERIOD_E4,PERIOD_D4,PERIOD_C4,PERIOD_G4,PERIOD_E4,PERIOD_C4};
+static const uint16_t level2_notes[LEVEL_2_MUSIC] = {PERIOD_G4, PERIOD_B4, PERIOD_D5, PERIOD_G5, PERIOD_D5, PERIOD_B4, PERIOD_G4, PERIOD_A4, PERIOD_B4, PERIOD_G4, PERIOD_B4, PERIOD_D5, PERIOD_G5, PERIOD_D5, PERIOD_B4, PERIOD_G4};
+static const uint16_t level3_notes[LEVEL_3_MUSIC] = {PERIOD_A4, PERIOD_C5, PERIOD_E5, PERIOD_A5, PERIOD_G5, PERIOD_E5, PERIOD_C5, PERIOD_A4, PERIOD_B4, PERIOD_D5, PERIOD_F5, PERIOD_B5, PERIOD_A5, PERIOD_F5, PERIOD_D5, PERIOD_B4, PERIOD_E4, PERIOD_G4, PERIOD_B4, PERIOD_E5, PERIOD_D5, PERIOD_B4, PERIOD_G4, PERIOD_E4};
+static const uint16_t *const level_notes[3] = {level1_notes, level2_notes, level3_notes};
+static const int level_notes_len[3] = {LEVEL_1_MUSIC, LEVEL_2_MUSIC, LEVEL_3_MUSIC};
+
+// State of the level being played, reset whenever a level is started
+static const LevelLayout *layout;
+static Enemy skeletons[LEVEL_MAX_ENEMIES];
+static int heart_gone = 0; // Number of hearts lost
+static int key_pickup[LEVEL_MAX_KEYS]; // Array to track picked-up keys
+static int amount_keys = 0; // Total number of keys picked up
+static int seed_held = 0; // Both start buttons are being held on the level card
+static HudIcons hearts_bar; // Hearts along the top right, emptied from the left
+static HudIcons keys_bar; // Key slots along the top left, filled in as keys are found
+static HudCounter timer_counter; // Nightmare countdown
+
+// The knight, moved by the buttons during a level
+static Motion knight; // Sub-pixel position and velocity of the player
+static uint32_t last_frame = 0; // milliseconds_uptime at the previous movement update
+
+// Game timers, run from SysTick by timebase.c
+#define MUSIC_NOTE_MS 500 // one note of the level music, rest included
+#define MUSIC_REST_MS 30 // silence at the end of each note
+static SoftTimer countdown_timer; // Nightmare's seconds, only runs in a level
+static SoftTimer music_timer;
+static const uint16_t *music_notes = 0;
+static int music_len = 1;
+static volatile int music_next = 0;
+static volatile uint8_t music_sounding = 0;
+static void countdown_tick(void);
+static void music_start(const uint16_t notes[], int num_of_notes);
+static void music_resume(void);
+static void music_stop(void);
+static uint16_t oldx = 53, oldy = 125; // Where the knight was last drawn
+static int hinverted = 0; // Horizontal inversion flag
+static int vinverted = 0; // Vertical inversion flag
+static AnimPlayer knight_anim; // Walking or climbing, held while he stands still
+static int hmoved = 0; // Horizontal movement flag
+static int vmoved = 0; // Vertical movement flag
+static int knight_dirty = 0; // Moved, changed frame or blinked, needs drawing again
+
+// Dying doesn't stop the level. He goes down where he was hit and blinks while the
+// attack plays out, then comes back at a spawn point blinking and can't be hurt again
+// until that stops. The frame loop moves him through these, see knight_hit.
+#define KNIGHT_ALIVE 0
+#define KNIGHT_DOWN 1 // hit, can't move
+#define KNIGHT_SHIELDED 2 // back at a spawn point, can move but not be hurt
+#define KNIGHT_DOWN_MS 700 // long enough for the skeleton's attack to play through
+#define KNIGHT_SHIELD_MS 1500
+#define KNIGHT_BLINK_MS 128 // a power of two, the phase is a single bit of the time
+static uint8_t knight_state = KNIGHT_ALIVE;
+static uint32_t knight_since = 0; // frame time knight_state was entered
+static uint8_t knight_visible = 1; // drawn this frame, off for half of each blink
+static uint8_t knight_shown = 1; // what the screen has
+
+// Scenes, in the order a game goes through them
+static void intro_update(uint32_t now);
+static void intro_render(void);
+static void menu_enter(void);
+static void menu_update(uint32_t now);
+static void difficulty_enter(void);
+static void difficulty_update(uint32_t now);
+static void nightmare_enter(void);
+static void nightmare_update(uint32_t now);
+static void card_enter(void);
+static void card_update(uint32_t now);
+static void level_enter(void);
+static void level_update(uint32_t now);
+static void level_render(void);
+static void level_exit(void);
+static void level_redraw(int16_t x, int16_t y, uint16_t w, uint16_t h);
+static void level_draw_sprites(void);
+static int in_area(int16_t sx, int16_t sy, int16_t x, int16_t y, uint16_t w, uint16_t h);
+static void draw_knight(void);
+static int uncovered(const Waypoint *o);
+static void complete_enter(void);
+static void complete_update(uint32_t now);
+static void gameover_enter(void);
+static void gameover_update(uint32_t now);
+static void gameend_enter(void);
+static void gameend_update(uint32_t now);
+
+static const Scene intro_scene = {"intro", 0, intro_update, intro_render, 0, 1, TRANSITION_NONE};
+static const Scene menu_scene = {"menu", menu_enter, menu_update, 0, 0, 1, TRANSITION_COLUMNS};
+static const Scene difficulty_scene = {"difficulty", difficulty_enter, difficulty_update, 0, 0, 1, TRANSITION_COLUMNS};
+static const Scene nightmare_scene = {"nightmare", nightmare_enter, nightmare_update, 0, 0, 1, TRANSITION_FADE};
+static const Scene card_scene = {"card", card_enter, card_update, 0, 0, 1, TRANSITION_WIPE};
+static const Scene level_scene = {"level", level_enter, level_update, level_render, level_exit, 0, TRANSITION_WIPE};
+static const Scene complete_scene = {"complete", complete_enter, complete_update, 0, 0, 1, TRANSITION_COLUMNS};
+static const Scene gameover_scene = {"gameover", gameover_enter, gameover_update, 0, 0, 1, TRANSITION_FADE};
+static const Scene gameend_scene = {"gameend", gameend_enter, gameend_update, 0, 0, 1, TRANSITION_FADE};
+
+void game_init(void)
+{
+    char system_log[] = "Game has been intialised";
+    // Log system initialization
+    serial_log(system_log);
+    // Indicate the game is running and not in a level
+    RedOn();
+    // After a warm reset the player has already sat through the intro
+    if (boot_intro_seen())
+        scene_start(&menu_scene);
+    else
+        scene_start(&intro_scene);
+}
+
+void game_frame(uint32_t now)
+{
+    // Sample the buttons once a frame so every scene sees the same presses. A press only
+    // counts on the frame it goes down, so a button held from one screen doesn't also
+    // make a choice on the next.
+    uint8_t held = 0;
+    if ((GPIOB->IDR & (1 << 4)) == 0) held |= BUTTON_RIGHT;
+    if ((GPIOB->IDR & (1 << 5)) == 0) held |= BUTTON_LEFT;
+    if ((GPIOA->IDR & (1 << 11)) == 0) held |= BUTTON_UP;
+    if ((GPIOA->IDR & (1 << 8)) == 0) held |= BUTTON_DOWN;
+    buttons_pressed = held & ~buttons_held;
+    buttons_held = held;
+    scene_frame(now);
+}
+
+// Puts everything back the way it was at power on, ready for a new game
+static void game_reset(void)
+{
+    difficulty = 0; // Reset the difficulty
+    current_level = 1; // Reset the current level to 1
+    timer = 60; // Reset the timer back to 60 seconds
+    seed = 0; // Reset the seed
+    player_x = 53;
+    player_y = 125;
 }
 
-// Function for handling left button press. Moves the player to the left.
-void LeftButtonPressed(uint16_t* x,int* hmoved, int* hinverted) {
-    if ((GPIOB->IDR & (1 << 5))==0) { // Check if the left button is pressed
-        if (*x > 10) { // Ensure the player doesn't move out of the screen bounds
-            *x = (*x - 1); // Move the player to the left
-            *hmoved = 1; // Flag to indicate horizontal movement
-            *hinverted = 1; // Flag to manage sprite inversion (flipping)
-        }                        
+// Checks if the knight at x,y touches the 12x16 sprite at o
+static int touching(const Waypoint *o, uint16_t x, uint16_t y)
+{
+	return isInside(o->x,o->y,12,16,x,y) || isInside(o->x,o->y,12,16,x+12,y) || isInside(o->x,o->y,12,16,x,y+16) || isInside(o->x,o->y,12,16,x+12,y+16);
+}
+
+static void countdown_tick(void)
+{
+	if (timer > 0)
+		timer--;
+}
+
+// The knight has been hit: take a heart and put him down where he is
+static void knight_hit(uint32_t now)
+{
+	music_stop();
+	heart_gone++;
+	hud_icons_set(&hearts_bar,heart_gone);
+	knight_state = KNIGHT_DOWN;
+	knight_since = now;
+}
+
+// Send him back to a spawn point, the old spot is cleared when he is next drawn
+static void level_respawn(uint32_t now)
+{
+	const Waypoint *spawn = &layout->spawn[rng_range(0,LEVEL_SPAWNS)];
+
+	player_x = spawn->x;
+	player_y = spawn->y;
+	knight_dirty = 1;
+	knight_state = KNIGHT_SHIELDED;
+	knight_since = now;
+	music_resume();
+}
+
+// Works out whether he shows this frame, blinking while down or shielded
+static void knight_blink(uint32_t now)
+{
+	knight_visible = (knight_state == KNIGHT_ALIVE) || ((now - knight_since) & KNIGHT_BLINK_MS) == 0;
+	if (knight_visible != knight_shown)
+		knight_dirty = 1;
+}
+
+// The intro plays out over a few seconds, one line at a time
+static const struct
+{
+    uint16_t at_ms; // time since the intro started
+    const char *text; // 0 clears the screen
+    uint8_t x, y;
+} intro_steps[] =
+{
+    {0, "Denis", 20, 30},
+    {1000, "and", 40, 60},
+    {2000, "Cillian", 20, 90},
+    {3000, "Presents", 20, 120},
+    {3500, 0, 0, 0},
+    {4000, "Key", 30, 20},
+    {5000, "Quest", 30, 50},
+    {6000, "", 0, 0}, // the arrow to carry on
+};
+#define INTRO_STEPS (sizeof(intro_steps) / sizeof(intro_steps[0]))
+static uint32_t intro_start = 0;
+static unsigned int intro_shown = 0; // steps already drawn
+static unsigned int intro_due = 0; // steps whose time has come
+
+static void intro_update(uint32_t now) {
+    if (intro_due == 0 && intro_shown == 0)
+        intro_start = now;
+    while (intro_due < INTRO_STEPS && (now - intro_start) >= intro_steps[intro_due].at_ms)
+        intro_due++;
+    // Only once the arrow is up does the 'down' button move on
+    if (intro_shown == INTRO_STEPS && (buttons_pressed & BUTTON_UP)) {
+        // The first game goes straight to picking a difficulty
+        scene_change(&difficulty_scene);
     }
 }
 
-// Function for handling up button press. Moves the player up.
-void UpButtonPressed(uint16_t* y,int* vmoved, int* vinverted) {
-    if ((GPIOA->IDR & (1 << 11)) == 0) { // Check if the up button is pressed
-        if (*y < 140) { // Ensure the player doesn't move out of the screen bounds
-            *y = (*y + 1); // Move the player up
-            *vmoved = 1; // Flag to indicate vertical movement
-            *vinverted = 0; // Flag to manage sprite inversion (unused in vertical movement)
+static void intro_render(void) {
+    // The clear between the credits and the title is spread over frames the same way
+    // as a scene change, nothing more is drawn until it is done
+    if (!transition_step())
+        return;
+    while (intro_shown < intro_due) {
+        if (intro_steps[intro_shown].text == 0) {
+            transition_start(TRANSITION_WIPE, COLOUR_BLACK);
+        } else if (intro_steps[intro_shown].text[0] == 0) {
+            // Display a directional indicator for the user to proceed from the intro
+            printText("|", 110, 130, COLOUR_WHITE, 0);
+            printText("V", 110, 140, COLOUR_WHITE, 0);
+            boot_set_intro_seen();
+            boot_mark(BOOT_INTERACTIVE);
+        } else {
+            printTextX2(intro_steps[intro_shown].text, intro_steps[intro_shown].x, intro_steps[intro_shown].y, COLOUR_WHITE, 0);
         }
+        intro_shown++;
+        if (!transition_step())
+            return;
     }
 }
 
-// Function for handling down button press. Moves the player down.
-void DownButtonPressed(uint16_t* y,int* vmoved, int* vinverted) {
-    if ((GPIOA->IDR & (1 << 8)) == 0) { // Check if the down button is pressed
-        if (*y > 32) { // Ensure the player doesn't move out of the screen bounds
-            *y = (*y - 1); // Move the player down
-            *vmoved = 1; // Flag to indicate vertical movement
-            *vinverted = 1; // Flag to manage sprite inversion (unused in vertical movement)
+// Function to display the main menu of the game
+static int menu_reported = 0;
+static void menu_enter(void) {
+    // Display the game title "Key Quest" on the screen
+    printTextX2("Key", 30, 20, COLOUR_WHITE, 0);
+    printTextX2("Quest", 30, 50, COLOUR_WHITE, 0);
+
+    // Display a directional indicator for the user to start the game
+    printText("|", 110, 130, COLOUR_WHITE, 0);
+    printText("V", 110, 140, COLOUR_WHITE, 0);
+    boot_mark(BOOT_INTERACTIVE);
+
+    // Loop through the badges array to display the trophies earned
+    for (int i = 0; i < BADGES_AMOUNT; i++) {
+        if (badges[i] == 1) { // Easy skull trophy
+            putImage(5, 130, 12, 16, SPRITE(SPRITE_EASY_SKULL), 0, 0);
+        }
+        if (badges[i] == 2) { // Normal skull trophy
+            putImage(25, 130, 12, 16, SPRITE(SPRITE_NORMAL_SKULL), 0, 0);
+        }
+        if (badges[i] == 3) { // Hard skull trophy
+            putImage(45, 130, 12, 16, SPRITE(SPRITE_HARD_SKULL), 0, 0);
+        }
+        if (badges[i] == 4) { // Nightmare skull trophy
+            putImage(65, 130, 12, 16, SPRITE(SPRITE_NIGHTMARE_SKULL), 0, 0);
         }
     }
+    menu_reported = 0;
 }
 
-// Starts and handles the logic for Level 1 of the game
-int Level1_Start(uint16_t x, uint16_t y,uint16_t oldx, uint16_t oldy,uint16_t *px,uint16_t *py,int hearts_used,int difficulty)
-{
-    // Define various logs for different events in the level
-    char level1_started_log[] = "Level 1 Started!";
-    char level1_complete_log[] = "Level 1 Complete!";
-    char key_pickup_log[] = "Key Found";
-    char died_spike_log[] = "Player died to spike";
+static void menu_update(uint32_t now) {
+    if (menu_reported == 0) {
+        // Reports on the game just played, sent once the menu is up so the serial
+        // output doesn't count against the transition
+        power_report();
+        PROFILE_DUMP(); // Where the frame time went during the last game
+        SAMPLER_DUMP();
+        scene_report();
+        camera_report();
+        stack_report();
+        menu_reported = 1;
+    }
+    if (buttons_pressed & BUTTON_UP) { // Check if 'down' button is pressed
+        scene_change(&difficulty_scene);
+    }
+}
 
-    static int start_game = 0; // Flag to check if the game has started
-    static int heart_gone = 0; // Counter for the number of lost hearts
-    static int key_pickup = 0; // Flag to check if the key has been picked up
-
-    // Arrays to store the positions of hearts and key on the screen
-    int heart_location_x[3] = {85,100,115};
-    int heart_location_y[3] = {6,6,6};
-    char num_of_hearts[NUM_OF_CHAR]; // Buffer to store number of hearts as a string
-    int player_location_x[NUM_OF_RANDOM_LOCATIONS] = {53,100}; // Initial player positions
-    int player_location_y[NUM_OF_RANDOM_LOCATIONS] = {125,80};
-    uint32_t random_location_picker = random(0,1); // Randomly pick a starting location
-
-    // Key pickup and door position information
-    int pickup_key_location_x[3] = {10,20,100};
-    int pickup_key_location_y[3] = {35,130,50};
-    int key_location_x[NUM_OF_KEYS_1_DISPLAYED] = {5};
-    int key_location_y[NUM_OF_KEYS_1_DISPLAYED] = {6};
-    char key_display[NUM_OF_CHAR]; // Buffer for displaying key count
-
-    // Spike position information
-    int spike_location_x = 10;
-    int spike_location_y = 60;
-
-    // Door position information
-    int door_location_x = 115;
-    int door_location_y = 90;
-
-    // Array containing the musical notes for level 1
-    int notes[LEVEL_1_MUSIC] = {C4,D4,E4,G4,E4,D4,C4,G4,E4,C4};
-
-    // More detailed logic goes here...
-    // This includes rendering the level layout, handling player movements and interactions
-    // Checking conditions for level completion, key pickups, and updating the player's health status
-
-    // Return an integer to indicate the completion or continuation of the level
-	while (start_game == 0)
-	{
-		delay(100);
-		printTextX2("Level 1", 25, 20, RGBToWord(255,255,255), 0);
-		printText("Difficulty ", 10, 50, RGBToWord(255,255,255), 0);
-		Difficulty_Display(difficulty);
-		printText("Collect ", 15, 65, RGBToWord(255,255,255), 0);
-		sprintf(key_display,"%d",NUMOF_KEYS_1);
-		printText(key_display,70,65,RGBToWord(255,255,255),0);
-		putImage(80,60,12,16,key,0,0);
-		sprintf(num_of_hearts,"%d",hearts_used);
-		printText(num_of_hearts,20,80,RGBToWord(255,255,255),0);
-		putImage(30,75,12,16,heart,0,0);
-		printText("Beware of:",15,100,RGBToWord(255,255,255),0);
-
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(90,95,12,16,nightmare_spike,0,0);
-		}
-		else
-		{
-			putImage(90,95,12,16,spike,0,0);
-		}
-		printText("<-- AND -->", 20, 120, RGBToWord(255,255,255), 0);
-
-		if ((GPIOB->IDR & (1 << 4)) == 0 && (GPIOB->IDR & (1 << 5)) == 0) // right pressed
-		{	
-			start_game = 1;		
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-
-			while (!(GPIOB->IDR & (1 << 4))&& !(GPIOB->IDR & (1 << 5)))
-			{
-				seed++;
-			}
-			
-
-			while (1)
-			{
-				// Display the Keys
-				for (int i = 0; i < NUM_OF_KEYS_1_DISPLAYED; i++)
-				{
-					putImage(key_location_x[i],key_location_y[i],12,16,key,0,0);
-				}
-				
-				// Display the hearts
-				for (int i = 0; i < hearts_used; i++)
-				{
-					if (difficulty == DIFFICULTY_AMOUNT)
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,nightmare_heart,0,0);
-					}
-					else
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,heart,0,0);
-					}
-				}
-
-				fillRectangle(2,25,168,1,RGBToWord(255,255,255));
-
-				for (int i = 0; i < NUMOF_KEYS_1; i++)
-				{
-					putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,key,0,0);
-				}
-				putImage(x,y,12,16,knight_animation1,0,0);
-				// We turn red off since we are in a level now. 
-				RedOff();
-				// Green LED tells you the game is running and we are in a level.
-				GreenOn();
-				serial_log(level1_started_log);
-				break;
-			}							
-		}
-	}
-	if (difficulty == DIFFICULTY_AMOUNT)
-	{
-		if (timer < 10)
-		{
-			fillRectangle(55,12,12,12,RGBToWord(0,0,0));
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,0,0),0);
-		}
-		else
-		{
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,255,255),0);
-		}
-		if (max_time <= 0)
-		{
-			start_game = 0;
-			heart_gone = 0;
-			key_pickup = 0;
-			return 1;
-		}
-		if (milliseconds_timer >= 1000)
-		{
-			max_time = max_time - 1000;
-			milliseconds_timer = 0;
-			timer--;
-		}
-		milliseconds_timer++;
-	}
-	if (music_flag == 0)
-	{
-		play_music(notes,LEVEL_1_MUSIC);
-	}
-	// Check if Player can go through door and finish level.
-	if (isInside(door_location_x,door_location_y,12,16,x,y) || isInside(door_location_x,door_location_y,12,16,x+12,y) || isInside(door_location_x,door_location_y,12,16,x,y+16) || isInside(door_location_x,door_location_y,12,16,x+12,y+16))
+// Lets the player pick the game's difficulty and with it the number of hearts (lives)
+static void difficulty_enter(void) {
+    difficulty = 0;
+
+    // Display difficulty level options
+    printTextX2("Difficulty", 5, 5, COLOUR_WHITE, 0); // Display the text "Difficulty"
+    printTextX2("Easy", 40, 25, COLOUR_GREEN, 0); // Display the text "Easy" in green
+    putImage(99, 25, 12, 16, SPRITE(SPRITE_EASY_SKULL), 0, 0); // Display the Easy Mode Skull image
+
+    // Display hearts for Easy mode
+    for (int i = 0; i < 3; i++) {
+        putImage(42 + 15 * i, 40, 12, 16, SPRITE(SPRITE_HEART), 0, 0); // Display four heart images
+    }
+    printText("<--", 53, 58, COLOUR_WHITE, 0); // Display left arrow for selection
+
+    // Repeat similar process for Normal and Hard modes
+    printTextX2("Normal", 30, 65, COLOUR_ORANGE, 0); // Normal mode in orange
+    putImage(100, 65, 12, 16, SPRITE(SPRITE_NORMAL_SKULL), 0, 0); // Normal Mode Skull image
+    for (int i = 0; i < 2; i++) {
+        putImage(50 + 15 * i, 80, 12, 16, SPRITE(SPRITE_HEART), 0, 0); // Display two heart images
+    }
+    printText("^", 60, 100, COLOUR_WHITE, 0); // Display up arrow for selection
+	printText("|", 60, 105, COLOUR_WHITE, 0); // Displays the pipe for selection 
+    printTextX2("Hard", 40, 115, COLOUR_RED, 0); // Hard mode in red
+    putImage(100, 115, 12, 16, SPRITE(SPRITE_HARD_SKULL), 0, 0); // Hard Mode Skull image
+    putImage(58, 130, 12, 16, SPRITE(SPRITE_HEART), 0, 0); // Display one heart image
+    printText("-->", 55, 148, COLOUR_WHITE, 0); // Display right arrow for selection
+}
+
+static void difficulty_update(uint32_t now) {
+    if (buttons_pressed & BUTTON_LEFT) { // If left button pressed, choose Easy
+        difficulty = 1;
+        num_of_hearts = 3;
+    } else if (buttons_pressed & BUTTON_DOWN) { // If up button pressed, choose Normal
+        difficulty = 2;
+        num_of_hearts = 2;
+    } else if (buttons_pressed & BUTTON_RIGHT) { // If right button pressed, choose Hard
+        difficulty = 3;
+        num_of_hearts = 1;
+    } else {
+        return;
+    }
+    // Hard can be turned into Nightmare once it has been unlocked
+    if (difficulty == 3 && nightmare_enabled == 1)
+        scene_change(&nightmare_scene);
+    else
+        scene_change(&card_scene);
+}
+
+// Offers the 'Nightmare' difficulty to a player who picked Hard
+static void nightmare_enter(void) {
+    // Displaying the difficulty settings on the screen
+    printTextX2("Difficulty", 10, 20, COLOUR_WHITE, 0);
+    printTextX2("Nightmare", 15, 40, COLOUR_PURPLE, 0);
+    
+    // Display a skull image as a symbol for the Nightmare difficulty
+    putImage(58, 60, 12, 16, SPRITE(SPRITE_NIGHTMARE_SKULL), 0, 0);
+    // Displaying features of Nightmare difficulty - Stronger enemies, 1 minute timer, etc.
+    printText("Stronger Enemies", 15, 80, COLOUR_WHITE, 0);
+    printText("1 Minute Timer", 25, 90, COLOUR_WHITE, 0);
+    printText("1", 60, 105, COLOUR_WHITE, 0);
+    putImage(70, 98, 12, 16, SPRITE(SPRITE_NIGHTMARE_HEART), 0, 0);
+
+    // Options to accept or reject the Nightmare difficulty
+    printText("|", 115, 120, COLOUR_WHITE, 0);
+    printText("V", 115, 130, COLOUR_WHITE, 0);
+    printText("Yes", 105, 140, COLOUR_WHITE, 0);
+    printText("^", 10, 125, COLOUR_WHITE, 0);
+    printText("|", 10, 130, COLOUR_WHITE, 0);
+    printText("No", 5, 140, COLOUR_WHITE, 0);
+}
+
+static void nightmare_update(uint32_t now) {
+    if (buttons_pressed & BUTTON_UP) { // If 'down' button is pressed
+        difficulty = DIFFICULTY_AMOUNT; // Set difficulty to Nightmare
+        num_of_hearts = 1; // Set the number of hearts used
+        scene_change(&card_scene);
+    } else if (buttons_pressed & BUTTON_DOWN) { // If 'up' button is pressed, stay on Hard
+        scene_change(&card_scene);
+    }
+}
+
+// The level's intro card, waits for both buttons to be pressed and released
+static void card_enter(void) {
+    char title[] = "Level 1";
+    char number[HUD_MAX_DIGITS + 1]; // Buffer for the counts on the intro card
+    const LevelLayout *fixed = &level_layouts[current_level - 1];
+
+    title[6] = '0' + current_level;
+    layout = fixed;
+    seed_held = 0;
+	printTextX2(title, 25, 20, COLOUR_WHITE, 0);
+	printText("Difficulty ", 10, 50, COLOUR_WHITE, 0);
+	Difficulty_Display(difficulty);
+	printText("Collect ", 15, 65, COLOUR_WHITE, 0);
+	fmt_uint(number,fixed->num_keys);
+	printText(number,70,65,COLOUR_WHITE,0);
+	putImage(80,60,12,16,SPRITE(SPRITE_KEY),0,0);
+	fmt_uint(number,num_of_hearts);
+	printText(number,20,80,COLOUR_WHITE,0);
+	putImage(30,75,12,16,SPRITE(SPRITE_HEART),0,0);
+	printText("Beware of:",15,100,COLOUR_WHITE,0);
+	putImage(90,95,12,16,(difficulty == DIFFICULTY_AMOUNT) ? SPRITE(SPRITE_NIGHTMARE_SPIKE) : SPRITE(SPRITE_SPIKE),0,0);
+	if (fixed->num_enemies > 0)
 	{
-		// Checks if all keys have been obtained 
-		if (key_pickup == NUMOF_KEYS_1)
-		{
-			// We turn Green off since we are not in a level now. 
-			GreenOff();
-			// Red LED tells you the game is running and we are not in a level.
-			RedOn();
-			playNote(0);
-			music_flag = 1;
-			int tmp = hearts_used - heart_gone;
-			char currentHeart[NUM_OF_CHAR];
-			sprintf(currentHeart,"%d",tmp);
-
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-			printTextX2("Level 1", 25, 20, RGBToWord(255,255,255), 0);
-			printTextX2("Complete!", 15, 40, RGBToWord(255,255,255), 0);
-			printText("Hearts Left", 5, 70, RGBToWord(255,255,255), 0);
-			printText(currentHeart,88,70,RGBToWord(255,255,255),0);
-			putImage(100,63,12,16,heart,0,0);
-			printText("<--", 5, 90, RGBToWord(255,255,255), 0);
-			serial_log(level1_complete_log);
-			while (1)
-			{
-				if ((GPIOB->IDR & (1 << 5))==0) // left pressed
-				{
-					start_game = 0;
-					heart_gone = 0;
-					key_pickup = 0;
-					start_movement = 0;
-					fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-					break;
-				}
-			}
-			// Move onto the next level
-			current_level++;
-			// Clear the current screen
-		}
+		putImage(110,95,12,16,(difficulty == DIFFICULTY_AMOUNT) ? SPRITE(SPRITE_NIGHT_SKELETON_RUN) : SPRITE(SPRITE_SKELETON_RUN),0,0);
 	}
-	// Key pickup check
-	if (key_pickup == 0)
+	printText("<-- AND -->", 20, 120, COLOUR_WHITE, 0);
+}
+
+static void card_update(uint32_t now) {
+	if ((buttons_held & (BUTTON_LEFT | BUTTON_RIGHT)) == (BUTTON_LEFT | BUTTON_RIGHT))
 	{
-		for (int i = 0; i < NUMOF_KEYS_1; i++)
-		{
-			if (isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16))
-			{
-				putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-				putImage(key_location_x[key_pickup],key_location_y[key_pickup],12,16,taken_key,0,0);
-				key_pickup++;
-				serial_log(key_pickup_log);
-			}
-		}	
+		// How long the buttons are held, and where SysTick had got to each frame,
+		// is our entropy
+		seed += 1 + SysTick->VAL;
+		seed_held = 1;
 	}
-	else
+	else if (seed_held)
 	{
-		if (key_pickup >= 1)
-		{
-			for (int i = 0; i < NUMOF_KEYS_1; i++)
-			{
-				if (!(isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16)))
-				{
-					putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-				}
-			}
-		}
+		scene_change(&level_scene);
 	}
-	// Draws the spike
+}
+
+// Sets the level up from its layout and draws it
+static void level_enter(void)
+{
+    char started_log[] = "Level 1 Started!";
+    const LevelLayout *fixed = &level_layouts[current_level - 1];
+
+    started_log[6] = '0' + current_level;
+	// Seed the generator with what the card gathered
+	initprbs(seed);
+	// Nightmare never plays the same level twice, build one from the seed with the usual counts
 	if (difficulty == DIFFICULTY_AMOUNT)
 	{
-		putImage(spike_location_x,spike_location_y,12,16,nightmare_spike,0,0);
+		levelgen_generate(seed + current_level, fixed->num_keys, fixed->num_spikes, fixed->num_enemies, &nightmare_layout);
+		layout = &nightmare_layout;
 	}
-	else
+	heart_gone = 0;
+	amount_keys = 0;
+	for (int i = 0; i < LEVEL_MAX_KEYS; i++)
 	{
-		putImage(spike_location_x,spike_location_y,12,16,spike,0,0);
+		key_pickup[i] = 0;
 	}
 
-	// Draws the Door
-	putImage(door_location_x,door_location_y,12,16,door,0,0);
-
-	// Detects if user hit the spike 
-	if ((isInside(spike_location_x,spike_location_y,12,16,x,y) || isInside(spike_location_x,spike_location_y,12,16,x+12,y) || isInside(spike_location_x,spike_location_y,12,16,x,y+16) || isInside(spike_location_x,spike_location_y,12,16,x+12,y+16)))
+	// Spikes block the skeletons' view of the knight
+	enemy_world_init(&enemy_world,milliseconds_uptime);
+	for (int i = 0; i < layout->num_spikes; i++)
 	{
-		serial_log(died_spike_log);
-		playNote(0);
-		music_flag = 1;
-		// The player has been hit so we automatically punish him by setting him back to the original positoon.
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(spike_location_x,spike_location_y,12,16,nightmare_spike,0,0);
-		}
-		else
-		{
-			putImage(spike_location_x,spike_location_y,12,16,spike,0,0);
-		}
-		// Delete current positoon of player
-		fillRectangle(x,y,12,16,RGBToWord(0,0,0));
-		// Respawn the player back at the Original Position.
-		*px = player_location_x[random_location_picker];
-		*py = player_location_y[random_location_picker];
-		
-		// Player loses a heart.
-		putImage(heart_location_x[heart_gone],heart_location_y[heart_gone],12,16,hearts_empty,0,0);
-		heart_gone++;
-		delay(1500);
-		putImage(*px,*py,12,16,knight_animation1,0,0);
-		music_flag = 0;
-	}	
-	if (heart_gone == hearts_used)
+		grid_block(&enemy_world.grid,layout->spikes[i].x,layout->spikes[i].y,12,16);
+	}
+	// Skeletons chase the knight when they can see him close by, on Nightmare only
+	for (int i = 0; i < layout->num_enemies; i++)
 	{
-		start_game = 0;
-		heart_gone = 0;
-		key_pickup = 0;
-		return 1;
+		enemy_init(&skeletons[i],layout->patrol[i],layout->patrol_len[i],difficulty);
 	}
+
+	// Display the Keys and hearts
+	hud_icons_init(&keys_bar,5,6,15,layout->num_keys,SPRITE(SPRITE_KEY),SPRITE(SPRITE_TAKEN_KEY));
+	hud_icons_set(&keys_bar,0);
+	hud_icons_init(&hearts_bar,85,6,15,num_of_hearts,(difficulty == DIFFICULTY_AMOUNT) ? SPRITE(SPRITE_NIGHTMARE_HEART) : SPRITE(SPRITE_HEART),SPRITE(SPRITE_HEART_EMPTY));
+	hud_icons_set(&hearts_bar,0);
+	hud_counter_init(&timer_counter,55,12,2);
+
+	fillRectangle(2,25,168,1,COLOUR_WHITE);
+
+	// New Character position, the camera starts on it
+	const Waypoint *spawn = &layout->spawn[rng_range(0,LEVEL_SPAWNS)];
+	player_x = oldx = spawn->x;
+	player_y = oldy = spawn->y;
+	knight_state = KNIGHT_ALIVE;
+	knight_visible = knight_shown = 1;
+	knight_dirty = 0;
+	camera_init(layout->width,layout->height,player_x,player_y,level_redraw);
+	motion_init(&knight,player_x,player_y);
+	motion_set_area(&knight,layout->width ? layout->width : 128,layout->height ? layout->height : 160);
+	last_frame = milliseconds_uptime;
+	knight_anim.clip = 0;
+	anim_play(&knight_anim,&knight_walk,last_frame);
+	if (difficulty == DIFFICULTY_AMOUNT)
+		enemy_set_clips(&night_skeleton_running,&night_skeleton_attack);
+	else
+		enemy_set_clips(&skeleton_running,&skeleton_attack);
+	level_draw_sprites();
+	music_start(level_notes[current_level - 1],level_notes_len[current_level - 1]);
+	if (difficulty == DIFFICULTY_AMOUNT)
+		timer_start(&countdown_timer,1000,1000,countdown_tick);
+	// We turn red off since we are in a level now. 
+	RedOff();
+	// Green LED tells you the game is running and we are in a level.
+	GreenOn();
+	serial_log(started_log);
 }
 
-// Starts and handles the logic for Level 2 of the game
-int Level2_Start(uint16_t x, uint16_t y, uint16_t oldx, uint16_t oldy, uint16_t *px, uint16_t *py, int hearts_used, int difficulty) {
-    // Logging and status variables for different events in the level
-    char level2_started_log[] = "Level 2 Started!";
-    char level2_complete_log[] = "Level 2 Complete!";
+// Game logic for one frame of a level
+static void level_update(uint32_t now)
+{
     char died_spike_log[] = "Player died to spike";
     char died_skeleton_log[] = "Player died to skeleton";
     char key_pickup_log[] = "Key Found";
+    uint16_t x = player_x, y = player_y;
+    int xdir = 0, ydir = 0; // Direction requested by the buttons this frame
 
-    static int start_game = 0; // Flag to manage the start status of the game
-    static int clear_screen = 0; // Flag to determine if the screen should be cleared
-    static int heart_gone = 0; // Track the number of hearts lost
-    static int key_pickup[NUMOF_KEYS_2] = {0, 0}; // Track if keys have been picked up
-    static int amount_keys = 0; // Total number of keys picked up
-
-    // Arrays for storing positions of hearts, keys, and player's spawn points
-    int heart_location_x[3] = {85, 100, 115};
-    int heart_location_y[3] = {6, 6, 6};
-    char num_of_hearts[NUM_OF_CHAR]; // Buffer to store number of hearts as a string
-    int player_location_x[NUM_OF_RANDOM_LOCATIONS] = {5, 80}; // Player spawn points
-    int player_location_y[NUM_OF_RANDOM_LOCATIONS] = {125, 120};
-    uint32_t random_location_picker = random(0, 1); // Randomly picking a starting location
-
-    // Key pickup locations
-    int pickup_key_location_x[NUMOF_KEYS_2] = {10, 100};
-    int pickup_key_location_y[NUMOF_KEYS_2] = {35, 35};
-    int key_location_x[NUM_OF_KEYS_2_DISPLAYED] = {5, 20};
-    int key_location_y[NUM_OF_KEYS_2_DISPLAYED] = {6, 6};
-    char key_display[NUM_OF_CHAR]; // Buffer for displaying key count
-
-    // Spike locations
-    int spike_location_x[NUMOF_SPIKES_2] = {10, 90};
-    int spike_location_y[NUMOF_SPIKES_2] = {55, 37};
-
-    // Enemy (skeleton) positions
-    int enemy_x_left = 30;
-    int enemy_x_right = 115;
-    static int enemy_current_pos_x = 75;
-    static int enemy_current_pos_y = 65;
-    static int toggle = 0; // Toggle for enemy movement direction
-
-    // Door position
-    int door_location_x = 115;
-    int door_location_y = 130;
-
-    // Array containing the musical notes for level 2
-    int notes[LEVEL_2_MUSIC] = {G4, B4, D5, G5, D5, B4, G4, A4, B4, G4, B4, D5, G5, D5, B4, G4};
-
-    // Rest of the function contains the game logic for Level 2
-    // Similar to Level 1 but with additional challenges like more keys, spikes, and an enemy (skeleton)
-    // This includes rendering the level, handling player movements and interactions
-    // Checking conditions for level completion, key pickups, and updating the player's health status
-
-    // Return an integer to indicate the completion or continuation of the level
-
-
-	while (clear_screen == 0)
-	{
-		fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-		// New Character positions
-		*px = player_location_x[random_location_picker];
-		*py = player_location_y[random_location_picker];
-		clear_screen++;
-	}
-
-	while (start_game == 0)
+	WATCHDOG_ZONE_ENTER(PROF_LEVEL);
+	PROFILE_BEGIN(PROF_LEVEL);
+	if (difficulty == DIFFICULTY_AMOUNT)
 	{
-		printTextX2("Level 2", 25, 20, RGBToWord(255,255,255), 0);
-		printText("Difficulty ", 10, 50, RGBToWord(255,255,255), 0);
-		Difficulty_Display(difficulty);
-		printText("Collect ", 15, 65, RGBToWord(255,255,255), 0);
-		sprintf(key_display,"%d",NUMOF_KEYS_2);
-		printText(key_display,70,65,RGBToWord(255,255,255),0);
-		putImage(80,60,12,16,key,0,0);
-		sprintf(num_of_hearts,"%d",hearts_used);
-		printText(num_of_hearts,20,80,RGBToWord(255,255,255),0);
-		putImage(30,75,12,16,heart,0,0);
-		printText("Beware of:",15,100,RGBToWord(255,255,255),0);
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(90,95,12,16,nightmare_spike,0,0);
-			putImage(110,95,12,16,night_skeleton_run,0,0);
-		}
-		else
+		// Only the digits that changed are redrawn, the last ten seconds go red
+		int left = timer;
+		hud_counter_set(&timer_counter,(left > 0) ? left : 0,(left < 10) ? COLOUR_RED : COLOUR_WHITE);
+		if (left <= 0)
 		{
-			putImage(90,95,12,16,spike,0,0);
-			putImage(110,95,12,16,skeleton_run,0,0);
-		}
-		printText("<-- AND -->", 20, 120, RGBToWord(255,255,255), 0);
-
-		if ((GPIOB->IDR & (1 << 4)) == 0 && (GPIOB->IDR & (1 << 5)) == 0) // right pressed
-		{	
-			start_game = 1;		
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-			while (1)
-			{
-				// Display the Keys
-				for (int i = 0; i < NUM_OF_KEYS_2_DISPLAYED; i++)
-				{
-					putImage(key_location_x[i],key_location_y[i],12,16,key,0,0);
-				}
-				
-				// Display the hearts
-				for (int i = 0; i < hearts_used; i++)
-				{
-					if (difficulty == DIFFICULTY_AMOUNT)
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,nightmare_heart,0,0);					
-					}
-					else
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,heart,0,0);
-					}
-				}
-
-				fillRectangle(2,25,168,1,RGBToWord(255,255,255));
-
-				for (int i = 0; i < NUMOF_KEYS_2; i++)
-				{
-					putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,key,0,0);
-				}
-				music_flag = 0;
-				// We turn red off since we are in a level now. 
-				RedOff();
-				// Green LED tells you the game is running and we are in a level.
-				GreenOn();
-				serial_log(level2_started_log);
-				break;
-			}							
+			scene_change(&gameover_scene);
+			PROFILE_END(PROF_LEVEL);
+			WATCHDOG_ZONE_LEAVE(PROF_LEVEL);
+			return;
 		}
 	}
-	if (difficulty == DIFFICULTY_AMOUNT)
+	// Move on through a death once the current part of it is over
+	if (knight_state == KNIGHT_DOWN && TIME_REACHED(now, knight_since + KNIGHT_DOWN_MS))
 	{
-		if (timer < 10)
-		{
-			fillRectangle(55,12,12,12,RGBToWord(0,0,0));
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,0,0),0);
-		}
-		else
+		if (heart_gone >= num_of_hearts)
 		{
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,255,255),0);
+			scene_change(&gameover_scene);
+			PROFILE_END(PROF_LEVEL);
+			WATCHDOG_ZONE_LEAVE(PROF_LEVEL);
+			return;
 		}
-		if (max_time <= 0)
-		{
-			start_game = 0;
-			heart_gone = 0;
-			for (int i = 0; i < NUMOF_KEYS_2; i++)
-			{
-				key_pickup[i] = 0;
-			}
-			return 1;
-		}
-		if (milliseconds_timer >= 1000)
-		{
-			max_time = max_time - 1000;
-			milliseconds_timer = 0;
-			timer--;
-		}
-		milliseconds_timer++;
+		level_respawn(now);
+		x = player_x;
+		y = player_y;
 	}
-	if (music_flag == 0)
+	else if (knight_state == KNIGHT_SHIELDED && TIME_REACHED(now, knight_since + KNIGHT_SHIELD_MS))
 	{
-		play_music(notes,LEVEL_2_MUSIC);
+		knight_state = KNIGHT_ALIVE;
 	}
-
-	// Check if Player can go through door and finish level.
-	if (isInside(door_location_x,door_location_y,12,16,x,y) || isInside(door_location_x,door_location_y,12,16,x+12,y) || isInside(door_location_x,door_location_y,12,16,x,y+16) || isInside(door_location_x,door_location_y,12,16,x+12,y+16))
+	// Check if Player can go through door and finish level, once all keys have been obtained
+	if (knight_state != KNIGHT_DOWN && touching(&layout->door,x,y) && amount_keys == layout->num_keys)
 	{
-		// Checks if all keys have been obtained 
-		if (amount_keys == NUMOF_KEYS_2)
-		{
-			// We turn Green off since we are not in a level now. 
-			GreenOff();
-			// Red LED tells you the game is running and we are not in a level.
-			RedOn();
-			serial_log(level2_complete_log);
-			playNote(0);
-			music_flag = 1;
-			int tmp = hearts_used - heart_gone;
-			char currentHeart[NUM_OF_CHAR];
-			sprintf(currentHeart,"%d",tmp);
-
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-			printTextX2("Level 2", 25, 20, RGBToWord(255,255,255), 0);
-			printTextX2("Complete!", 15, 40, RGBToWord(255,255,255), 0);
-			printText("Hearts Left", 5, 70, RGBToWord(255,255,255), 0);
-			printText(currentHeart,88,70,RGBToWord(255,255,255),0);
-			putImage(100,63,12,16,heart,0,0);
-			printText("<--", 5, 90, RGBToWord(255,255,255), 0);
-			while (1)
-			{
-				if ((GPIOB->IDR & (1 << 5))==0) // left pressed
-				{
-					start_game = 0;
-					clear_screen = 0;
-					heart_gone = 0;
-					amount_keys = 0;
-					enemy_current_pos_x = 75;
-					enemy_current_pos_y = 65;
-					toggle = 0;
-					for (int i = 0; i < NUMOF_KEYS_2; i++)
-					{
-						key_pickup[i] = 0;
-					}
-					amount_keys = 0;
-					start_movement = 0;
-					music_flag = 0;
-					break;
-				}
-			}
-			// Move onto the next level
-			current_level++;
-			// Clear the current screen
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-		}
+		scene_change(&complete_scene);
+		PROFILE_END(PROF_LEVEL);
+		WATCHDOG_ZONE_LEAVE(PROF_LEVEL);
+		return;
 	}
 	// Key pickup check
-	for (int i = 0; i < NUMOF_KEYS_2; i++)
+	for (int i = 0; i < layout->num_keys && knight_state != KNIGHT_DOWN; i++)
 	{
-		if (key_pickup[i] == 0)
+		if (key_pickup[i] == 0 && touching(&layout->keys[i],x,y))
 		{
-			if (isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16))
-			{
-				putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-				putImage(key_location_x[amount_keys],key_location_y[amount_keys],12,16,taken_key,0,0);
-				key_pickup[i] = 1;
-				amount_keys++;
-				serial_log(key_pickup_log);
-			}
-		}
-		if (key_pickup[i] == 1)
-		{
-			if (!(isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16)))
-			{
-				putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-			}
+			camera_put_image(layout->keys[i].x,layout->keys[i].y,12,16,SPRITE(SPRITE_TAKEN_KEY),0,0);
+			key_pickup[i] = 1;
+			amount_keys++;
+			hud_icons_set(&keys_bar,amount_keys);
+			serial_log(key_pickup_log);
 		}
 	}
 
-	// Draws the Door
-	putImage(door_location_x,door_location_y,12,16,door,0,0);
-
-	// Draws the Enemy
-	if (enemy_current_pos_x != enemy_x_right && toggle == 0)
+	// Move the Enemies and see if any of them or the spikes got the player. They carry
+	// on whatever he is doing, but only hurt him while he is alive and unshielded.
+	enemies_update(&enemy_world,skeletons,layout->num_enemies,x,y,now);
+	for (int i = 0; i < layout->num_enemies && knight_state == KNIGHT_ALIVE; i++)
 	{
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_run,0,0);
-		}
-		else
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_run,0,0);
-		}
-		drawRectangle(enemy_current_pos_x,enemy_current_pos_y,12,16,RGBToWord(0,0,0));
-		enemy_current_pos_x++;
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_run,0,0);
-		}
-		else
+		// Check to see if the player is hit by the enemy 
+		if (enemy_hits(&skeletons[i],x,y))
 		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_run,0,0);
-		}
-	}
-	else
-	{
-		toggle = 1;
+			serial_log(died_skeleton_log);
+			enemy_attack(&skeletons[i],now);
+			knight_hit(now);
+		}	
 	}
-	if (enemy_current_pos_x != enemy_x_left && toggle == 1)
+	for (int i = 0; i < layout->num_spikes && knight_state == KNIGHT_ALIVE; i++)
 	{
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_run,1,0);
-		}
-		else
+		if (touching(&layout->spikes[i],x,y))
 		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_run,1,0);
-		}
-		drawRectangle(enemy_current_pos_x,enemy_current_pos_y,12,16,RGBToWord(0,0,0));
-		enemy_current_pos_x--;
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_run,1,0);
-		}
-		else
-		{
-			putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_run,1,0);
-		}
+			serial_log(died_spike_log);
+			knight_hit(now);
+		}	
 	}
-	else
+	if (knight_state == KNIGHT_DOWN)
 	{
-		toggle = 0; 
+		// No moving while he is down
+		last_frame = now;
+		anim_hold(&knight_anim,now);
+		knight_blink(now);
+		PROFILE_END(PROF_LEVEL);
+		WATCHDOG_ZONE_LEAVE(PROF_LEVEL);
+		return;
 	}
 
-	// Check to see if the player is hit by the enemy 
-	if ((isInside(enemy_current_pos_x,enemy_current_pos_y,12,16,x,y) || isInside(enemy_current_pos_x,enemy_current_pos_y,12,16,x+12,y) || isInside(enemy_current_pos_x,enemy_current_pos_y,12,16,x,y+16) || isInside(enemy_current_pos_x,enemy_current_pos_y,12,16,x+12,y+16)))
+	// Handle player movement and input
+	hmoved = vmoved = 0;
+	if (buttons_held & BUTTON_RIGHT) {
+		xdir++; // Request movement to the right
+		hinverted = 0; // Flag to manage sprite inversion (flipping)
+	}
+	if (buttons_held & BUTTON_LEFT) {
+		xdir--; // Request movement to the left
+		hinverted = 1;
+	}
+	if (buttons_held & BUTTON_UP) {
+		ydir++; // Request movement up
+		vinverted = 0;
+	}
+	if (buttons_held & BUTTON_DOWN) {
+		ydir--; // Request movement down
+		vinverted = 1;
+	}
+	// A respawn moves the player, pick up from there
+	if (x != motion_x(&knight) || y != motion_y(&knight)) {
+		motion_init(&knight, x, y);
+	}
+	motion_set_difficulty(&knight, difficulty);
+	// Move at a fixed speed in pixels per second however long the frame took
+	if (motion_update(&knight, xdir, ydir, now - last_frame)) {
+		hmoved = (motion_x(&knight) != x);
+		vmoved = (motion_y(&knight) != y);
+		player_x = motion_x(&knight);
+		player_y = motion_y(&knight);
+	}
+	last_frame = now;
+	// Walk when moving sideways and climb when moving up or down, the frames change on
+	// their own clock rather than once per frame
+	knight_dirty |= hmoved || vmoved;
+	if (hmoved)
+		knight_dirty |= anim_play(&knight_anim,&knight_walk,now) | anim_update(&knight_anim,now);
+	else if (vmoved)
+		knight_dirty |= anim_play(&knight_anim,&knight_climb,now) | anim_update(&knight_anim,now);
+	else
+		anim_hold(&knight_anim,now);
+	knight_blink(now);
+	PROFILE_END(PROF_LEVEL);
+	WATCHDOG_ZONE_LEAVE(PROF_LEVEL);
+}
+
+static void level_render(void)
+{
+	const uint16_t *spike_image = (difficulty == DIFFICULTY_AMOUNT) ? SPRITE(SPRITE_NIGHTMARE_SPIKE) : SPRITE(SPRITE_SPIKE);
+
+	// Scroll to keep up with the knight, only what came into view gets drawn
+	camera_follow(player_x,player_y);
+	camera_stream();
+	// Clearing the knight rubs out any skeleton standing on him, as one does when he is
+	// down and blinking under its attack, so have that redrawn too
+	if (knight_dirty)
 	{
-		serial_log(died_skeleton_log);
-		if (toggle == 1)
-		{
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_attack1,1,0);
-
-			}
-			else
-			{
-				putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_attack1,1,0);
-			}
-		}
-		else
+		const Waypoint at = {(uint8_t)oldx, (uint8_t)oldy};
+		for (int i = 0; i < layout->num_enemies; i++)
 		{
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,night_skeleton_attack1,0,0);
-
-			}
-			else
-			{
-				putImage(enemy_current_pos_x,enemy_current_pos_y,12,16,skeleton_attack1,0,0);
-			}
+			if (skeletons[i].drawn_x >= 0 && touching(&at,skeletons[i].drawn_x,skeletons[i].drawn_y))
+				skeletons[i].drawn_image = 0;
 		}
-		// The player has been hit so we automatically punish him by setting him back to the original positoon.
-		// Delete current positoon of player
-		fillRectangle(x,y,12,16,RGBToWord(0,0,0));
-
-		// Respawn the player back at the Original Position.
-		*px = player_location_x[random_location_picker];
-		*py = player_location_y[random_location_picker];
-		
-		playNote(0);
-		music_flag = 1;
-		// Player loses a heart.
-		putImage(heart_location_x[heart_gone],heart_location_y[heart_gone],12,16,hearts_empty,0,0);
-		heart_gone++;
-		delay(1500);
-		music_flag = 0;
-		putImage(*px,*py,12,16,knight_animation1,0,0);
-	}	
-	// Draws the spike
-	for (int i = 0; i < NUMOF_SPIKES_2; i++)
+	}
+	// Keys, the door and spikes never change, they are only drawn again where a moving
+	// sprite may have rubbed them out. Work that out before anything moves.
+	uint16_t dirty_keys = 0, dirty_spikes = 0;
+	int dirty_door = uncovered(&layout->door);
+	for (int i = 0; i < layout->num_keys; i++)
 	{
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(spike_location_x[i],spike_location_y[i],12,16,nightmare_spike,0,0);
-		}
-		else
-		{
-			putImage(spike_location_x[i],spike_location_y[i],12,16,spike,0,0);
-		}
-		if ((isInside(spike_location_x[i],spike_location_y[i],12,16,x,y) || isInside(spike_location_x[i],spike_location_y[i],12,16,x+12,y) || isInside(spike_location_x[i],spike_location_y[i],12,16,x,y+16) || isInside(spike_location_x[i],spike_location_y[i],12,16,x+12,y+16)))
-		{
-			serial_log(died_spike_log);
-			playNote(0);
-			// The player has been hit so we automatically punish him by setting him back to the original positoon.
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(spike_location_x[i],spike_location_y[i],12,16,nightmare_spike,0,0);
-			}
-			else
-			{
-				putImage(spike_location_x[i],spike_location_y[i],12,16,spike,0,0);
-			}
-			//putImage(spike_location_x[0],spike_location_y[0],12,16,spike_level1,0,0);
-			// Delete current positoon of player
-			fillRectangle(x,y,12,16,RGBToWord(0,0,0));
-			// Respawn the player back at the Original Position.
-			*px = 5;
-			*py = 125;
-			
-			// Player loses a heart.
-			putImage(heart_location_x[heart_gone],heart_location_y[heart_gone],12,16,hearts_empty,0,0);
-			heart_gone++;
-			delay(1500);
-			music_flag = 0;
-			putImage(*px,*py,12,16,knight_animation1,0,0);
-		}	
+		if (uncovered(&layout->keys[i]))
+			dirty_keys |= 1 << i;
 	}
-
-	if (heart_gone == hearts_used)
+	for (int i = 0; i < layout->num_spikes; i++)
 	{
-		start_game = 0;
-		clear_screen = 0;
-		heart_gone = 0;
-		for (int i = 0; i < NUMOF_KEYS_2; i++)
-		{
-			key_pickup[i] = 0;
-		}
-		amount_keys = 0;
-		enemy_current_pos_x = 75;
-		enemy_current_pos_y = 65;
-		toggle = 0;
-		return 1;
+		if (uncovered(&layout->spikes[i]))
+			dirty_spikes |= 1 << i;
 	}
-}
+	if (knight_dirty)
+		camera_fill(oldx, oldy, 12, 16, 0);
 
-// Function to start and handle Level 3 logic in the game
-int Level3_Start(uint16_t x, uint16_t y, uint16_t oldx, uint16_t oldy, uint16_t *px, uint16_t *py, int hearts_used, int difficulty) {
-    // Logging messages for different events within the level
-    char level3_started_log[] = "Level 3 Started!";
-    char level3_complete_log[] = "Level 3 Complete!";
-    char died_spike_log[] = "Player died to spike";
-    char died_skeleton_log[] = "Player died to skeleton";
-    char key_pickup_log[] = "Key Found";
-
-    static int start_game = 0; // Flag to check if the game level has started
-    static int clear_screen = 0; // Flag to determine if the screen needs clearing
-    static int key_pickup[NUMOF_KEYS_3] = {0, 0, 0}; // Array to track picked-up keys
-    static int amount_keys = 0; // Total number of keys picked up
-    static int heart_gone = 0; // Number of hearts lost
-
-    // Arrays for storing positions of hearts on the screen
-    int heart_location_x[3] = {85, 100, 115};
-    int heart_location_y[3] = {6, 6, 6};
-    char num_of_hearts[NUM_OF_CHAR]; // Buffer to store number of hearts as a string
-    int player_location_x[NUM_OF_RANDOM_LOCATIONS] = {110, 115}; // Player spawn points
-    int player_location_y[NUM_OF_RANDOM_LOCATIONS] = {40, 40};
-    uint32_t random_location_picker = random(0, 1); // Randomly picking a starting location
-
-    // Key pickup positions
-    int pickup_key_location_x[NUMOF_KEYS_3] = {5, 5, 90};
-    int pickup_key_location_y[NUMOF_KEYS_3] = {140, 95, 140};
-    int key_location_x[NUM_OF_KEYS_3_DISPLAYED] = {5, 20, 35};
-    int key_location_y[NUM_OF_KEYS_3_DISPLAYED] = {6, 6, 6};
-    char key_display[NUM_OF_CHAR]; // Buffer for displaying key count
-
-    // Spike positions
-    int spike_location_x[NUMOF_SPIKES_3] = {25, 30, 100};
-    int spike_location_y[NUMOF_SPIKES_3] = {140, 40, 80};
-
-    // Enemy (skeleton) positions and movement toggles
-    int enemy_x_left[NUM_OF_ENEMY_3] = {10, 10};
-    int enemy_x_right[NUM_OF_ENEMY_3] = {90, 90};
-    static int enemy_current_pos_x[NUM_OF_ENEMY_3] = {75, 75};
-    static int enemy_current_pos_y[NUM_OF_ENEMY_3] = {75, 110};
-    static int toggle[NUM_OF_ENEMY_3] = {0, 0}; // Toggle for enemy movement direction
-    int pos_x_old[NUM_OF_ENEMY_3] = {75, 75}; // Previous positions of enemies
-    int pos_y_old[NUM_OF_ENEMY_3] = {75, 110};
-
-    // Door position
-    int door_location_x = 5; 
-    int door_location_y = 45;
-
-    // Array containing the musical notes for level 3
-    int notes[LEVEL_3_MUSIC] = {A4, C5, E5, A5, G5, E5, C5, A4, B4, D5, F5, B5, A5, F5, D5, B4, E4, G4, B4, E5, D5, B4, G4, E4};
-
-    // Rest of the function contains the game logic for Level 3
-    // This includes rendering the level layout, handling player movements and interactions
-    // Checking conditions for level completion, key pickups, and updating the player's health status
-    // Additional complexity includes more enemies and different key and spike positions
-
-    // Return an integer to indicate the completion or continuation of the level
-	
-	while (clear_screen == 0)
+	for (int i = 0; i < layout->num_keys; i++)
 	{
-		fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-		// New Character positions
-		*px = player_location_x[random_location_picker];
-		*py = player_location_y[random_location_picker];
-		clear_screen++;
+		if (dirty_keys & (1 << i))
+			camera_put_image(layout->keys[i].x,layout->keys[i].y,12,16,key_pickup[i] ? SPRITE(SPRITE_TAKEN_KEY) : SPRITE(SPRITE_KEY),0,0);
 	}
-	while (start_game == 0)
+	if (dirty_door)
+		camera_put_image(layout->door.x,layout->door.y,12,16,SPRITE(SPRITE_DOOR),0,0);
+	enemies_draw(skeletons,layout->num_enemies);
+	for (int i = 0; i < layout->num_spikes; i++)
 	{
-		printTextX2("Level 3", 25, 20, RGBToWord(255,255,255), 0);
-		printText("Difficulty ", 10, 50, RGBToWord(255,255,255), 0);
-		Difficulty_Display(difficulty);
-		printText("Collect ", 15, 65, RGBToWord(255,255,255), 0);
-		sprintf(key_display,"%d",NUMOF_KEYS_3);
-		printText(key_display,70,65,RGBToWord(255,255,255),0);
-		putImage(80,60,12,16,key,0,0);
-		sprintf(num_of_hearts,"%d",hearts_used);
-		printText(num_of_hearts,20,80,RGBToWord(255,255,255),0);
-		putImage(30,75,12,16,heart,0,0);
-		printText("Beware of:",15,100,RGBToWord(255,255,255),0);
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(90,95,12,16,nightmare_spike,0,0);
-			putImage(110,95,12,16,night_skeleton_run,0,0);
-		}
-		else
-		{
-			putImage(90,95,12,16,spike,0,0);
-			putImage(110,95,12,16,skeleton_run,0,0);
-		}
-		printText("<-- AND -->", 20, 120, RGBToWord(255,255,255), 0);
-
-		if ((GPIOB->IDR & (1 << 4)) == 0 && (GPIOB->IDR & (1 << 5)) == 0) // right pressed
-		{	
-			start_game = 1;		
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-			while (1)
-			{
-				// Display the Keys
-				for (int i = 0; i < NUM_OF_KEYS_3_DISPLAYED; i++)
-				{
-					putImage(key_location_x[i],key_location_y[i],12,16,key,0,0);
-				}
-				
-				// Display the hearts
-				for (int i = 0; i < hearts_used; i++)
-				{
-					if (difficulty == DIFFICULTY_AMOUNT)
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,nightmare_heart,0,0);					
-					}
-					else
-					{
-						putImage(heart_location_x[i],heart_location_y[i],12,16,heart,0,0);
-					}
-				}
-
-				fillRectangle(2,25,168,1,RGBToWord(255,255,255));
-
-				for (int i = 0; i < NUMOF_KEYS_3; i++)
-				{
-					putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,key,0,0);
-				}
-				// We turn red off since we are in a level now. 
-				RedOff();
-				// Green LED tells you the game is running and we are in a level.
-				GreenOn();
-				serial_log(level3_started_log);
-				break;
-			}							
-		}
+		if (dirty_spikes & (1 << i))
+			camera_put_image(layout->spikes[i].x,layout->spikes[i].y,12,16,spike_image,0,0);
 	}
-	if (difficulty == DIFFICULTY_AMOUNT)
+
+	if (knight_dirty) {
+		// Redraw only if he moved, his frame changed or he blinked to reduce flicker.
+		// He was cleared before the rest so whatever he uncovered is already back.
+		oldx = player_x;
+		oldy = player_y;
+		if (knight_visible)
+			draw_knight();
+		knight_shown = knight_visible;
+		knight_dirty = 0;
+	}
+}
+
+// 1 if a sprite that is about to be redrawn overlaps the one at o
+static int uncovered(const Waypoint *o)
+{
+	if (knight_dirty && (touching(o,oldx,oldy) || touching(o,player_x,player_y)))
+		return 1;
+	for (int i = 0; i < layout->num_enemies; i++)
 	{
-		if (timer < 10)
-		{
-			fillRectangle(55,12,12,12,RGBToWord(0,0,0));
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,0,0),0);
-		}
-		else
-		{
-			sprintf(timer_string,"%d",timer);
-			printText(timer_string,55,12,RGBToWord(255,255,255),0);
-		}
-		if (max_time <= 0)
-		{
-			start_game = 0;
-			heart_gone = 0;
-			for (int i = 0; i < NUMOF_KEYS_3; i++)
-			{
-				key_pickup[i] = 0;
-			}
+		if (enemy_dirty(&skeletons[i]) && (touching(o,skeletons[i].x,skeletons[i].y) ||
+		    (skeletons[i].drawn_x >= 0 && touching(o,skeletons[i].drawn_x,skeletons[i].drawn_y))))
 			return 1;
-		}
-		if (milliseconds_timer >= 1000)
-		{
-			max_time = max_time - 1000;
-			milliseconds_timer = 0;
-			timer--;
-		}
-		milliseconds_timer++;
 	}
-	if (music_flag == 0)
+	return 0;
+}
+
+static void draw_knight(void)
+{
+	// Sideways he faces the way he walks, up and down the climbing frame is flipped
+	const AnimFrame *f = anim_frame(&knight_anim);
+	int h = (f->flags & ANIM_HFLIP) != 0;
+	int v = (f->flags & ANIM_VFLIP) != 0;
+	if (knight_anim.clip == &knight_walk)
+		h ^= hinverted;
+	else
+		v ^= vinverted;
+	camera_put_image(player_x,player_y,12,16,f->image,h,v);
+}
+
+static void level_exit(void)
+{
+	// Put the scroll back so the next scene draws where it expects to
+	camera_release();
+	music_stop();
+	timer_stop(&countdown_timer);
+}
+
+// Draws whatever of the level overlaps a part of the view that just scrolled in, as it
+// was last drawn. The camera clips to that part, so whole sprites can be drawn and
+// the ones that miss it are skipped.
+static void level_redraw(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	const uint16_t *spike_image = (difficulty == DIFFICULTY_AMOUNT) ? SPRITE(SPRITE_NIGHTMARE_SPIKE) : SPRITE(SPRITE_SPIKE);
+
+	for (int i = 0; i < layout->num_keys; i++)
 	{
-		play_music(notes,LEVEL_3_MUSIC);
+		if (in_area(layout->keys[i].x,layout->keys[i].y,x,y,w,h))
+			camera_put_image(layout->keys[i].x,layout->keys[i].y,12,16,key_pickup[i] ? SPRITE(SPRITE_TAKEN_KEY) : SPRITE(SPRITE_KEY),0,0);
 	}
-	// Check if Player can go through door and finish level.
-	if (isInside(door_location_x,door_location_y,12,16,x,y) || isInside(door_location_x,door_location_y,12,16,x+12,y) || isInside(door_location_x,door_location_y,12,16,x,y+16) || isInside(door_location_x,door_location_y,12,16,x+12,y+16))
+	if (in_area(layout->door.x,layout->door.y,x,y,w,h))
+		camera_put_image(layout->door.x,layout->door.y,12,16,SPRITE(SPRITE_DOOR),0,0);
+	for (int i = 0; i < layout->num_spikes; i++)
 	{
-		// Checks if all keys have been obtained 
-		if (amount_keys == NUMOF_KEYS_3)
-		{
-			// We turn Green off since we are not in a level now. 
-			GreenOff();
-			// Red LED tells you the game is running and we are not in a level.
-			RedOn();
-			serial_log(level3_complete_log);
-			playNote(0);
-			music_flag = 1;
-			int tmp = hearts_used - heart_gone;
-			char currentHeart[NUM_OF_CHAR];
-			sprintf(currentHeart,"%d",tmp);
-
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-			printTextX2("Level 3", 25, 20, RGBToWord(255,255,255), 0);
-			printTextX2("Complete!", 15, 40, RGBToWord(255,255,255), 0);
-			printText("Hearts Left", 5, 70, RGBToWord(255,255,255), 0);
-			printText(currentHeart,88,70,RGBToWord(255,255,255),0);
-			putImage(100,63,12,16,heart,0,0);
-			printText("<--", 5, 90, RGBToWord(255,255,255), 0);
-			while (1)
-			{
-				if ((GPIOB->IDR & (1 << 5))==0) // left pressed
-				{
-					start_game = 0;
-					clear_screen = 0;
-					amount_keys = 0;
-					heart_gone = 0;
-					for (int i = 0; i < NUMOF_KEYS_3; i++)
-					{
-						key_pickup[i] = 0;
-						toggle[i] = 0;
-						enemy_current_pos_x[i] = pos_x_old[i];
-						enemy_current_pos_y[i] = pos_y_old[i];
-						start_movement = 0;
-					}
-					break;
-				}
-			}
-			// Move onto the next level
-			current_level++;
-			// Clear the current screen
-			fillRectangle(0,0,128,160,RGBToWord(0,0,0));
-		}
+		if (in_area(layout->spikes[i].x,layout->spikes[i].y,x,y,w,h))
+			camera_put_image(layout->spikes[i].x,layout->spikes[i].y,12,16,spike_image,0,0);
 	}
-	// Key pickup check
-	for (int i = 0; i < NUMOF_KEYS_3; i++)
+	for (int i = 0; i < layout->num_enemies; i++)
 	{
-		if (key_pickup[i] == 0)
-		{
-			if (isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16))
-			{
-				putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-				putImage(key_location_x[amount_keys],key_location_y[amount_keys],12,16,taken_key,0,0);
-				key_pickup[i] = 1;
-				amount_keys++;
-				serial_log(key_pickup_log);
-			}
-		}
-		if (key_pickup[i] == 1)
-		{
-			if (!(isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x,y+16) || isInside(pickup_key_location_x[i],pickup_key_location_y[i],12,16,x+12,y+16)))
-			{
-				putImage(pickup_key_location_x[i],pickup_key_location_y[i],12,16,taken_key,0,0);
-			}
-		}
+		if (skeletons[i].drawn_x >= 0 && in_area(skeletons[i].drawn_x,skeletons[i].drawn_y,x,y,w,h))
+			camera_put_image(skeletons[i].drawn_x,skeletons[i].drawn_y,12,16,skeletons[i].drawn_image,skeletons[i].drawn_flip,0);
 	}
+	if (knight_shown && in_area(player_x,player_y,x,y,w,h))
+		draw_knight();
+}
 
-	// Draws the Door
-	putImage(door_location_x,door_location_y,12,16,door,0,0);
+// Draws every sprite in the level as it was last drawn
+static void level_draw_sprites(void)
+{
+	level_redraw(0,0,LEVEL_MAX_WIDTH,LEVEL_MAX_HEIGHT);
+}
 
-	// Draws the Enemy
-	for (int i = 0; i < NUM_OF_ENEMY_3; i++)
-	{
-		if (enemy_current_pos_x[i] != enemy_x_right[i] && toggle[i] == 0)
-		{
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_run,0,0);
-			}
-			else
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_run,0,0);
-			}
-			drawRectangle(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,RGBToWord(0,0,0));
-			enemy_current_pos_x[i]++;
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_run,0,0);
-			}
-			else
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_run,0,0);
-			}		
-		}
-		else
-		{
-			toggle[i] = 1;
-		}
-		if (enemy_current_pos_x[i] != enemy_x_left[i] && toggle[i] == 1)
-		{
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_run,1,0);
-			}
-			else
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_run,1,0);
-			}
-			drawRectangle(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,RGBToWord(0,0,0));
-			enemy_current_pos_x[i]--;
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_run,1,0);
-			}
-			else
-			{
-				putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_run,1,0);
-			}
-		}
-		else
-		{
-			toggle[i] = 0; 
-		}
+// 1 if the 12x16 sprite at sx,sy overlaps the area
+static int in_area(int16_t sx, int16_t sy, int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	return sx < x + w && sx + 12 > x && sy < y + h && sy + 16 > y;
+}
 
-		// Check to see if the player is hit by the enemy 
-		if ((isInside(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,x,y+5) || isInside(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,x+12,y+5) || isInside(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,x+5,y+11) || isInside(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,x+7,y+11)))
-		{
-			serial_log(died_skeleton_log);
-			if (toggle[i] == 1)
-			{
-				if (difficulty == DIFFICULTY_AMOUNT)
-				{
-					putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_attack2,1,0);
-				}
-				else
-				{
-					putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_attack2,1,0);
-				}
-			}
-			else
-			{
-				if (difficulty == DIFFICULTY_AMOUNT)
-				{
-					putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,night_skeleton_attack2,0,0);
-				}
-				else
-				{
-					putImage(enemy_current_pos_x[i],enemy_current_pos_y[i],12,16,skeleton_attack2,0,0);
-				}
-			}
-			playNote(0);
-			music_flag = 1;
-			fillRectangle(x,y,12,16,RGBToWord(0,0,0));
-
-			// Respawn the player back at the Original Position.
-			*px = pickup_key_location_x[random_location_picker];
-			*py = pickup_key_location_y[random_location_picker];
-			
-			// Player loses a heart.
-			putImage(heart_location_x[heart_gone],heart_location_y[heart_gone],12,16,hearts_empty,0,0);
-			heart_gone++;
-			delay(1500);
-			putImage(*px,*py,12,16,knight_animation1,0,0);
-			music_flag = 0;
-		}	
-	}
-	// Draws the spike
-	for (int i = 0; i < NUMOF_SPIKES_3; i++)
-	{
-		if (difficulty == DIFFICULTY_AMOUNT)
-		{
-			putImage(spike_location_x[i],spike_location_y[i],12,16,nightmare_spike,0,0);
-		}
-		else
-		{
-			putImage(spike_location_x[i],spike_location_y[i],12,16,spike,0,0);
-		}
-		if ((isInside(spike_location_x[i],spike_location_y[i],12,16,x,y) || isInside(spike_location_x[i],spike_location_y[i],12,16,x+12,y) || isInside(spike_location_x[i],spike_location_y[i],12,16,x,y+16) || isInside(spike_location_x[i],spike_location_y[i],12,16,x+12,y+16)))
-		{
-			serial_log(died_spike_log);
-			playNote(0);
-			music_flag = 1;
-			// The player has been hit so we automatically punish him by setting him back to the original positoon.
-			if (difficulty == DIFFICULTY_AMOUNT)
-			{
-				putImage(spike_location_x[i],spike_location_y[i],12,16,nightmare_spike,0,0);
-			}
-			else
-			{
-				putImage(spike_location_x[i],spike_location_y[i],12,16,spike,0,0);
-			}
-			fillRectangle(x,y,12,16,RGBToWord(0,0,0));
-			// Respawn the player back at the Original Position.
-			*px = 115;
-			*py = 45;
-			// Player loses a heart.
-			putImage(heart_location_x[heart_gone],heart_location_y[heart_gone],12,16,hearts_empty,0,0);
-			heart_gone++;
-			delay(1500);
-			putImage(*px,*py,12,16,knight_animation1,0,0);
-			music_flag = 0;
-		}	
-	}
+// Level complete screen, waits for the left button before moving on
+static void complete_enter(void)
+{
+    char title[] = "Level 1";
+    char complete_log[] = "Level 1 Complete!";
+    char currentHeart[NUM_OF_CHAR];
+
+    title[6] = complete_log[6] = '0' + current_level;
+	// We turn Green off since we are not in a level now. 
+	GreenOff();
+	// Red LED tells you the game is running and we are not in a level.
+	RedOn();
+	serial_log(complete_log);
+	playNote(0);
+	fmt_int(currentHeart,num_of_hearts - heart_gone);
+
+	printTextX2(title, 25, 20, COLOUR_WHITE, 0);
+	printTextX2("Complete!", 15, 40, COLOUR_WHITE, 0);
+	printText("Hearts Left", 5, 70, COLOUR_WHITE, 0);
+	printText(currentHeart,88,70,COLOUR_WHITE,0);
+	putImage(100,63,12,16,SPRITE(SPRITE_HEART),0,0);
+	printText("<--", 5, 90, COLOUR_WHITE, 0);
+}
 
-	if (heart_gone == hearts_used)
+static void complete_update(uint32_t now)
+{
+	if (buttons_pressed & BUTTON_LEFT) // left pressed
 	{
-		start_game = 0;
-		clear_screen = 0;
-		amount_keys = 0;
-		heart_gone = 0;
-		for (int i = 0; i < NUMOF_KEYS_3; i++)
-		{
-			key_pickup[i] = 0;
-			toggle[i] = 0;
-			enemy_current_pos_x[i] = pos_x_old[i];
-			enemy_current_pos_y[i] = pos_y_old[i];
-		}
-		return 1;
+		// Move onto the next level, or the end of the game after the last one
+		current_level++;
+		if (current_level > 3)
+			scene_change(&gameend_scene);
+		else
+			scene_change(&card_scene);
 	}
 }
 
 // Function to handle the game over scenario
-void gameover(int *start_game, int *current_difficulty_choice, int *difficulty) {
-    int press = 0; // Variable to detect button press
-
+static void gameover_enter(void) {
     // Turn off the green LED and turn on the red LED
     GreenOff(); // Indicate that the player is not in a level
     RedOn(); // Indicate that the game is running but not in a level
 
     playNote(0); // Stop any ongoing music or sounds
-    fillRectangle(0, 0, 128, 164, RGBToWord(0, 0, 0)); // Clear the screen
 
     // Display "You Lost!" message on the screen
-    printTextX2("You", 40, 20, RGBToWord(255, 0, 0), 0); // "You" in red
-    printTextX2("Lost!", 40, 50, RGBToWord(255, 0, 0), 0); // "Lost!" in red
-    printText("|", 110, 130, RGBToWord(255, 255, 255), 0); // Display a vertical line
-    printText("V", 110, 140, RGBToWord(255, 255, 255), 0); // Display a "V" to indicate a button press option
-
-    // Loop to wait for player input to acknowledge the game over
-    while (press == 0) {
-        if ((GPIOA->IDR & (1 << 11)) == 0) { // If right button is pressed
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear the screen
-            press = 1; // Set the press flag
-            *start_game = 0; // Reset the game start flag
-            *difficulty = 0; // Reset the difficulty
-            *current_difficulty_choice = 0; // Reset the difficulty choice
-            current_level = 1; // Reset the current level to 1
-            start_movement = 0; // Reset the start movement flag
-            nightmare_flag = 0; // Reset the nightmare mode flag
-            music_flag = 0; // Reset the music flag
-            max_time = 60000; // Reset the maximum time to 60,000 milliseconds
-            timer = 60; // Reset the timer back to 60 seconds
-            milliseconds_timer = 0; // Reset the milliseconds timer
-            seed = 0; // Reset the seed
-            delay(500); // Short delay before continuing
-        }
-    }
-}
-
-// Function to set the game's difficulty level and number of hearts (lives) based on the player's choice
-void Difficulty_choice(int* difficulty, int choice, int* hearts_used) {
-    if ((*difficulty) == 0) { // Check if the difficulty is not yet set
-        delay(100); // Short delay for timing purposes
-        fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear the screen
-
-        // Display difficulty level options
-        printTextX2("Difficulty", 5, 5, RGBToWord(255, 255, 255), 0); // Display the text "Difficulty"
-        printTextX2("Easy", 40, 25, RGBToWord(0, 255, 0), 0); // Display the text "Easy" in green
-        putImage(99, 25, 12, 16, easy_skull, 0, 0); // Display the Easy Mode Skull image
-
-        // Display hearts for Easy mode
-        for (int i = 0; i < 3; i++) {
-            putImage(42 + 15 * i, 40, 12, 16, heart, 0, 0); // Display four heart images
-        }
-        printText("<--", 53, 58, RGBToWord(255, 255, 255), 0); // Display left arrow for selection
-
-        // Repeat similar process for Normal and Hard modes
-        printTextX2("Normal", 30, 65, RGBToWord(255, 165, 0), 0); // Normal mode in orange
-        putImage(100, 65, 12, 16, normal_skull, 0, 0); // Normal Mode Skull image
-        for (int i = 0; i < 2; i++) {
-            putImage(50 + 15 * i, 80, 12, 16, heart, 0, 0); // Display two heart images
-        }
-        printText("^", 60, 100, RGBToWord(255, 255, 255), 0); // Display up arrow for selection
-		printText("|", 60, 105, RGBToWord(255,255,255), 0); // Displays the pipe for selection 
-        printTextX2("Hard", 40, 115, RGBToWord(255, 0, 0), 0); // Hard mode in red
-        putImage(100, 115, 12, 16, hard_skull, 0, 0); // Hard Mode Skull image
-        putImage(58, 130, 12, 16, heart, 0, 0); // Display one heart image
-        printText("-->", 55, 148, RGBToWord(255, 255, 255), 0); // Display right arrow for selection
-
-        // Loop to wait for player's input to select difficulty
-        while (choice == 0) {
-            if ((GPIOB->IDR & (1 << 5)) == 0) { // If left button pressed, choose Easy
-                *difficulty = 1;
-                *hearts_used = 3;
-                choice = 1;
-                fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear screen
-            } else if ((GPIOA->IDR & (1 << 8)) == 0) { // If up button pressed, choose Normal
-                *difficulty = 2;
-                *hearts_used = 2;
-                choice = 1;
-                fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear screen
-            } else if ((GPIOB->IDR & (1 << 4)) == 0) { // If right button pressed, choose Hard
-                *difficulty = 3;
-                *hearts_used = 1;
-                choice = 1;
-                fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear screen
-            }
-        }
-    }
-}
-
-// Function to display the current difficulty level on the screen
-void Difficulty_Display(int difficulty) {
-    // Use a switch statement to handle different difficulty levels
-    switch(difficulty) {
-        case 1: // If the difficulty level is 'Easy'
-            printText("Easy", 85, 50, RGBToWord(0, 255, 0), 0); // Display "Easy" in green color
-            break; // Exit switch statement
-
-        case 2: // If the difficulty level is 'Normal'
-            printText("Normal", 85, 50, RGBToWord(255, 165, 0), 0); // Display "Normal" in orange color
-            break; // Exit switch statement
-
-        case 3: // If the difficulty level is 'Hard'
-            printText("Hard", 85, 50, RGBToWord(255, 0, 0), 0); // Display "Hard" in red color
-            break; // Exit switch statement
-
-        case 4: // If the difficulty level is 'Nightmare'
-            printText("Night", 85, 50, RGBToWord(128, 0, 128), 0); // Display "Night" in purple color
-            break; // Exit switch statement
-    }
+    printTextX2("You", 40, 20, COLOUR_RED, 0); // "You" in red
+    printTextX2("Lost!", 40, 50, COLOUR_RED, 0); // "Lost!" in red
+    printText("|", 110, 130, COLOUR_WHITE, 0); // Display a vertical line
+    printText("V", 110, 140, COLOUR_WHITE, 0); // Display a "V" to indicate a button press option
 }
 
-// Function to display the introduction screen of the game
-void intro(void) {
-    int press = 0; // Variable to track if a button is pressed
-
-    // Display the names of the creators with a delay between each
-    printTextX2("Denis", 20, 30, RGBToWord(255, 255, 255), 0);
-    delay(1000); // Delay for 1 second
-    printTextX2("and", 40, 60, RGBToWord(255, 255, 255), 0);
-    delay(1000); // Delay for 1 second
-    printTextX2("Cillian", 20, 90, RGBToWord(255, 255, 255), 0);
-    delay(1000); // Delay for 1 second
-    printTextX2("Presents", 20, 120, RGBToWord(255, 255, 255), 0);
-    delay(500); // Delay for 0.5 seconds
-
-    // Clear the screen and prepare for the next part of the intro
-    fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-    delay(500); // Delay for 0.5 seconds
-
-    // Display the game title "Key Quest" with a delay
-    printTextX2("Key", 30, 20, RGBToWord(255, 255, 255), 0);
-    delay(1000); // Delay for 1 second
-    printTextX2("Quest", 30, 50, RGBToWord(255, 255, 255), 0);
-    delay(1000); // Delay for 1 second
-
-    // Display a directional indicator for the user to proceed from the intro
-    printText("|", 110, 130, RGBToWord(255, 255, 255), 0);
-    printText("V", 110, 140, RGBToWord(255, 255, 255), 0);
-
-    // Loop to wait for player input to proceed from the intro
-    while (press == 0) {
-        if ((GPIOA->IDR & (1 << 11)) == 0) { // Check if 'down' button is pressed
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear screen
-            press = 1; // Update press variable to exit loop
-        }
-    }
-}
-
-// Function to display the main menu of the game
-void main_menu(void) {
-    int press = 0; // Variable to track if a button is pressed
-
-    // Display the game title "Key Quest" on the screen
-    printTextX2("Key", 30, 20, RGBToWord(255, 255, 255), 0);
-    printTextX2("Quest", 30, 50, RGBToWord(255, 255, 255), 0);
-
-    // Display a directional indicator for the user to start the game
-    printText("|", 110, 130, RGBToWord(255, 255, 255), 0);
-    printText("V", 110, 140, RGBToWord(255, 255, 255), 0);
-
-    // Loop through the badges array to display the trophies earned
-    for (int i = 0; i < BADGES_AMOUNT; i++) {
-        if (badges[i] == 1) { // Easy skull trophy
-            putImage(5, 130, 12, 16, easy_skull, 0, 0);
-        }
-        if (badges[i] == 2) { // Normal skull trophy
-            putImage(25, 130, 12, 16, normal_skull, 0, 0);
-        }
-        if (badges[i] == 3) { // Hard skull trophy
-            putImage(45, 130, 12, 16, hard_skull, 0, 0);
-        }
-        if (badges[i] == 4) { // Nightmare skull trophy
-            putImage(65, 130, 12, 16, nightmare_skull, 0, 0);
-        }
-    }
-
-    // Loop to wait for player input to start the game
-    while (press == 0) {
-        if ((GPIOA->IDR & (1 << 11)) == 0) { // Check if 'down' button is pressed
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0)); // Clear screen
-            press = 1; // Update press variable to exit loop
-        }
+static void gameover_update(uint32_t now) {
+    if (buttons_pressed & BUTTON_UP) { // Wait for player input to acknowledge the game over
+        game_reset();
+        scene_change(&menu_scene);
     }
 }
 
 // Function to handle the end of the game
-void gameend(int *start_game, int *current_difficulty_choice, int *difficulty) {
+static void gameend_enter(void) {
     // Flags to track unlocking of various achievements only once
     static int easy_skull_flag = 0;
     static int normal_skull_flag = 0;
     static int hard_skull_flag = 0;
     static int night_skull_flag = 0;
     static int nightmare_unlocked_flag = 0;
-    int press = 0;
 
     // Messages to display upon unlocking special modes and trophies
     char nightmare_unlock[] = "Nightmare Mode Unlocked!";
@@ -1983,25 +1092,26 @@ void gameend(int *start_game, int *current_difficulty_choice, int *difficulty) {
 
     // Stop any ongoing music, clear the screen, and display victory message
     playNote(0);
-    fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-    printTextX2("You", 40, 40, RGBToWord(255, 255, 204), 0);
-    printTextX2("Won!", 40, 60, RGBToWord(255, 255, 204), 0);
-    printText("-->", 100, 140, RGBToWord(255, 255, 255), 0);
+    GreenOff();
+    RedOn();
+    printTextX2("You", 40, 40, COLOUR_CREAM, 0);
+    printTextX2("Won!", 40, 60, COLOUR_CREAM, 0);
+    printText("-->", 100, 140, COLOUR_WHITE, 0);
 
     // Check the difficulty level and unlock respective trophies if not already done
-    if (*difficulty == 1 && easy_skull_flag == 0) {
+    if (difficulty == 1 && easy_skull_flag == 0) {
         badges[0] = 1;
         serial_log(skull_unlocked_easy);
         easy_skull_flag = 1;
-    } else if (*difficulty == 2 && normal_skull_flag == 0) {
+    } else if (difficulty == 2 && normal_skull_flag == 0) {
         badges[1] = 2;
         serial_log(skull_unlocked_normal);
         normal_skull_flag = 1;
-    } else if (*difficulty == 3 && hard_skull_flag == 0) {
+    } else if (difficulty == 3 && hard_skull_flag == 0) {
         badges[2] = 3;
         serial_log(skull_unlocked_hard);
         hard_skull_flag = 1;
-    } else if (*difficulty == 4 && night_skull_flag == 0) {
+    } else if (difficulty == 4 && night_skull_flag == 0) {
         badges[3] = 4;
         serial_log(skull_unlocked_nightmare);
         night_skull_flag = 1;
@@ -2013,94 +1123,75 @@ void gameend(int *start_game, int *current_difficulty_choice, int *difficulty) {
         serial_log(nightmare_unlock);
         nightmare_unlocked_flag = 1;
     }
+}
 
-    // Loop to wait for player input to acknowledge game end
-    while (press == 0) {
-        if ((GPIOB->IDR & (1 << 4)) == 0) { // If 'down' button is pressed
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-            press = 1;
-            // Resetting various game state variables for a new game
-            *start_game = 0;
-            *difficulty = 0;
-            *current_difficulty_choice = 0;
-            current_level = 1;
-            start_movement = 0;
-            nightmare_flag = 0;
-            music_flag = 0;
-            max_time = 60000; // Change it from seconds to milliseconds
-            timer = 60; // Reset timer back to 60 seconds
-            milliseconds_timer = 0;
-            seed = 0;
-            if (badges[3] == 4) {
-                nightmare_enabled = 1;
-            }
-        }   
+static void gameend_update(uint32_t now) {
+    if (buttons_pressed & BUTTON_RIGHT) { // Wait for player input to acknowledge game end
+        // Resetting various game state variables for a new game
+        game_reset();
+        scene_change(&menu_scene);
     }
-    fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-    current_level = 1; // Resetting back to level 1 for a new game
 }
 
-// Function to play music based on an array of notes
-void play_music(int music_notes[], int num_of_notes) {
-    static int next_note = 0;  // Static variable to keep track of the current note index
-
-    if (milliseconds >= 500) {
-        // If 500 milliseconds have passed,
-        playNote(0);              // stop the current note by playing a note with value 0
-        next_note++;              // Move on to the next note in the array
-        milliseconds = 0;         // Reset the milliseconds counter
+// Level music runs from music_timer: each note sounds for MUSIC_NOTE_MS less a short
+// rest so that repeated notes are heard separately. The tick runs in the SysTick interrupt,
+// so it is only timed, it stays out of the watchdog's zone trail (see watchdog.h).
+static void music_tick(void) {
+    PROFILE_BEGIN(PROF_MUSIC);
+    if (music_sounding) {
+        playNote(0); // rest before the next note
+        music_sounding = 0;
+        music_timer.period = MUSIC_REST_MS;
     } else {
-        // If 500 milliseconds have not passed,
-        playNote(music_notes[next_note]);  // Play the current note from the music_notes array
+        playNote(music_notes[music_next]);
+        music_sounding = 1;
+        music_timer.period = MUSIC_NOTE_MS - MUSIC_REST_MS;
+        if (++music_next >= music_len)
+            music_next = 0; // start from the beginning of the tune again
     }
+    PROFILE_END(PROF_MUSIC);
+}
 
-    if (next_note >= num_of_notes) {
-        // If the end of the notes array is reached,
-        next_note = 0;  // Start from the beginning of the array again
-    }
+// Starts a tune from its first note
+static void music_start(const uint16_t notes[], int num_of_notes) {
+    music_stop();
+    music_notes = notes;
+    music_len = num_of_notes;
+    music_next = 0;
+    music_resume();
 }
 
-// Function to handle the 'Nightmare' difficulty setting in the game
-void Difficulty_Nightmare(int* difficulty, int choice, int *hearts_used) {
-    // Loop runs as long as the difficulty isn't set to 4 (indicating Nightmare difficulty)
-    // and the nightmare_flag is not set
-    while (*difficulty != 4 && nightmare_flag == 0) {
-        // Displaying the difficulty settings on the screen
-        printTextX2("Difficulty", 10, 20, RGBToWord(255, 255, 255), 0);
-        printTextX2("Nightmare", 15, 40, RGBToWord(128, 0, 128), 0);
-        
-        // Display a skull image as a symbol for the Nightmare difficulty
-        putImage(58, 60, 12, 16, nightmare_skull, 0, 0);
-        // Displaying features of Nightmare difficulty - Stronger enemies, 1 minute timer, etc.
-        printText("Stronger Enemies", 15, 80, RGBToWord(255, 255, 255), 0);
-        printText("1 Minute Timer", 25, 90, RGBToWord(255, 255, 255), 0);
-        printText("1", 60, 105, RGBToWord(255, 255, 255), 0);
-        putImage(70, 98, 12, 16, nightmare_heart, 0, 0);
-
-        // Options to accept or reject the Nightmare difficulty
-        printText("|", 115, 120, RGBToWord(255, 255, 255), 0);
-        printText("V", 115, 130, RGBToWord(255, 255, 255), 0);
-        printText("Yes", 105, 140, RGBToWord(255, 255, 255), 0);
-        printText("^", 10, 125, RGBToWord(255, 255, 255), 0);
-        printText("|", 10, 130, RGBToWord(255, 255, 255), 0);
-        printText("No", 5, 140, RGBToWord(255, 255, 255), 0);
-
-        // Checking for player input through buttons connected to GPIOA
-        if ((GPIOA->IDR & (1 << 11)) == 0) { // If 'down' button is pressed
-            // Clear screen and set difficulty to Nightmare
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-            *difficulty = 4; // Set difficulty to Nightmare
-            choice = 1; // Record player's choice
-            *hearts_used = 1; // Set the number of hearts used
-            nightmare_flag = 1; // Set the flag indicating Nightmare difficulty chosen
-            break; // Exit the loop
-        }
-        if ((GPIOA->IDR & (1 << 8)) == 0) { // If 'up' button is pressed
-            // Clear screen and exit the Nightmare difficulty option
-            fillRectangle(0, 0, 128, 160, RGBToWord(0, 0, 0));
-            nightmare_flag = 1; // Set the flag indicating exit from Nightmare difficulty option
-            break; // Exit the loop
-        }
+// Carries on from the note after the last one played
+static void music_resume(void) {
+    music_sounding = 0;
+    timer_start(&music_timer, 0, MUSIC_REST_MS, music_tick);
+}
+
+static void music_stop(void) {
+    timer_stop(&music_timer);
+    playNote(0);
+    music_sounding = 0;
+}
+
+// Function to display the current difficulty level on the screen
+void Difficulty_Display(int difficulty) {
+    // Use a switch statement to handle different difficulty levels
+    switch(difficulty) {
+        case 1: // If the difficulty level is 'Easy'
+            printText("Easy", 85, 50, COLOUR_GREEN, 0); // Display "Easy" in green color
+            break; // Exit switch statement
+
+        case 2: // If the difficulty level is 'Normal'
+            printText("Normal", 85, 50, COLOUR_ORANGE, 0); // Display "Normal" in orange color
+            break; // Exit switch statement
+
+        case 3: // If the difficulty level is 'Hard'
+            printText("Hard", 85, 50, COLOUR_RED, 0); // Display "Hard" in red color
+            break; // Exit switch statement
+
+        case 4: // If the difficulty level is 'Nightmare'
+            printText("Night", 85, 50, COLOUR_PURPLE, 0); // Display "Night" in purple color
+            break; // Exit switch statement
     }
 }
 
@@ -2108,11 +1199,15 @@ void Difficulty_Nightmare(int* difficulty, int choice, int *hearts_used) {
 void serial_log(char log[]) {
     // Iterate over each character in the provided log message
     int i = 0;
+    WATCHDOG_ZONE_ENTER(PROF_SERIAL_LOG);
+    PROFILE_BEGIN(PROF_SERIAL_LOG);
     while(log[i] != '\0') { // '\0' marks the end of a string in C
         eputchar(log[i]);   // Send each character of the log message
         i++;                // Move to the next character
     }
     eputs("\r\n");         // Send a newline and carriage return to end the log entry
+    PROFILE_END(PROF_SERIAL_LOG);
+    WATCHDOG_ZONE_LEAVE(PROF_SERIAL_LOG);
 }
 
 
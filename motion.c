@@ -0,0 +1,105 @@
+#include <stdint.h>
+#include "motion.h"
+
+#define FIX_SHIFT 16
+#define FIX_HALF (1 << (FIX_SHIFT - 1))
+// Convert a speed in pixels per second into Q16.16 pixels per millisecond at compile time
+#define PX_PER_S(n) ((int32_t)(((n) * 65536L) / 1000))
+
+#define KNIGHT_SPEED PX_PER_S(30)  // top speed, roughly what the old 1px per loop gave
+#define KNIGHT_ACCEL_MS 80         // time to reach top speed from rest
+#define KNIGHT_DECEL_MS 40         // time to stop from top speed once the button is released
+#define MAX_STEP_MS 50             // don't integrate over long stalls (level intro screens etc.)
+
+// Movement limits, same as the old button handlers. The far edges keep the same gap
+// to the side of the level, 110 and 140 on a single screen.
+#define MIN_X 10
+#define MIN_Y 32
+#define RIGHT_GAP 18
+#define BOTTOM_GAP 20
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 160
+
+// Speed scale per difficulty (index 0 is unset), 256 = 1.0
+static const int32_t difficulty_scale[] = {256, 256, 256, 282, 307};
+
+static int32_t approach(int32_t v, int32_t target, int32_t step);
+static int32_t clamp(int32_t v, int32_t lo, int32_t hi);
+
+void motion_init(Motion *m, uint16_t x, uint16_t y)
+{
+	m->x = (int32_t)x << FIX_SHIFT;
+	m->y = (int32_t)y << FIX_SHIFT;
+	m->vx = 0;
+	m->vy = 0;
+	if (m->scale == 0)
+		m->scale = 256;
+	if (m->max_x == 0)
+		motion_set_area(m, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+void motion_set_area(Motion *m, uint16_t width, uint16_t height)
+{
+	m->max_x = width - RIGHT_GAP;
+	m->max_y = height - BOTTOM_GAP;
+}
+void motion_set_difficulty(Motion *m, int difficulty)
+{
+	if (difficulty < 0 || difficulty > 4)
+		difficulty = 0;
+	m->scale = difficulty_scale[difficulty];
+}
+int motion_update(Motion *m, int xdir, int ydir, uint32_t dt)
+{
+	// Advance by dt milliseconds. Returns 1 if the whole pixel position changed
+	// so the caller only needs to redraw when there is something to draw.
+	uint16_t oldx = motion_x(m);
+	uint16_t oldy = motion_y(m);
+	int32_t top = (KNIGHT_SPEED * m->scale) >> 8;
+	int32_t accel = ((KNIGHT_SPEED / KNIGHT_ACCEL_MS) * m->scale) >> 8; // folded at compile time,
+	int32_t decel = ((KNIGHT_SPEED / KNIGHT_DECEL_MS) * m->scale) >> 8; // no divider on the M0
+	if (dt > MAX_STEP_MS)
+		dt = MAX_STEP_MS;
+	m->vx = approach(m->vx, xdir * top, (xdir ? accel : decel) * (int32_t)dt);
+	m->vy = approach(m->vy, ydir * top, (ydir ? accel : decel) * (int32_t)dt);
+	m->x = clamp(m->x + m->vx * (int32_t)dt, (int32_t)MIN_X << FIX_SHIFT, (int32_t)m->max_x << FIX_SHIFT);
+	m->y = clamp(m->y + m->vy * (int32_t)dt, (int32_t)MIN_Y << FIX_SHIFT, (int32_t)m->max_y << FIX_SHIFT);
+	// Hitting a wall kills the velocity in that direction
+	if (m->x == ((int32_t)MIN_X << FIX_SHIFT) || m->x == ((int32_t)m->max_x << FIX_SHIFT))
+		m->vx = 0;
+	if (m->y == ((int32_t)MIN_Y << FIX_SHIFT) || m->y == ((int32_t)m->max_y << FIX_SHIFT))
+		m->vy = 0;
+	return (motion_x(m) != oldx) || (motion_y(m) != oldy);
+}
+uint16_t motion_x(const Motion *m)
+{
+	return (uint16_t)((m->x + FIX_HALF) >> FIX_SHIFT);
+}
+uint16_t motion_y(const Motion *m)
+{
+	return (uint16_t)((m->y + FIX_HALF) >> FIX_SHIFT);
+}
+int32_t approach(int32_t v, int32_t target, int32_t step)
+{
+	// move v towards target by at most step
+	if (v < target)
+	{
+		v += step;
+		if (v > target)
+			v = target;
+	}
+	else if (v > target)
+	{
+		v -= step;
+		if (v < target)
+			v = target;
+	}
+	return v;
+}
+int32_t clamp(int32_t v, int32_t lo, int32_t hi)
+{
+	if (v < lo)
+		return lo;
+	if (v > hi)
+		return hi;
+	return v;
+}
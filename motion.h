@@ -0,0 +1,16 @@
+#include <stdint.h>
+// Knight movement in Q16.16 fixed point. Velocities are kept in pixels per millisecond
+// so integration against elapsed SysTick time is a multiply and an add.
+typedef struct
+{
+	int32_t x, y;   // Q16.16 pixels
+	int32_t vx, vy; // Q16.16 pixels per millisecond
+	int32_t scale;  // speed scale for the current difficulty, 256 = 1.0
+	uint16_t max_x, max_y; // furthest the sprite may go, from the size of the level
+} Motion;
+void motion_init(Motion *m, uint16_t x, uint16_t y);
+void motion_set_area(Motion *m, uint16_t width, uint16_t height);
+void motion_set_difficulty(Motion *m, int difficulty);
+int motion_update(Motion *m, int xdir, int ydir, uint32_t dt);
+uint16_t motion_x(const Motion *m);
+uint16_t motion_y(const Motion *m);
@@ -0,0 +1,112 @@
+// Generated by tools/gen_tables.c from musical_notes.h, don't edit.
+// TIM14 auto reload values for each note, 65536 / frequency, for playNote.
+// PERIOD_REST is silence.
+#define PERIOD_REST	0
+#define PERIOD_C0	4096
+#define PERIOD_CS0_Db0	3855
+#define PERIOD_D0	3640
+#define PERIOD_DS0_Eb0	3449
+#define PERIOD_E0	3120
+#define PERIOD_F0	2978
+#define PERIOD_FS0_Gb0	2849
+#define PERIOD_G0	2621
+#define PERIOD_GS0_Ab0	2520
+#define PERIOD_A0	2340
+#define PERIOD_AS0_Bb0	2259
+#define PERIOD_B0	2114
+#define PERIOD_C1	1985
+#define PERIOD_CS1_Db1	1872
+#define PERIOD_D1	1771
+#define PERIOD_DS1_Eb1	1680
+#define PERIOD_E1	1598
+#define PERIOD_F1	1489
+#define PERIOD_FS1_Gb1	1424
+#define PERIOD_G1	1337
+#define PERIOD_GS1_Ab1	1260
+#define PERIOD_A1	1191
+#define PERIOD_AS1_Bb1	1129
+#define PERIOD_B1	1057
+#define PERIOD_C2	1008
+#define PERIOD_CS2_Db2	949
+#define PERIOD_D2	897
+#define PERIOD_DS2_Eb2	840
+#define PERIOD_E2	799
+#define PERIOD_F2	753
+#define PERIOD_FS2_Gb2	704
+#define PERIOD_G2	668
+#define PERIOD_GS2_Ab2	630
+#define PERIOD_A2	595
+#define PERIOD_AS2_Bb2	560
+#define PERIOD_B2	532
+#define PERIOD_C3	500
+#define PERIOD_CS3_Db3	471
+#define PERIOD_D3	445
+#define PERIOD_DS3_Eb3	420
+#define PERIOD_E3	397
+#define PERIOD_F3	374
+#define PERIOD_FS3_Gb3	354
+#define PERIOD_G3	334
+#define PERIOD_GS3_Ab3	315
+#define PERIOD_A3	297
+#define PERIOD_AS3_Bb3	281
+#define PERIOD_B3	265
+#define PERIOD_C4	250
+#define PERIOD_CS4_Db4	236
+#define PERIOD_D4	222
+#define PERIOD_DS4_Eb4	210
+#define PERIOD_E4	198
+#define PERIOD_F4	187
+#define PERIOD_FS4_Gb4	177
+#define PERIOD_G4	167
+#define PERIOD_GS4_Ab4	157
+#define PERIOD_A4	148
+#define PERIOD_AS4_Bb4	140
+#define PERIOD_B4	132
+#define PERIOD_C5	125
+#define PERIOD_CS5_Db5	118
+#define PERIOD_D5	111
+#define PERIOD_DS5_Eb5	105
+#define PERIOD_E5	99
+#define PERIOD_F5	93
+#define PERIOD_FS5_Gb5	88
+#define PERIOD_G5	83
+#define PERIOD_GS5_Ab5	78
+#define PERIOD_A5	74
+#define PERIOD_AS5_Bb5	70
+#define PERIOD_B5	66
+#define PERIOD_C6	62
+#define PERIOD_CS6_Db6	59
+#define PERIOD_D6	55
+#define PERIOD_DS6_Eb6	52
+#define PERIOD_E6	49
+#define PERIOD_F6	46
+#define PERIOD_FS6_Gb6	44
+#define PERIOD_G6	41
+#define PERIOD_GS6_Ab6	39
+#define PERIOD_A6	37
+#define PERIOD_AS6_Bb6	35
+#define PERIOD_B6	33
+#define PERIOD_C7	31
+#define PERIOD_CS7_Db7	29
+#define PERIOD_D7	27
+#define PERIOD_DS7_Eb7	26
+#define PERIOD_E7	24
+#define PERIOD_F7	23
+#define PERIOD_FS7_Gb7	22
+#define PERIOD_G7	20
+#define PERIOD_GS7_Ab7	19
+#define PERIOD_A7	18
+#define PERIOD_AS7_Bb7	17
+#define PERIOD_B7	16
+#define PERIOD_C8	15
+#define PERIOD_CS8_Db8	14
+#define PERIOD_D8	13
+#define PERIOD_DS8_Eb8	13
+#define PERIOD_E8	12
+#define PERIOD_F8	11
+#define PERIOD_FS8_Gb8	11
+#define PERIOD_G8	10
+#define PERIOD_GS8_Ab8	9
+#define PERIOD_A8	9
+#define PERIOD_AS8_Bb8	8
+#define PERIOD_B8	8
@@ -0,0 +1,11 @@
+// Generated by tools/gen_tables.c, don't edit.
+// The game's colours as RGBToWord would make them, bytes swapped for the panel.
+#define COLOUR_WHITE	0xffff // 255, 255, 255
+#define COLOUR_BLACK	0x0000 // 0, 0, 0
+#define COLOUR_RED	0x1f00 // 255, 0, 0
+#define COLOUR_GREEN	0xe007 // 0, 255, 0
+#define COLOUR_ORANGE	0xbf05 // 255, 165, 0
+#define COLOUR_PURPLE	0x1080 // 128, 0, 128
+#define COLOUR_CREAM	0xffcf // 255, 255, 204
+#define COLOUR_GREY	0x0842 // 64, 64, 64
+#define COLOUR_DARK_GREY	0x0421 // 32, 32, 32
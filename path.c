@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include "grid.h"
+#include "path.h"
+#include "profile.h"
+#include "watchdog.h"
+#include "timebase.h"
+
+#define COST_STRAIGHT 10
+#define COST_DIAGONAL 14
+#define NO_CELL 0xff
+#define INFINITE_COST 0xffff
+
+static const int8_t step_x[8] = {1, -1, 0, 0, 1, 1, -1, -1};
+static const int8_t step_y[8] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+static uint16_t node_budget = PATH_CELLS; // node expansions per slice, same for every field
+
+static void heap_push(PathHeap *h, uint8_t c);
+static uint8_t heap_pop(PathHeap *h);
+static void heap_fix(PathHeap *h, uint8_t c);
+static int neighbour(const Grid *g, int c, int dir);
+
+void path_set_budget_us(FlowField *f, Grid *grid, uint32_t us)
+{
+	// Expanding a node is the bulk of a slice and costs much the same every time, so
+	// a node count stands in for the time and a slice never needs to read a clock.
+	// Interrupts landing in the timed run only make the estimate safer.
+	uint64_t start, elapsed;
+	uint32_t nodes;
+	grid_clear(grid);
+	flow_init(f, grid);
+	flow_target(f, 0, 0);
+	node_budget = PATH_CELLS;
+	start = time_us();
+	flow_step(f);
+	elapsed = time_us() - start;
+	flow_reset(f);
+	// Every cell was expanded once. time_us counts whole microseconds so allow one more.
+	nodes = (uint32_t)((uint64_t)us * PATH_CELLS / (elapsed + 1));
+	if (nodes < 1)
+		nodes = 1;
+	if (nodes > PATH_CELLS)
+		nodes = PATH_CELLS;
+	node_budget = (uint16_t)nodes;
+}
+void flow_init(FlowField *f, const Grid *grid)
+{
+	f->grid = grid;
+	f->frontier.key = f->cost;
+	flow_reset(f);
+}
+void flow_reset(FlowField *f)
+{
+	f->goal = NO_CELL;
+	f->status = PATH_IDLE;
+}
+void flow_target(FlowField *f, int gx, int gy)
+{
+	// Restart the field only if the goal tile or the grid actually changed. A goal on
+	// a blocked tile can't be reached, so there is no field until it moves off.
+	uint8_t goal;
+	if (grid_blocked(f->grid, gx, gy))
+	{
+		flow_reset(f);
+		return;
+	}
+	goal = (uint8_t)(gy * GRID_COLS + gx);
+	if (goal == f->goal && f->grid_version == f->grid->version)
+		return;
+	f->goal = goal;
+	f->grid_version = f->grid->version;
+	for (int i = 0; i < PATH_CELLS; i++)
+		f->cost[i] = INFINITE_COST;
+	f->frontier.count = 0;
+	f->cost[goal] = 0;
+	heap_push(&f->frontier, goal);
+	f->status = PATH_SEARCHING;
+}
+int flow_step(FlowField *f)
+{
+	// Dijkstra outwards from the goal, at most node_budget nodes per call
+	int budget = node_budget;
+	WATCHDOG_ZONE_ENTER(PROF_PATH);
+	PROFILE_BEGIN(PROF_PATH);
+	while (f->status == PATH_SEARCHING && budget--)
+	{
+		if (f->frontier.count == 0)
+		{
+			f->status = PATH_FOUND;
+			break;
+		}
+		int c = heap_pop(&f->frontier);
+		for (int dir = 0; dir < 8; dir++)
+		{
+			int n = neighbour(f->grid, c, dir);
+			if (n < 0)
+				continue;
+			uint16_t cost = f->cost[c] + (dir < 4 ? COST_STRAIGHT : COST_DIAGONAL);
+			if (cost >= f->cost[n])
+				continue;
+			if (f->cost[n] == INFINITE_COST)
+			{
+				f->cost[n] = cost;
+				heap_push(&f->frontier, (uint8_t)n);
+			}
+			else
+			{
+				f->cost[n] = cost;
+				heap_fix(&f->frontier, (uint8_t)n);
+			}
+		}
+	}
+	PROFILE_END(PROF_PATH);
+	WATCHDOG_ZONE_LEAVE(PROF_PATH);
+	return f->status;
+}
+int flow_direction(const FlowField *f, int tx, int ty, int *dx, int *dy)
+{
+	// Step to the cheapest neighbour once the field is complete. A grid changed since
+	// counts as not ready, flow_target will start it again.
+	int c, best = -1;
+	uint16_t best_cost;
+	if (f->status != PATH_FOUND || f->grid_version != f->grid->version)
+		return PATH_SEARCHING;
+	if (tx < 0 || ty < 0 || tx >= GRID_COLS || ty >= GRID_ROWS)
+		return PATH_NONE;
+	c = ty * GRID_COLS + tx;
+	best_cost = f->cost[c];
+	if (best_cost == INFINITE_COST)
+		return PATH_NONE;
+	for (int dir = 0; dir < 8; dir++)
+	{
+		int n = neighbour(f->grid, c, dir);
+		if (n >= 0 && f->cost[n] < best_cost)
+		{
+			best_cost = f->cost[n];
+			best = dir;
+		}
+	}
+	if (best < 0)
+		return PATH_NONE;
+	*dx = step_x[best];
+	*dy = step_y[best];
+	return PATH_FOUND;
+}
+int neighbour(const Grid *g, int c, int dir)
+{
+	// Neighbouring cell index or -1 if off grid or blocked. Diagonals may not cut a
+	// blocked corner.
+	int x = c % GRID_COLS;
+	int y = c / GRID_COLS;
+	int nx = x + step_x[dir];
+	int ny = y + step_y[dir];
+	if (grid_blocked(g, nx, ny))
+		return -1;
+	if (dir >= 4 && (grid_blocked(g, nx, y) || grid_blocked(g, x, ny)))
+		return -1;
+	return ny * GRID_COLS + nx;
+}
+void heap_push(PathHeap *h, uint8_t c)
+{
+	int i = h->count++;
+	h->cell[i] = c;
+	heap_fix(h, c);
+}
+uint8_t heap_pop(PathHeap *h)
+{
+	uint8_t top = h->cell[0];
+	uint8_t last = h->cell[--h->count];
+	int i = 0;
+	// sift the last element down from the root
+	while (1)
+	{
+		int child = 2 * i + 1;
+		if (child >= h->count)
+			break;
+		if (child + 1 < h->count && h->key[h->cell[child + 1]] < h->key[h->cell[child]])
+			child++;
+		if (h->key[h->cell[child]] >= h->key[last])
+			break;
+		h->cell[i] = h->cell[child];
+		i = child;
+	}
+	if (h->count > 0)
+		h->cell[i] = last;
+	return top;
+}
+void heap_fix(PathHeap *h, uint8_t c)
+{
+	// Key of c has decreased (or c was just appended), sift it up
+	int i = 0;
+	while (h->cell[i] != c)
+		i++;
+	while (i > 0)
+	{
+		int up = (i - 1) / 2;
+		if (h->key[h->cell[up]] <= h->key[c])
+			break;
+		h->cell[i] = h->cell[up];
+		i = up;
+	}
+	h->cell[i] = c;
+}
@@ -0,0 +1,47 @@
+#ifndef PATH_H
+#define PATH_H
+#include <stdint.h>
+#include "grid.h"
+
+#define PATH_CELLS (GRID_COLS * GRID_ROWS)
+
+// Search status
+#define PATH_IDLE 0
+#define PATH_SEARCHING 1
+#define PATH_FOUND 2
+#define PATH_NONE 3
+
+// Fixed size binary min-heap of cell indices ordered by key[]
+typedef struct
+{
+	uint8_t cell[PATH_CELLS];
+	uint8_t count;
+	const uint16_t *key;
+} PathHeap;
+
+// Flow field towards one goal tile over one grid, shared by every chaser on it
+typedef struct
+{
+	const Grid *grid;
+	PathHeap frontier;
+	uint16_t cost[PATH_CELLS];
+	uint8_t goal;
+	uint8_t status;
+	uint8_t grid_version; // the grid's version when the field was started
+} FlowField;
+
+// Times a whole field over an empty grid to find what a node costs on this part, then
+// limits each flow_step to what fits in us. Call once at start up, it clears grid and
+// leaves f set up on it with no field.
+void path_set_budget_us(FlowField *f, Grid *grid, uint32_t us);
+
+// The field is advanced with flow_step(). flow_target starts it again when the goal
+// moves or a tile of the grid has changed since, flow_reset drops it.
+void flow_init(FlowField *f, const Grid *grid);
+void flow_reset(FlowField *f);
+void flow_target(FlowField *f, int gx, int gy);
+int flow_step(FlowField *f);
+// PATH_FOUND with the step to take, PATH_SEARCHING while the field isn't ready or
+// PATH_NONE if the tile can't reach the goal
+int flow_direction(const FlowField *f, int tx, int ty, int *dx, int *dy);
+#endif
@@ -0,0 +1,200 @@
+#include <stm32f031x6.h>
+#include "power.h"
+#include "display.h"
+#include "serial.h"
+#include "watchdog.h"
+
+// How long the menus may sit without a button press before the panel is put to sleep
+// and the core drops into stop mode.
+#define IDLE_TIMEOUT_MS 20000
+
+// Buttons are active low with pull-ups: PB4 (right), PB5 (left), PA8 and PA11 (up/down)
+#define BUTTONS_PRESSED() ( ((GPIOB->IDR & ((1 << 4) | (1 << 5))) != ((1 << 4) | (1 << 5))) || \
+                            ((GPIOA->IDR & ((1 << 8) | (1 << 11))) != ((1 << 8) | (1 << 11))) )
+
+// The IWDG can't be paused in stop mode, so the RTC alarm wakes the core once a second
+// to kick it. RTC alarm A is on EXTI line 17.
+#define ALARM_LINE (1 << 17)
+
+void initClock(void);
+extern volatile uint32_t milliseconds_uptime;
+
+static uint32_t last_activity = 0; // milliseconds_uptime of the last button press
+static uint32_t idle_cycles = 0;   // part of a millisecond spent in WFI, in core clock cycles
+static uint32_t idle_ms = 0;       // whole milliseconds spent in WFI since the last report
+static uint32_t total_start = 0;   // milliseconds_uptime at the last report
+static uint32_t stop_count = 0;    // number of times stop mode was entered
+static uint32_t stop_ms = 0;       // time spent in stop mode, which milliseconds_uptime misses
+static volatile uint8_t button_woke = 0; // set by a button edge while stopped
+
+static void init_alarm(void);
+
+void initPower()
+{
+	RCC->APB2ENR |= (1 << 0);  // enable SYSCFG so the EXTI lines can be routed to port B
+	RCC->APB1ENR |= (1 << 28); // enable the PWR block for stop mode control
+	// Route EXTI4 and EXTI5 to PB4 and PB5, EXTI8 and EXTI11 stay on port A
+	SYSCFG->EXTICR[1] &= ~(0xffu);
+	SYSCFG->EXTICR[1] |= (1 << 0) | (1 << 4);
+	SYSCFG->EXTICR[2] &= ~((0x0fu << 0) | (0x0fu << 12));
+	// Buttons pull the pin low so wake on the falling edge
+	EXTI->FTSR |= (1 << 4) | (1 << 5) | (1 << 8) | (1 << 11);
+	EXTI->RTSR &= ~((1u << 4) | (1u << 5) | (1u << 8) | (1u << 11));
+	EXTI->IMR &= ~((1u << 4) | (1u << 5) | (1u << 8) | (1u << 11)); // only unmasked while idling
+	NVIC_EnableIRQ(EXTI4_15_IRQn);
+	init_alarm();
+	last_activity = milliseconds_uptime;
+	total_start = milliseconds_uptime;
+}
+void EXTI4_15_IRQHandler(void)
+{
+	// Nothing to do here other than acknowledge, the wake up is the point.
+	EXTI->PR = (1 << 4) | (1 << 5) | (1 << 8) | (1 << 11);
+	button_woke = 1;
+}
+void RTC_IRQHandler(void)
+{
+	RTC->ISR &= ~(1u << 8); // ALRAF
+	EXTI->PR = ALARM_LINE;
+}
+static void init_alarm()
+{
+	// Run the RTC from the LSI (which the IWDG has on anyway) at 1Hz and have alarm A
+	// match every second: all four fields masked. The RTC sits in the backup domain,
+	// which keeps its settings over a warm reset.
+	PWR->CR |= (1 << 8); // DBP, allow writes to the backup domain
+	RCC->CSR |= (1 << 0); // LSION
+	while ((RCC->CSR & (1 << 1)) == 0); // LSIRDY
+	if ((RCC->BDCR & (3u << 8)) != (2u << 8))
+	{
+		// The clock source can only be changed after a backup domain reset
+		RCC->BDCR |= (1 << 16);
+		RCC->BDCR &= ~(1u << 16);
+		RCC->BDCR |= (2 << 8); // RTCSEL = LSI
+	}
+	RCC->BDCR |= (1 << 15); // RTCEN
+	RTC->WPR = 0xca; // unlock the RTC registers
+	RTC->WPR = 0x53;
+	RTC->ISR |= (1 << 7); // INIT
+	while ((RTC->ISR & (1 << 6)) == 0); // INITF
+	RTC->PRER = 399;                // synchronous prescaler first
+	RTC->PRER = (99 << 16) | 399;   // 40kHz / 100 / 400 = 1Hz
+	RTC->ISR &= ~(1u << 7);
+	RTC->CR &= ~(1u << 8); // ALRAE off while it is set up
+	while ((RTC->ISR & (1 << 0)) == 0); // ALRAWF
+	RTC->ALRMAR = (1u << 31) | (1 << 23) | (1 << 15) | (1 << 7); // MSK4..MSK1
+	RTC->CR |= (1 << 12) | (1 << 8); // ALRAIE, ALRAE
+	RTC->WPR = 0xff; // lock them again
+	EXTI->RTSR |= ALARM_LINE;
+	EXTI->IMR &= ~ALARM_LINE; // only unmasked while stopped
+	NVIC_EnableIRQ(RTC_IRQn);
+}
+void power_sleep()
+{
+	// Sleep until the next interrupt (normally the 1ms SysTick) and account for the
+	// time spent asleep using the SysTick down counter so the figure is sub-millisecond.
+	uint32_t start_ms = milliseconds_uptime;
+	uint32_t start_val = SysTick->VAL;
+	uint32_t end_ms, end_val, reload;
+	__asm(" wfi ");
+	end_val = SysTick->VAL;
+	end_ms = milliseconds_uptime;
+	reload = SysTick->LOAD + 1;
+	if (end_ms == start_ms)
+		idle_cycles += start_val - end_val;
+	else
+		idle_cycles += start_val + (reload - end_val) + (end_ms - start_ms - 1) * reload;
+	while (idle_cycles >= reload)
+	{
+		idle_cycles -= reload;
+		idle_ms++;
+	}
+}
+void power_activity()
+{
+	last_activity = milliseconds_uptime;
+}
+static void power_stop()
+{
+	// Blank the panel, stop the core until a button edge arrives, then bring
+	// the PLL and panel back up again. The alarm wakes it every second in between,
+	// long enough to kick the watchdog and stop again on the HSI.
+	display_sleep();
+	stop_count++;
+	button_woke = 0;
+	EXTI->PR = (1 << 4) | (1 << 5) | (1 << 8) | (1 << 11) | ALARM_LINE;
+	RTC->ISR &= ~(1u << 8); // a stale ALRAF would hide the next alarm's edge
+	EXTI->IMR |= (1 << 4) | (1 << 5) | (1 << 8) | (1 << 11) | ALARM_LINE;
+	SysTick->CTRL &= ~(1u << 1); // no SysTick interrupt while stopped
+	PWR->CR = (PWR->CR & ~(3u)) | (1 << 0); // stop mode with the regulator in low power
+	SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+	while (!button_woke)
+	{
+		watchdog_kick();
+		__asm(" wfi ");
+		if (!button_woke)
+			stop_ms += 1000; // the alarm, a second gone. The part second before a button is lost.
+	}
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+	// We come out of stop mode running from HSI, put the 48MHz PLL back
+	initClock();
+	SysTick->CTRL |= (1 << 1);
+	EXTI->IMR &= ~((1u << 4) | (1u << 5) | (1u << 8) | (1u << 11) | ALARM_LINE);
+	display_wake();
+	// Swallow the press that woke us so it doesn't also make a menu selection. The
+	// frame loop isn't running to kick the watchdog while it is held.
+	while (BUTTONS_PRESSED())
+	{
+		watchdog_kick();
+		power_sleep();
+	}
+	last_activity = milliseconds_uptime;
+}
+void power_idle()
+{
+	// Called from loops that are only waiting on a button
+	if (BUTTONS_PRESSED())
+	{
+		last_activity = milliseconds_uptime;
+		return;
+	}
+	if ((milliseconds_uptime - last_activity) >= IDLE_TIMEOUT_MS)
+		power_stop();
+	else
+		power_sleep();
+}
+uint32_t power_idle_percent()
+{
+	// SysTick is off in stop mode, so the time stopped counts as idle on top of uptime.
+	// Past the first 100ms divide the total down rather than multiply idle up, idle * 100
+	// would overflow after 11.9 hours.
+	uint32_t total_ms = (milliseconds_uptime - total_start) + stop_ms;
+	uint32_t idle = idle_ms + stop_ms;
+	if (total_ms == 0)
+		return 0;
+	if (idle > total_ms)
+		idle = total_ms;
+	if (total_ms < 100)
+		return (idle * 100) / total_ms;
+	idle /= total_ms / 100;
+	return (idle > 100) ? 100 : idle;
+}
+void power_report()
+{
+	// Dump active vs idle duty cycle since the last report and start a new window
+	uint32_t idle = power_idle_percent();
+	eputs("Power: idle ");
+	printDecimal((int32_t)idle);
+	eputs("% active ");
+	printDecimal((int32_t)(100 - idle));
+	eputs("% stops ");
+	printDecimal((int32_t)stop_count);
+	eputs(" stopped_s ");
+	printDecimal((int32_t)(stop_ms / 1000));
+	eputs("\r\n");
+	idle_cycles = 0;
+	idle_ms = 0;
+	stop_count = 0;
+	stop_ms = 0;
+	total_start = milliseconds_uptime;
+}
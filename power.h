@@ -0,0 +1,7 @@
+#include <stdint.h>
+void initPower(void);
+void power_sleep(void);
+void power_idle(void);
+void power_activity(void);
+void power_report(void);
+uint32_t power_idle_percent(void);
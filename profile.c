@@ -0,0 +1,103 @@
+#include <stm32f031x6.h>
+#include "profile.h"
+
+static const char *const zone_names[PROF_COUNT] =
+{
+	"frame",
+	"level",
+	"putImage",
+	"isInside",
+	"play_music",
+	"serial_log",
+	"enemies",
+	"path",
+};
+
+const char *profile_zone_name(int zone)
+{
+	// Also used on zone numbers read back from the crash record, which may be garbage
+	if (zone < 0 || zone >= PROF_COUNT)
+		return "?";
+	return zone_names[zone];
+}
+
+#ifdef PROFILE
+#include "serial.h"
+
+// TIM2 is the only 32 bit timer on the F031. Left free running at the core clock its
+// count is a cycle counter that wraps every 89 seconds, which unsigned subtraction
+// copes with as long as no single zone runs that long.
+
+typedef struct
+{
+	uint32_t start;  // TIM2 count at the last profile_begin
+	uint32_t calls;
+	uint32_t max;    // longest single call in cycles
+	uint64_t total;  // cycles summed over all calls
+} Zone;
+
+static Zone zones[PROF_COUNT];
+static uint32_t overhead = 0; // cycles a back to back begin/end pair costs on its own
+
+void profile_init()
+{
+	RCC->APB1ENR |= (1 << 0); // enable TIM2
+	TIM2->CR1 = 0;
+	TIM2->PSC = 0;            // count at the full 48MHz
+	TIM2->ARR = 0xffffffff;
+	TIM2->CNT = 0;
+	TIM2->EGR = 1;            // load the prescaler
+	TIM2->CR1 |= (1 << 0);
+	// Time an empty zone so the markers themselves don't show up in the figures
+	overhead = 0;
+	profile_begin(PROF_FRAME);
+	profile_end(PROF_FRAME);
+	overhead = zones[PROF_FRAME].total;
+	profile_reset();
+}
+void profile_begin(int zone)
+{
+	zones[zone].start = TIM2->CNT;
+}
+void profile_end(int zone)
+{
+	uint32_t cycles = TIM2->CNT - zones[zone].start;
+	Zone *z = &zones[zone];
+	cycles = (cycles > overhead) ? cycles - overhead : 0;
+	z->calls++;
+	z->total += cycles;
+	if (cycles > z->max)
+		z->max = cycles;
+}
+void profile_reset()
+{
+	for (int i = 0; i < PROF_COUNT; i++)
+	{
+		zones[i].calls = 0;
+		zones[i].max = 0;
+		zones[i].total = 0;
+	}
+}
+void profile_dump()
+{
+	// One line per zone: calls, total time in microseconds, mean and worst call in cycles
+	eputs("Profile: zone calls total_us mean_cyc max_cyc\r\n");
+	for (int i = 0; i < PROF_COUNT; i++)
+	{
+		Zone *z = &zones[i];
+		if (z->calls == 0)
+			continue;
+		eputs((char *)zone_names[i]);
+		eputs(" ");
+		printDecimal((int32_t)z->calls);
+		eputs(" ");
+		printDecimal((int32_t)(z->total / 48));
+		eputs(" ");
+		printDecimal((int32_t)(z->total / z->calls));
+		eputs(" ");
+		printDecimal((int32_t)z->max);
+		eputs("\r\n");
+	}
+	profile_reset();
+}
+#endif
@@ -0,0 +1,45 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+#include <stdint.h>
+
+// Define PROFILE (here or with -DPROFILE on the compiler command line) to build the
+// zone profiler in. Without it the markers below compile to nothing. The watchdog's
+// crash record names zones by these numbers too, see WATCHDOG_ZONE_ENTER.
+//#define PROFILE
+
+// Zones are fixed at compile time, add new ones before PROF_COUNT and give them a
+// name in profile.c
+enum
+{
+	PROF_FRAME,     // one pass of the main loop, excluding the frame delay
+	PROF_LEVEL,     // Level_Start
+	PROF_PUTIMAGE,
+	PROF_ISINSIDE,
+	PROF_MUSIC,     // play_music
+	PROF_SERIAL_LOG,
+	PROF_ENEMIES,   // enemies_update
+	PROF_PATH,      // flow_step, one slice of the flow field
+	PROF_COUNT
+};
+
+const char *profile_zone_name(int zone);
+
+#ifdef PROFILE
+void profile_init(void);
+void profile_begin(int zone);
+void profile_end(int zone);
+void profile_dump(void);
+void profile_reset(void);
+#define PROFILE_INIT()       profile_init()
+#define PROFILE_BEGIN(zone)  profile_begin(zone)
+#define PROFILE_END(zone)    profile_end(zone)
+#define PROFILE_DUMP()       profile_dump()
+#define PROFILE_RESET()      profile_reset()
+#else
+#define PROFILE_INIT()       ((void)0)
+#define PROFILE_BEGIN(zone)  ((void)0)
+#define PROFILE_END(zone)    ((void)0)
+#define PROFILE_DUMP()       ((void)0)
+#define PROFILE_RESET()      ((void)0)
+#endif
+#endif
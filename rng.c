@@ -0,0 +1,70 @@
+#include <stdint.h>
+#include "rng.h"
+
+// xorshift32 (Marsaglia 2003). Period is 2^32-1 over every non-zero state,
+// zero is the one state it can never leave so it is never allowed.
+#define DEFAULT_STATE 2463534242u
+
+static uint32_t state = DEFAULT_STATE;
+
+void rng_seed(uint32_t seed)
+{
+	state = seed ? seed : DEFAULT_STATE;
+}
+uint32_t rng_next()
+{
+	uint32_t x = state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	state = x;
+	return x;
+}
+uint32_t rng_below(uint32_t bound)
+{
+	// Uniform value in 0..bound-1. Draws are masked down to the smallest power of two
+	// covering the range and out of range values rejected, so there is no modulo
+	// bias (and no division, which the M0 would have to do in software).
+	uint32_t mask, r;
+	if (bound <= 1)
+		return 0;
+	mask = bound - 1;
+	mask |= mask >> 1;
+	mask |= mask >> 2;
+	mask |= mask >> 4;
+	mask |= mask >> 8;
+	mask |= mask >> 16;
+	do
+	{
+		r = rng_next() & mask;
+	} while (r >= bound);
+	return r;
+}
+uint32_t rng_range(uint32_t lower, uint32_t upper)
+{
+	// Uniform value in lower..upper-1
+	if (upper <= lower)
+		return lower;
+	return lower + rng_below(upper - lower);
+}
+void rng_fill(uint32_t *buffer, uint32_t count)
+{
+	uint32_t x = state;
+	while (count--)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		*buffer++ = x;
+	}
+	state = x;
+}
+uint32_t rng_save()
+{
+	// The whole generator state is one word, handy for recording replays
+	return state;
+}
+void rng_restore(uint32_t saved)
+{
+	rng_seed(saved);
+}
@@ -0,0 +1,8 @@
+#include <stdint.h>
+void rng_seed(uint32_t seed);
+uint32_t rng_next(void);
+uint32_t rng_below(uint32_t bound);
+uint32_t rng_range(uint32_t lower, uint32_t upper);
+void rng_fill(uint32_t *buffer, uint32_t count);
+uint32_t rng_save(void);
+void rng_restore(uint32_t state);
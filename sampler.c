@@ -0,0 +1,111 @@
+#include <stm32f031x6.h>
+#include "sampler.h"
+#ifdef SAMPLER
+#include "serial.h"
+#include "watchdog.h"
+
+// Every TIM16 interrupt looks at the return address the core stacked on exception
+// entry, i.e. the PC that was interrupted, and counts it in a histogram of flash.
+// tools/sampler_symbolize.py turns the dump into a flat per-function profile.
+
+static uint16_t histogram[SAMPLER_BUCKETS];
+static uint32_t outside = 0; // samples that were not in flash (RAM code, other handlers)
+static uint32_t samples = 0;
+static uint32_t rate = 0;
+
+void sampler_record(uint32_t *frame);
+void TIM16_IRQHandler(void) __attribute__((naked));
+
+void TIM16_IRQHandler(void)
+{
+	// Naked so the compiler doesn't push anything: pick whichever stack the frame was
+	// pushed to and hand it to sampler_record, which returns straight from the exception.
+	__asm volatile(
+		" movs r0, #4 \n"
+		" mov r1, lr \n"
+		" tst r0, r1 \n"
+		" beq 1f \n"
+		" mrs r0, psp \n"
+		" b 2f \n"
+		"1: \n"
+		" mrs r0, msp \n"
+		"2: \n"
+		" ldr r1, =sampler_record \n"
+		" bx r1 \n"
+		" .ltorg \n"
+	);
+}
+void sampler_record(uint32_t *frame)
+{
+	// The hardware frame is r0-r3, r12, lr, pc, xpsr
+	uint32_t pc = frame[6] - SAMPLER_FLASH_BASE;
+	TIM16->SR = 0;
+	samples++;
+	if (pc < SAMPLER_FLASH_SIZE)
+	{
+		uint16_t *bucket = &histogram[pc >> SAMPLER_BUCKET_SHIFT];
+		if (*bucket != 0xffff)
+			(*bucket)++;
+	}
+	else
+	{
+		outside++;
+	}
+}
+void sampler_start(uint32_t rate_hz)
+{
+	// A rate that isn't a multiple of 1kHz keeps the samples from locking to SysTick
+	RCC->APB2ENR |= (1 << 17); // enable TIM16
+	TIM16->CR1 = 0;
+	TIM16->PSC = 47;           // 1MHz count
+	TIM16->ARR = 1000000 / rate_hz - 1;
+	TIM16->CNT = 0;
+	TIM16->EGR = 1;
+	TIM16->SR = 0;
+	TIM16->DIER |= (1 << 0);   // interrupt on update
+	rate = rate_hz;
+	NVIC_SetPriority(TIM16_IRQn, 0); // highest, so it can sample the other handlers' callers
+	NVIC_EnableIRQ(TIM16_IRQn);
+	TIM16->CR1 |= (1 << 0);
+}
+void sampler_stop()
+{
+	TIM16->CR1 &= ~(1u << 0);
+	NVIC_DisableIRQ(TIM16_IRQn);
+}
+void sampler_dump()
+{
+	// Format read by tools/sampler_symbolize.py:
+	//   Sampler: <rate> <shift> <samples> <outside>
+	//   S <bucket address> <count>   (one line per non-empty bucket)
+	//   Sampler end
+	int running = (TIM16->CR1 & 1);
+	sampler_stop();
+	eputs("Sampler: ");
+	printDecimal((int32_t)rate);
+	eputs(" ");
+	printDecimal(SAMPLER_BUCKET_SHIFT);
+	eputs(" ");
+	printDecimal((int32_t)samples);
+	eputs(" ");
+	printDecimal((int32_t)outside);
+	eputs("\r\n");
+	for (uint32_t i = 0; i < SAMPLER_BUCKETS; i++)
+	{
+		if (histogram[i] == 0)
+			continue;
+		eputs("S ");
+		printDecimal((int32_t)(SAMPLER_FLASH_BASE + (i << SAMPLER_BUCKET_SHIFT)));
+		eputs(" ");
+		printDecimal(histogram[i]);
+		eputs("\r\n");
+		histogram[i] = 0;
+		watchdog_kick(); // a full dump takes seconds at 9600 baud
+	}
+	eputs("Sampler end\r\n");
+	samples = 0;
+	outside = 0;
+	if (running)
+		sampler_start(rate);
+}
+#endif
@@ -0,0 +1,26 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+#include <stdint.h>
+
+// Define SAMPLER (here or with -DSAMPLER) to build the statistical profiler in. It
+// uses TIM16 and SAMPLER_BUCKETS * 2 bytes of RAM, so it is left out normally.
+//#define SAMPLER
+
+#define SAMPLER_FLASH_BASE 0x08000000u
+#define SAMPLER_FLASH_SIZE (32u * 1024u)
+#define SAMPLER_BUCKET_SHIFT 7 // 128 bytes of code per histogram bucket
+#define SAMPLER_BUCKETS (SAMPLER_FLASH_SIZE >> SAMPLER_BUCKET_SHIFT)
+
+#ifdef SAMPLER
+void sampler_start(uint32_t rate_hz);
+void sampler_stop(void);
+void sampler_dump(void);
+#define SAMPLER_START(hz) sampler_start(hz)
+#define SAMPLER_STOP()    sampler_stop()
+#define SAMPLER_DUMP()    sampler_dump()
+#else
+#define SAMPLER_START(hz) ((void)0)
+#define SAMPLER_STOP()    ((void)0)
+#define SAMPLER_DUMP()    ((void)0)
+#endif
+#endif
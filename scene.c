@@ -0,0 +1,135 @@
+#include <stm32f031x6.h>
+#include "scene.h"
+#include "serial.h"
+#include "transition.h"
+#include "timebase.h"
+
+#define MAX_CHAINED 4   // changes requested from enter hooks that are followed in one frame
+#define LATENCY_LOG 8   // transitions remembered until the next scene_report
+
+// A transition's latency runs from the scene_change call to the end of the new
+// scene's first render, i.e. until the new screen is actually on the panel.
+typedef struct
+{
+	const Scene *from;
+	const Scene *to;
+	uint32_t us;
+} Latency;
+
+static const Scene *current = 0;
+static const Scene *pending = 0;
+static int entered = 0;            // current's enter has run, i.e. its transition is over
+static uint32_t requested_at = 0;  // microseconds, when pending was asked for
+static const Scene *measuring_from = 0;
+static const Scene *measuring_to = 0;
+static Latency latencies[LATENCY_LOG];
+static uint8_t latency_count = 0;
+static uint8_t latency_next = 0;
+static uint32_t latency_worst = 0;
+static uint32_t replaced = 0;      // requests overridden by a later one in the same frame
+
+void scene_start(const Scene *first)
+{
+	current = 0;
+	scene_change(first);
+}
+void scene_change(const Scene *next)
+{
+	// Only takes effect at the start of the next scene_frame, so the calling scene
+	// finishes its update and render first. If one is already waiting the last request
+	// wins, the latency still counts from the first.
+	if (pending == 0)
+		requested_at = (uint32_t)time_us();
+	else if (pending != next)
+		replaced++;
+	pending = next;
+}
+const Scene *scene_current()
+{
+	return current;
+}
+static void switch_scene(void)
+{
+	for (int i = 0; pending && i < MAX_CHAINED; i++)
+	{
+		const Scene *next = pending;
+		pending = 0;
+		if (current && current->exit)
+			current->exit();
+		if (measuring_to == 0)
+			measuring_from = current;
+		measuring_to = next;
+		current = next;
+		entered = 0;
+		transition_start(current->transition, 0);
+		if (transition_busy())
+			return;
+		if (current->enter)
+			current->enter();
+		entered = 1;
+	}
+}
+void scene_frame(uint32_t now)
+{
+	uint32_t started = requested_at;
+	if (pending)
+		switch_scene();
+	if (current == 0)
+		return;
+	if (!entered)
+	{
+		// Still clearing the old screen, nothing of the new scene runs until that's done.
+		// The last step gets a frame to itself so it doesn't share the budget with enter.
+		if (transition_busy())
+		{
+			transition_step();
+			return;
+		}
+		if (current->enter)
+			current->enter();
+		entered = 1;
+		if (pending)
+			return;
+	}
+	if (current->update)
+		current->update(now);
+	if (current->render)
+		current->render();
+	if (measuring_to)
+	{
+		Latency *l = &latencies[latency_next];
+		l->from = measuring_from;
+		l->to = measuring_to;
+		l->us = (uint32_t)time_us() - started;
+		if (l->us > latency_worst)
+			latency_worst = l->us;
+		latency_next = (latency_next + 1) % LATENCY_LOG;
+		if (latency_count < LATENCY_LOG)
+			latency_count++;
+		measuring_to = 0;
+	}
+}
+void scene_report()
+{
+	// Dump the transitions since the last report, oldest first
+	int first = (latency_next + LATENCY_LOG - latency_count) % LATENCY_LOG;
+	for (int i = 0; i < latency_count; i++)
+	{
+		Latency *l = &latencies[(first + i) % LATENCY_LOG];
+		eputs("Scene: ");
+		eputs((char *)(l->from ? l->from->name : "boot"));
+		eputs(" -> ");
+		eputs((char *)l->to->name);
+		eputs(" ");
+		printDecimal((int32_t)l->us);
+		eputs("us\r\n");
+	}
+	eputs("Scene: worst ");
+	printDecimal((int32_t)latency_worst);
+	eputs("us replaced ");
+	printDecimal((int32_t)replaced);
+	eputs("\r\n");
+	latency_count = 0;
+	latency_worst = 0;
+	replaced = 0;
+}
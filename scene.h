@@ -0,0 +1,27 @@
+#ifndef SCENE_H
+#define SCENE_H
+#include <stdint.h>
+
+// One screen of the game. Any hook may be 0. update handles input and game logic and
+// may ask for a scene_change, render draws. None of them may block: the frame loop calls
+// update and render once per frame so music, logging and power management keep running.
+// If a scene asks for more than one change before the next frame, the last one is taken.
+// On a change the old scene's exit runs, the transition clears the screen over as many
+// frames as its pixel budget needs, and the new scene's enter runs on the frame after.
+typedef struct
+{
+	const char *name;
+	void (*enter)(void);
+	void (*update)(uint32_t now);
+	void (*render)(void);
+	void (*exit)(void);
+	uint8_t idle; // only waiting on a button, the frame loop may power the panel down
+	uint8_t transition; // how the old screen is cleared on the way in, see transition.h
+} Scene;
+
+void scene_start(const Scene *first);
+void scene_change(const Scene *next);
+void scene_frame(uint32_t now);
+const Scene *scene_current(void);
+void scene_report(void);
+#endif
@@ -1,4 +1,5 @@
 #include <stm32f031x6.h>
+#include "format.h"
 
 void initSerial()
 {
@@ -44,25 +45,10 @@ void eputs(char *String)
 }
 void printDecimal(int32_t Value)
 {
-	char DecimalString[12]; // a 32 bit value range from -2 billion to +2 billion approx
-												// That's 10 digits
-												// plus a null character, plus a sign
-	DecimalString[11] = 0; // terminate the string;
-	if (Value < 0)
-	{
-		DecimalString[0]='-';
-		Value = -Value;
-	}
-	else
-	{
-		DecimalString[0]='+';
-	}
-	int index = 10;
-	while(index > 0)
-	{
-		DecimalString[index]=(Value % 10) + '0';
-		Value = Value / 10;
-		index--;
-	}
+	// Always a sign and ten digits so columns in the logs line up, e.g. +0000000042
+	char DecimalString[12];
+	uint32_t Magnitude = (Value < 0) ? 0u - (uint32_t)Value : (uint32_t)Value;
+	DecimalString[0] = (Value < 0) ? '-' : '+';
+	fmt_uint_pad(&DecimalString[1], Magnitude, 10, '0');
 	eputs(DecimalString);
 }
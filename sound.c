@@ -1,11 +1,12 @@
 #include <stm32f031x6.h>
-#include "musical_notes.h"
+#include "note_periods.h"
 void pinMode(GPIO_TypeDef *Port, uint32_t BitNumber, uint32_t Mode);
-void playNote(uint32_t Freq)
+void playNote(uint16_t Period)
 {	
-	// Counter is running at 65536 Hz 
-	TIM14->ARR = (uint32_t)65536/((uint32_t)Freq); 
-	TIM14->CCR1 = TIM14->ARR/2;	
+	// Counter is running at 65536 Hz, Period is 65536/frequency from note_periods.h
+	// (PERIOD_REST, 0, is silence)
+	TIM14->ARR = Period; 
+	TIM14->CCR1 = Period/2;	
 	TIM14->CNT = 0; // set the count to zero initially
 	TIM14->CR1 |= (1 << 0); // and enable the counter
 }
@@ -20,7 +21,7 @@ void initSound()
 	TIM14->CCER |= (1 << 0);
 	TIM14->PSC = 48000000UL/65536UL; // Use the prescaled to set the counter running at 65536 Hz
 									 // yields maximum frequency of 21kHz when ARR = 2;
-	TIM14->ARR = (48000000UL/(uint32_t)(TIM14->PSC))/((uint32_t)C4);
-	TIM14->CCR1 = TIM14->ARR/2;	
+	TIM14->ARR = PERIOD_C4;
+	TIM14->CCR1 = PERIOD_C4/2;	
 	TIM14->CNT = 0;
 }
\ No newline at end of file
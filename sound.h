@@ -1,3 +1,3 @@
 #include <stdint.h>
-void playNote(uint32_t Freq);
+void playNote(uint16_t Period);
 void initSound(void);
\ No newline at end of file
@@ -0,0 +1,411 @@
+#include <stdint.h>
+#include "sprites.h"
+
+// Every sprite in the game back to back in the order of the ids in sprites.h. The
+// colours are already byte swapped the way the panel wants them, see RGBToWord.
+const uint16_t sprite_atlas[SPRITE_COUNT * SPRITE_PIXELS] =
+{
+	// SPRITE_KNIGHT1: Array to store the first animation frame of the knight sprite
+	0,0,0,0,34617,34617,34617,34617,34617,0,0,0,
+	0,0,0,34617,43866,4492,4492,54437,54437,34617,0,0,
+	0,0,0,34617,43866,4492,34617,34617,34617,34617,0,0,
+	0,0,0,34617,43866,4492,4492,34617,54437,34617,0,0,
+	0,0,0,34617,43866,4492,4492,34617,54437,34617,0,0,
+	0,34617,34617,34617,34617,34617,34617,34617,34617,34617,34617,0,
+	34617,65288,65288,65288,65288,65288,65288,4492,34617,54437,54437,34617,
+	34617,65288,65288,65288,65288,65288,65288,4492,4492,34617,54437,34617,
+	34617,65288,65288,16135,16135,65288,65288,4492,4492,34617,54437,34617,
+	34617,65288,65288,16135,16135,65288,65288,4492,4492,34617,54437,34617,
+	34617,65288,65288,65288,65288,65288,65288,4492,4492,34617,34617,34617,
+	0,34617,65288,65288,65288,65288,34617,43866,4492,4492,34617,0,
+	0,0,34617,65288,65288,34617,34617,34617,4492,4492,34617,0,
+	0,0,0,34617,34617,34617,0,0,34617,4492,34617,0,
+	0,0,0,34617,43866,34617,0,0,34617,4492,34617,0,
+	0,0,0,34617,43866,0,0,0,0,4492,34617,0,
+
+	// SPRITE_KNIGHT2: Array to store the second animation frame of the knight sprite
+	0,0,0,0,34617,34617,34617,34617,34617,0,0,0,
+	0,0,0,34617,43866,4492,4492,54437,54437,34617,0,0,
+	0,0,0,34617,43866,4492,34617,34617,34617,34617,0,0,
+	0,0,0,34617,43866,4492,4492,34617,54437,34617,0,0,
+	0,0,0,34617,43866,4492,4492,34617,54437,34617,0,0,
+	0,0,34617,34617,34617,34617,34617,34617,34617,34617,34617,0,
+	0,34617,65288,65288,65288,65288,65288,65288,34617,54437,54437,34617,
+	0,34617,65288,65288,65288,65288,65288,65288,4492,34617,54437,34617,
+	0,34617,65288,65288,16135,16135,65288,65288,4492,34617,54437,54437,
+	0,34617,65288,65288,16135,16135,65288,65288,4492,34617,34617,34617,
+	0,34617,65288,65288,65288,65288,65288,65288,4492,34617,0,0,
+	0,0,34617,65288,65288,65288,65288,34617,4492,4492,34617,0,
+	0,0,0,34617,65288,65288,34617,43866,4492,4492,34617,0,
+	0,0,0,34617,34617,34617,0,0,0,34617,4492,34617,
+	0,0,0,34617,43866,34617,0,0,0,34617,4492,34617,
+	0,0,34617,43866,34617,0,0,0,0,0,0,0,
+
+	// SPRITE_KNIGHT3: Array to store the third animation frame of the knight sprite
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,34617,34617,34617,34617,0,0,0,0,
+	0,0,0,34617,34617,34617,34617,34617,34617,0,0,0,
+	0,4492,4492,34617,34617,34617,34617,34617,34617,4492,4492,0,
+	0,34617,34617,34617,34617,34617,34617,34617,34617,34617,34617,0,
+	0,4492,4492,34617,34617,34617,34617,34617,34617,4492,4492,0,
+	0,0,0,0,34617,34617,34617,34617,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_SPIKE: Array to store the graphical representation of a spike obstacle
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,50737,0,0,0,0,0,0,0,
+	0,0,0,0,50737,0,0,0,0,0,0,0,
+	0,0,0,0,50737,50737,0,0,0,0,0,0,
+	0,0,0,50737,65535,50737,0,0,0,0,0,0,
+	0,0,0,50737,65535,50737,0,0,0,0,0,0,
+	0,0,0,50737,65535,50737,50737,0,0,0,0,0,
+	0,0,0,50737,65535,50737,50737,0,0,0,0,0,
+	0,0,50737,65535,20612,50737,50737,0,0,0,0,0,
+	0,0,50737,65535,20612,50737,50737,0,0,0,0,0,
+	0,0,50737,65535,20612,43866,50737,50737,0,0,0,0,
+	0,0,50737,65535,20612,43866,50737,50737,0,0,0,0,
+	0,50737,65535,20612,20612,43866,50737,50737,0,0,0,0,
+	0,50737,65535,20612,43866,43866,50737,50737,50737,0,0,0,
+	0,50737,65535,20612,43866,43866,43866,43866,50737,0,0,0,
+
+	// SPRITE_NIGHTMARE_SPIKE: Spike obstacle for Nightmare Mode
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,7960,0,0,0,0,0,0,0,
+	0,0,0,0,7960,0,0,0,0,0,0,0,
+	0,0,0,0,7960,7960,0,0,0,0,0,0,
+	0,0,0,7960,7960,7960,0,0,0,0,0,0,
+	0,0,0,7960,7960,50737,0,0,0,0,0,0,
+	0,0,0,50737,7960,50737,7960,0,0,0,0,0,
+	0,0,0,50737,7960,50737,50737,0,0,0,0,0,
+	0,0,50737,7960,20612,50737,50737,0,0,0,0,0,
+	0,0,50737,7960,20612,50737,50737,0,0,0,0,0,
+	0,0,50737,7960,20612,43866,50737,50737,0,0,0,0,
+	0,0,50737,7960,20612,43866,50737,50737,0,0,0,0,
+	0,50737,7960,20612,20612,43866,50737,50737,0,0,0,0,
+	0,50737,7960,20612,43866,43866,50737,50737,50737,0,0,0,
+	0,50737,7960,20612,43866,43866,43866,43866,50737,0,0,0,
+
+	// SPRITE_HEART: Array to represent a heart (life) in the game
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,7936,7936,0,0,0,7936,7936,0,0,0,
+	0,7936,7936,7936,7936,0,7936,7936,7936,7936,0,0,
+	0,7936,56253,7936,7936,7936,7936,7936,7936,7936,0,0,
+	0,7936,7936,7936,7936,7936,7936,7936,7936,7936,0,0,
+	0,7936,7936,7936,7936,7936,7936,7936,7936,7936,0,0,
+	0,7936,7936,7936,7936,7936,7936,7936,7936,7936,0,0,
+	0,0,7936,7936,7936,7936,7936,7936,7936,0,0,0,
+	0,0,0,7936,7936,7936,7936,7936,0,0,0,0,
+	0,0,0,0,7936,7936,7936,0,0,0,0,0,
+	0,0,0,0,0,7936,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_NIGHTMARE_HEART: Heart representation for Nightmare Mode
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,12192,12192,0,0,0,12192,12192,0,0,0,
+	0,12192,12192,12192,12192,0,12192,12192,12192,12192,0,0,
+	0,12192,56253,12192,12192,12192,12192,12192,12192,12192,0,0,
+	0,12192,12192,12192,12192,12192,12192,12192,12192,12192,0,0,
+	0,12192,12192,12192,12192,12192,12192,12192,12192,12192,0,0,
+	0,12192,12192,12192,12192,12192,12192,12192,12192,12192,0,0,
+	0,0,12192,12192,12192,12192,12192,12192,12192,0,0,0,
+	0,0,0,12192,12192,12192,12192,12192,0,0,0,0,
+	0,0,0,0,12192,12192,12192,0,0,0,0,0,
+	0,0,0,0,0,12192,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_HEART_EMPTY: Array to represent an empty heart (lost life)
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,44395,44395,0,0,0,44395,44395,0,0,0,
+	0,44395,44395,44395,44395,0,44395,44395,44395,44395,0,0,
+	0,44395,56253,44395,44395,44395,44395,44395,44395,44395,0,0,
+	0,44395,44395,44395,44395,44395,44395,44395,44395,44395,0,0,
+	0,44395,44395,44395,44395,44395,44395,44395,44395,44395,0,0,
+	0,44395,44395,44395,44395,44395,44395,44395,44395,44395,0,0,
+	0,0,44395,44395,44395,44395,44395,44395,44395,0,0,0,
+	0,0,0,44395,44395,44395,44395,44395,0,0,0,0,
+	0,0,0,0,44395,44395,44395,0,0,0,0,0,
+	0,0,0,0,0,44395,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_KEY: Array to represent a key in Level 1
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,7943,7943,0,0,0,
+	0,0,0,0,0,24326,7943,7943,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,0,24326,7943,0,0,0,0,0,
+	0,0,0,0,7943,0,0,7943,0,0,0,0,
+	0,0,0,0,24326,0,0,7943,0,0,0,0,
+	0,0,0,0,24326,7943,7943,24326,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_TAKEN_KEY: Array to represent a collected key
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,44395,44395,0,0,0,
+	0,0,0,0,0,26954,44395,44395,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,0,26954,44395,0,0,0,0,0,
+	0,0,0,0,44395,0,0,44395,0,0,0,0,
+	0,0,0,0,26954,0,0,44395,0,0,0,0,
+	0,0,0,0,26954,26954,44395,26954,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_DOOR: Array to represent a door in the game, only the top 16 of its 20 rows were ever drawn
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,18233,18233,18233,18233,0,0,0,0,
+	0,0,0,18233,37640,60672,37640,37640,18233,0,0,0,
+	0,0,18233,60672,37640,60672,60672,37640,37640,18233,0,0,
+	0,18233,60672,60672,37640,60672,60672,37640,60672,37640,18233,0,
+	0,18233,37640,60672,37640,60672,37640,37640,60672,37640,18233,0,
+	0,18233,60672,60672,37640,60672,60672,37640,37640,37640,18233,0,
+	0,18233,44395,44395,44395,44395,44395,44395,44395,44395,18233,0,
+	0,18233,44395,44395,44395,44395,44395,44395,44395,44395,18233,0,
+	0,18233,60672,60672,37640,37640,60672,37640,60672,37640,18233,0,
+	0,18233,60672,60672,37640,60672,60672,37640,60672,37640,18233,0,
+	0,18233,60672,37640,37640,60672,60672,37640,60672,37640,18233,0,
+	0,18233,44395,44395,44395,44395,44395,44395,24326,44395,18233,0,
+	0,18233,44395,44395,44395,44395,44395,44395,24326,44395,18233,0,
+
+	// SPRITE_SKELETON_RUN: Array for the running animation of a skeleton enemy
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,10306,0,0,0,
+	0,0,39374,39374,39374,39374,39374,0,10306,27218,27218,0,
+	0,39374,65535,65535,65535,65535,65535,0,10306,27218,27218,0,
+	0,39374,65535,0,65535,0,65535,0,10306,27218,10306,0,
+	0,39374,65535,65535,39374,65535,65535,0,51977,10306,0,0,
+	0,0,0,39374,39374,39374,39374,0,51977,0,0,0,
+	0,39374,65535,65535,65535,39374,0,0,4114,0,0,0,
+	0,39374,65535,0,0,39374,39374,0,4114,0,0,0,
+	0,39374,65535,65535,65535,39374,39374,39374,4114,0,0,0,
+	0,39374,65535,0,0,39374,0,0,4114,0,0,0,
+	0,0,65535,65535,39374,39374,0,0,4114,0,0,0,
+	0,65535,65535,0,0,0,39374,0,4114,0,0,0,
+	65535,0,0,0,0,0,0,0,4114,0,0,0,
+
+	// SPRITE_SKELETON_ATTACK1: First attack frame of the skeleton enemy
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,39374,39374,39374,39374,39374,0,0,0,10306,0,0,
+	39374,65535,65535,65535,65535,65535,0,0,0,10306,0,0,
+	39374,65535,0,65535,0,65535,0,0,10306,27218,27218,27218,
+	39374,65535,65535,39374,65535,65535,0,0,10306,27218,27218,0,
+	0,0,39374,39374,39374,39374,0,51977,10306,27218,10306,0,
+	39374,65535,65535,65535,39374,0,51977,51977,0,0,0,0,
+	39374,39374,0,0,39374,39374,4114,0,0,0,0,0,
+	0,39374,39374,65535,39374,4114,4114,0,0,0,0,0,
+	0,65535,39374,39374,39374,4114,0,0,0,0,0,0,
+	0,65535,65535,39374,4114,4114,0,0,0,0,0,0,
+	0,65535,0,0,4114,0,0,0,0,0,0,0,
+	0,39374,0,4114,4114,0,0,0,0,0,0,0,
+
+	// SPRITE_SKELETON_ATTACK2: Second attack frame of the skeleton enemy
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,39374,39374,39374,39374,39374,0,0,0,0,0,
+	0,39374,65535,65535,65535,65535,65535,0,0,0,0,0,
+	0,39374,65535,0,65535,0,65535,0,0,0,0,0,
+	0,39374,65535,65535,39374,65535,65535,0,0,0,0,0,
+	0,0,0,39374,39374,39374,39374,0,0,0,0,0,
+	0,39374,65535,65535,65535,39374,0,0,0,0,0,0,
+	0,0,39374,0,0,39374,39374,0,0,0,0,0,
+	4114,4114,4114,65535,4114,4114,65535,51977,10306,10306,10306,10306,
+	0,0,65535,39374,39374,39374,0,10306,27218,27218,27218,0,
+	0,0,65535,65535,39374,39374,0,0,10306,27218,27218,0,
+	0,0,65535,0,0,39374,0,0,0,0,0,0,
+	0,0,39374,0,0,39374,0,0,0,0,0,0,
+
+	// SPRITE_NIGHT_SKELETON_RUN: Running animation for the skeleton in Nightmare Mode
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,10306,0,0,0,
+	0,0,30168,30168,30168,30168,30168,0,10306,27218,27218,0,
+	0,30168,48123,48123,48123,48123,48123,0,10306,27218,27218,0,
+	0,30168,48123,7960,48123,7960,48123,0,10306,27218,10306,0,
+	0,30168,48123,48123,30168,48123,48123,0,51977,10306,0,0,
+	0,0,0,30168,30168,30168,30168,0,51977,0,0,0,
+	0,30168,48123,48123,48123,30168,0,0,4114,0,0,0,
+	0,30168,48123,0,0,30168,30168,0,4114,0,0,0,
+	0,30168,48123,48123,48123,30168,30168,30168,4114,0,0,0,
+	0,30168,48123,0,0,30168,0,0,4114,0,0,0,
+	0,0,48123,48123,30168,30168,0,0,4114,0,0,0,
+	0,48123,48123,0,0,0,30168,0,4114,0,0,0,
+	48123,0,0,0,0,0,0,0,4114,0,0,0,
+
+	// SPRITE_NIGHT_SKELETON_ATTACK1: First attack frame of the skeleton in Nightmare Mode
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,30168,30168,30168,30168,30168,0,0,0,10306,0,0,
+	30168,48123,48123,48123,48123,48123,0,0,0,10306,0,0,
+	30168,48123,7960,48123,7960,48123,0,0,10306,27218,27218,27218,
+	30168,48123,48123,30168,48123,48123,0,0,10306,27218,27218,0,
+	0,0,30168,30168,30168,30168,0,51977,10306,27218,10306,0,
+	30168,48123,48123,48123,30168,0,51977,51977,0,0,0,0,
+	30168,30168,0,0,30168,30168,4114,0,0,0,0,0,
+	0,30168,30168,48123,30168,4114,4114,0,0,0,0,0,
+	0,48123,30168,30168,30168,4114,0,0,0,0,0,0,
+	0,48123,48123,30168,4114,4114,0,0,0,0,0,0,
+	0,48123,0,0,4114,0,0,0,0,0,0,0,
+	0,30168,0,4114,4114,0,0,0,0,0,0,0,
+
+	// SPRITE_NIGHT_SKELETON_ATTACK2: Second attack frame of the skeleton in Nightmare Mode
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,30168,30168,30168,30168,30168,0,0,0,0,0,
+	0,30168,48123,48123,48123,48123,48123,0,0,0,0,0,
+	0,30168,48123,7960,48123,7960,48123,0,0,0,0,0,
+	0,30168,48123,48123,30168,48123,48123,0,0,0,0,0,
+	0,0,0,30168,30168,30168,30168,0,0,0,0,0,
+	0,30168,48123,48123,48123,30168,0,0,0,0,0,0,
+	0,0,30168,0,0,30168,30168,0,0,0,0,0,
+	4114,4114,4114,48123,4114,4114,48123,51977,10306,10306,10306,10306,
+	0,0,48123,30168,30168,30168,0,10306,27218,27218,27218,0,
+	0,0,48123,48123,30168,30168,0,0,10306,27218,27218,0,
+	0,0,48123,0,0,30168,0,0,0,0,0,0,
+	0,0,30168,0,0,30168,0,0,0,0,0,0,
+
+	// SPRITE_EASY_SKULL: Skull representation for the easy difficulty level
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,0,0,14005,39374,39374,39374,39374,14005,0,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,0,0,0,14005,14005,0,0,0,14005,0,
+	0,14005,0,40966,40966,14005,14005,40966,40966,0,14005,0,
+	0,39374,0,40966,40966,14005,14005,40966,40966,0,39374,0,
+	0,0,14005,14005,14005,0,0,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,0,39374,14005,14005,14005,14005,39374,0,0,0,
+	0,0,0,0,14005,39374,39374,14005,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_NORMAL_SKULL: Skull representation for the normal difficulty level
+	0,0,0,0,0,0,0,0,0,0,0,0,
+	0,11627,0,0,0,0,0,0,0,0,11627,0,
+	11627,11627,11627,14005,39374,39374,39374,39374,14005,11627,11627,11627,
+	0,11627,14005,14005,14005,14005,14005,14005,14005,14005,11627,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,0,0,0,14005,14005,0,0,0,14005,0,
+	0,14005,0,15950,15950,14005,14005,15950,15950,0,14005,0,
+	0,39374,0,15950,15950,14005,14005,15950,15950,0,39374,0,
+	0,0,14005,14005,14005,0,0,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,0,39374,14005,14005,14005,14005,39374,0,0,0,
+	0,0,0,0,14005,39374,39374,14005,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_HARD_SKULL: Skull representation for the hard difficulty level
+	11627,0,0,0,0,0,0,0,0,0,0,11627,
+	11627,11627,0,0,0,0,0,0,0,0,11627,11627,
+	11627,11627,11627,14005,39374,39374,39374,39374,14005,11627,11627,11627,
+	0,11627,14005,14005,14005,14005,14005,14005,14005,14005,11627,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,14005,14005,14005,14005,14005,14005,14005,14005,14005,0,
+	0,14005,0,0,0,14005,14005,0,0,0,14005,0,
+	0,14005,0,40705,40705,14005,14005,40705,40705,0,14005,0,
+	0,39374,0,40705,40705,14005,14005,40705,40705,0,39374,0,
+	0,0,14005,14005,14005,0,0,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,14005,14005,14005,14005,14005,14005,14005,14005,0,0,
+	0,0,0,39374,14005,14005,14005,14005,39374,0,0,0,
+	0,0,0,0,14005,39374,39374,14005,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+
+	// SPRITE_NIGHTMARE_SKULL: Skull representation for the Nightmare Mode
+	11627,0,0,0,0,0,0,0,0,0,0,11627,
+	11627,11627,0,0,0,0,0,0,0,0,11627,11627,
+	11627,11627,11627,30168,30961,30961,30961,30961,30168,11627,11627,11627,
+	0,11627,30168,30168,30168,30168,30168,30168,30168,30168,11627,0,
+	0,30168,30168,30168,30168,30168,30168,30168,30168,30168,30168,0,
+	0,30168,30168,30168,30168,30168,30168,30168,30168,30168,30168,0,
+	0,30168,0,0,0,30168,30168,0,0,0,30168,0,
+	0,30168,0,7960,7960,30168,30168,7960,7960,0,30168,0,
+	0,30961,0,7960,7960,30168,30168,7960,7960,0,30961,0,
+	0,0,30168,30168,30168,0,0,30168,30168,30168,0,0,
+	0,0,30168,30168,30168,30168,30168,30168,30168,30168,0,0,
+	0,0,30168,30168,30168,30168,30168,30168,30168,30168,0,0,
+	0,0,30168,30168,30168,30168,30168,30168,30168,30168,0,0,
+	0,0,0,30961,30168,30168,30168,30168,30961,0,0,0,
+	0,0,0,0,30168,30961,30961,30168,0,0,0,0,
+	0,0,0,0,0,0,0,0,0,0,0,0,
+};
+
+// Where each sprite starts, its size and which ways the game flips it
+const SpriteInfo sprite_info[SPRITE_COUNT] =
+{
+	{SPRITE_KNIGHT1 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_KNIGHT2 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_KNIGHT3 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_V},
+	{SPRITE_SPIKE * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_NIGHTMARE_SPIKE * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_HEART * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_NIGHTMARE_HEART * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_HEART_EMPTY * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_KEY * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_TAKEN_KEY * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_DOOR * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_SKELETON_RUN * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_SKELETON_ATTACK1 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_SKELETON_ATTACK2 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_NIGHT_SKELETON_RUN * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_NIGHT_SKELETON_ATTACK1 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_NIGHT_SKELETON_ATTACK2 * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE_FLIPS_H},
+	{SPRITE_EASY_SKULL * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_NORMAL_SKULL * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_HARD_SKULL * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+	{SPRITE_NIGHTMARE_SKULL * SPRITE_PIXELS, SPRITE_WIDTH, SPRITE_HEIGHT, 0},
+};
@@ -0,0 +1,52 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+#include <stdint.h>
+
+// All sprites are 12x16 and live in one table, SPRITE(id) is the first pixel of one.
+// It is a constant expression so it can go in const tables such as animation clips.
+#define SPRITE_WIDTH 12
+#define SPRITE_HEIGHT 16
+#define SPRITE_PIXELS (SPRITE_WIDTH * SPRITE_HEIGHT)
+#define SPRITE(id) (&sprite_atlas[(id) * SPRITE_PIXELS])
+
+// Ways a sprite is drawn flipped in the game, the panel does the flipping (see putImage)
+#define SPRITE_FLIPS_H 1
+#define SPRITE_FLIPS_V 2
+
+enum
+{
+	SPRITE_KNIGHT1,
+	SPRITE_KNIGHT2,
+	SPRITE_KNIGHT3,
+	SPRITE_SPIKE,
+	SPRITE_NIGHTMARE_SPIKE,
+	SPRITE_HEART,
+	SPRITE_NIGHTMARE_HEART,
+	SPRITE_HEART_EMPTY,
+	SPRITE_KEY,
+	SPRITE_TAKEN_KEY,
+	SPRITE_DOOR,
+	SPRITE_SKELETON_RUN,
+	SPRITE_SKELETON_ATTACK1,
+	SPRITE_SKELETON_ATTACK2,
+	SPRITE_NIGHT_SKELETON_RUN,
+	SPRITE_NIGHT_SKELETON_ATTACK1,
+	SPRITE_NIGHT_SKELETON_ATTACK2,
+	SPRITE_EASY_SKULL,
+	SPRITE_NORMAL_SKULL,
+	SPRITE_HARD_SKULL,
+	SPRITE_NIGHTMARE_SKULL,
+	SPRITE_COUNT
+};
+
+// Index entry for one sprite in the atlas
+typedef struct
+{
+	uint16_t offset; // first pixel in sprite_atlas
+	uint8_t width, height;
+	uint8_t flips;   // SPRITE_FLIPS_ bits
+} SpriteInfo;
+
+extern const uint16_t sprite_atlas[SPRITE_COUNT * SPRITE_PIXELS];
+extern const SpriteInfo sprite_info[SPRITE_COUNT];
+#endif
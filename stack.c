@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include "serial.h"
+#include "stack.h"
+
+#define PAINT 0xc0ffee55u
+#define RAM_SIZE (4 * 1024)
+
+// The window and the guard above it have to leave room for the statics at the least
+_Static_assert(STACK_PAINT_BYTES + STACK_GUARD < RAM_SIZE / 2, "STACK_PAINT_BYTES leaves too little RAM for the statics");
+
+// End of the statics as GNU ld scripts usually mark it, after .bss and .noinit. Weak so
+// a script without it still links, the address is then 0 and only the size above holds.
+extern char _end __attribute__((weak));
+
+static uintptr_t paint_top = 0;    // roughly the stack pointer in main
+static uintptr_t paint_bottom = 0; // 0 until stack_paint has run
+
+void stack_paint()
+{
+	// Called from main before anything else gets deep. The window is a fixed size below
+	// here, cut short if it would reach down into the statics. Addresses go through
+	// integers and volatile so the compiler can't treat the stores as writes past the
+	// end of here and drop them.
+	uint32_t here = 0;
+	uintptr_t statics_end = ((uintptr_t)&_end + 3) & ~(uintptr_t)3;
+	volatile uint32_t *p;
+	paint_top = (uintptr_t)&here & ~(uintptr_t)3;
+	paint_bottom = paint_top - STACK_PAINT_BYTES;
+	if (statics_end != 0 && statics_end < paint_top && paint_bottom < statics_end)
+		paint_bottom = statics_end;
+	for (p = (volatile uint32_t *)(paint_top - STACK_GUARD); (uintptr_t)p >= paint_bottom; p--)
+		*p = PAINT;
+}
+uint32_t stack_used()
+{
+	// Bytes below main's frame ever used, the whole window if all of it has been and
+	// it may have gone further
+	volatile uint32_t *p = (volatile uint32_t *)paint_bottom;
+	if (paint_bottom == 0)
+		return 0;
+	while ((uintptr_t)p < paint_top - STACK_GUARD && *p == PAINT)
+		p++;
+	return (uint32_t)(paint_top - (uintptr_t)p);
+}
+void stack_report()
+{
+	uint32_t used = stack_used();
+	uint32_t window = (uint32_t)(paint_top - paint_bottom);
+	eputs("Stack: used ");
+	printDecimal((int32_t)used);
+	eputs(" of ");
+	printDecimal((int32_t)window);
+	eputs(" painted bytes below main");
+	if (window < STACK_PAINT_BYTES)
+		eputs(", window cut short by the statics");
+	if (window && used >= window)
+		eputs(", overflowed the window");
+	eputs("\r\n");
+}
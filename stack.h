@@ -0,0 +1,10 @@
+#include <stdint.h>
+// Stack high water mark. A window below main's frame is painted with a pattern at start
+// up and the lowest word not still holding it shows how deep the stack has ever been,
+// interrupts included. tools/mem_report.py works out the worst case from the build.
+#define STACK_PAINT_BYTES 1024 // cut short at the end of the statics, mem_report.py checks it fits
+#define STACK_GUARD 64         // left unpainted below stack_paint's own frame
+
+void stack_paint(void);
+uint32_t stack_used(void);
+void stack_report(void);
@@ -0,0 +1,111 @@
+#include <stm32f031x6.h>
+#include "timebase.h"
+
+#define CORE_HZ 48000000
+#define TICK_CYCLES (CORE_HZ / 1000)
+#define PENDSTSET (1u << 26) // in SCB->ICSR, a SysTick interrupt is waiting
+
+volatile uint32_t milliseconds_uptime = 0; // Free running millisecond count since boot, never reset
+static volatile uint32_t uptime_high = 0;  // times milliseconds_uptime has wrapped
+static SoftTimer *timers = 0;              // running timers, in no particular order
+
+static void unlink(SoftTimer *t);
+
+void timebase_init()
+{
+	// The counter reloads from LOAD, so LOAD + 1 cycles make a tick
+	SysTick->LOAD = TICK_CYCLES - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL = 7; // core clock, interrupt, enable
+	__asm(" cpsie i "); // enable interrupts
+}
+void SysTick_Handler(void)
+{
+	// The one interrupt behind all game timing: count the tick, then run whatever
+	// timers are due
+	SoftTimer **link = &timers;
+	if (++milliseconds_uptime == 0)
+		uptime_high++;
+	while (*link)
+	{
+		SoftTimer *t = *link;
+		if (!TIME_REACHED(milliseconds_uptime, t->due))
+		{
+			link = &t->next;
+			continue;
+		}
+		t->fire();
+		if (t->period)
+		{
+			t->due += t->period;
+			link = &t->next;
+		}
+		else
+		{
+			*link = t->next;
+			t->active = 0;
+		}
+	}
+}
+uint64_t time_us()
+{
+	// Whole milliseconds from the tick count plus how far the down counter has got
+	// through the current one. Read again if the tick lands in between. With interrupts
+	// off (or in a higher priority handler) the counter may have reloaded without the
+	// tick being counted yet, the pending bit says so.
+	uint32_t high, ms, val, pending;
+	do
+	{
+		high = uptime_high;
+		ms = milliseconds_uptime;
+		val = SysTick->VAL;
+		pending = SCB->ICSR & PENDSTSET;
+	} while (ms != milliseconds_uptime || high != uptime_high);
+	if (pending)
+	{
+		val = SysTick->VAL; // certainly read after the reload now
+		if (++ms == 0)
+			high++;
+	}
+	// Cycles into the tick divided by 48 as a multiply and shift, there is no divider.
+	// 1365/65536 is just under 1/48 so the result never reaches 1000.
+	return (((uint64_t)high << 32) | ms) * 1000 + (((TICK_CYCLES - 1 - val) * 1365) >> 16);
+}
+uint32_t time_ms()
+{
+	return milliseconds_uptime;
+}
+void timer_start(SoftTimer *t, uint32_t delay_ms, uint32_t period_ms, void (*fire)(void))
+{
+	// Fire after delay_ms and then every period_ms. Starting a running timer restarts it.
+	__asm(" cpsid i ");
+	if (t->active)
+		unlink(t);
+	t->due = milliseconds_uptime + delay_ms;
+	t->period = period_ms;
+	t->fire = fire;
+	t->active = 1;
+	t->next = timers;
+	timers = t;
+	__asm(" cpsie i ");
+}
+void timer_stop(SoftTimer *t)
+{
+	__asm(" cpsid i ");
+	if (t->active)
+		unlink(t);
+	t->active = 0;
+	__asm(" cpsie i ");
+}
+int timer_active(const SoftTimer *t)
+{
+	return t->active;
+}
+void unlink(SoftTimer *t)
+{
+	SoftTimer **link = &timers;
+	while (*link && *link != t)
+		link = &(*link)->next;
+	if (*link)
+		*link = t->next;
+}
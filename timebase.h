@@ -0,0 +1,28 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+#include <stdint.h>
+
+// Time since boot, kept by SysTick. Millisecond counts wrap after 49 days so compare
+// them with TIME_REACHED rather than with < or ==, time_us won't wrap in practice.
+#define TIME_REACHED(now, deadline) ((int32_t)((uint32_t)(now) - (uint32_t)(deadline)) >= 0)
+
+// A software timer. The caller owns it, the SysTick interrupt runs it. fire is called
+// from the interrupt so it must be short: set a flag, count something down or poke a
+// peripheral. It may change its own period (0 makes it the last firing) but must not
+// start or stop timers.
+typedef struct SoftTimer
+{
+	uint32_t due;            // milliseconds_uptime it fires at next
+	uint32_t period;         // milliseconds between firings, 0 for a one shot
+	void (*fire)(void);
+	struct SoftTimer *next;  // in the list of running timers
+	uint8_t active;
+} SoftTimer;
+
+void timebase_init(void);
+uint64_t time_us(void);
+uint32_t time_ms(void);
+void timer_start(SoftTimer *t, uint32_t delay_ms, uint32_t period_ms, void (*fire)(void));
+void timer_stop(SoftTimer *t);
+int timer_active(const SoftTimer *t);
+#endif
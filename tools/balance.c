@@ -0,0 +1,510 @@
+// Host level balance simulator.
+// Plays the levels with the greedy bot from bot.c many times over, on a pool of
+// threads, and gathers where the knight dies and how long each level takes. main.c
+// keeps its state in globals, so rather than run it this keeps a copy of each
+// playthrough's state on the thread playing it and steps it the way level_update does:
+// the knight moves with motion.c, the skeletons are run by enemy.c over the thread's
+// own EnemyWorld, so they patrol, spot the knight and chase him round spikes with the
+// flow field just as in the game, hits use enemy_hits and the same spike test, a hit
+// puts him down for a while and then back at a spawn point shielded, and Nightmare's
+// minute runs on across the levels. Nightmare levels come from levelgen, which isn't
+// thread safe, so a pool of them is built before the threads start.
+//
+// Playthrough n is played on Easy, Normal, Hard and Nightmare in turn, with random
+// numbers seeded from the seed and n alone, so the results are the same whatever the
+// number of threads. Threads take playthroughs a chunk at a time and keep their own
+// figures, which are added up at the end.
+//
+// Writes into outdir:
+//   deaths_l<level>_<difficulty>.ppm  where the knight was when he died, brighter for
+//                                     more deaths, with spikes, keys and the door
+//                                     outlined on the fixed levels
+//   complete_times.csv                level,difficulty,seconds,count for every level
+//                                     completed, by whole seconds taken
+// and prints completion rates per level and difficulty and the playthroughs per second.
+//
+// Build from the repository root with:
+//   cc -O2 -pthread -I. -o balance tools/balance.c tools/bot.c level.c levelgen.c motion.c rng.c enemy.c grid.c path.c anim.c -lm
+// Usage:
+//   ./balance [playthroughs] [threads] [seed] [outdir]
+// Defaults to 20000 playthroughs with a thread for every core, writing to the
+// current directory.
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "level.h"
+#include "levelgen.h"
+#include "motion.h"
+#include "enemy.h"
+#include "camera.h"
+#include "bot.h"
+
+#define DIFFICULTIES 4
+#define NIGHTMARE 4            // difficulty numbers as in main.c, 1 to 4
+#define FRAME_MS 30
+#define KNIGHT_DOWN_MS 700
+#define KNIGHT_SHIELD_MS 1500
+#define NIGHTMARE_SECONDS 60
+#define LEVEL_LIMIT_MS (5 * 60 * 1000) // a level still going after this long is stuck
+#define SECONDS 301            // time to complete buckets, the last one is everything over
+#define NIGHTMARE_POOL 512     // generated layouts for each Nightmare level
+#define CHUNK 64               // playthroughs a thread takes at a time
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 160
+
+// Ways a level can end
+#define END_COMPLETE 0
+#define END_HEARTS 1
+#define END_TIME 2
+#define END_STUCK 3
+
+static const char *const difficulty_names[DIFFICULTIES] = {"easy", "normal", "hard", "nightmare"};
+static const int hearts_for[DIFFICULTIES] = {3, 2, 1, 1};
+
+// A layout with its size worked out once
+typedef struct
+{
+	const LevelLayout *layout;
+	int width, height;
+} Level;
+
+typedef struct
+{
+	uint32_t runs[DIFFICULTIES], won[DIFFICULTIES], stuck[DIFFICULTIES];
+	uint32_t reached[LEVEL_COUNT][DIFFICULTIES];
+	uint32_t completed[LEVEL_COUNT][DIFFICULTIES];
+	uint32_t out_of_time[LEVEL_COUNT][DIFFICULTIES];
+	uint32_t deaths[LEVEL_COUNT][DIFFICULTIES];
+	uint32_t seconds[LEVEL_COUNT][DIFFICULTIES][SECONDS];
+	uint32_t heat[LEVEL_COUNT][DIFFICULTIES][LEVEL_MAX_HEIGHT][LEVEL_MAX_WIDTH];
+} Stats;
+
+// One level being played
+typedef struct
+{
+	const Level *level;
+	int difficulty;
+	Motion knight;
+	uint16_t x, y;
+	int state;           // as knight_state in main.c
+	uint32_t since;      // when state was entered
+	int hearts_gone;
+	int keys[LEVEL_MAX_KEYS];
+	int num_keys_found;
+	Enemy enemies[LEVEL_MAX_ENEMIES];
+	EnemyWorld world;    // the enemies' grid and flow field, as main.c's enemy_world
+	uint64_t rng;        // spawn points
+} Play;
+
+#define KNIGHT_ALIVE 0
+#define KNIGHT_DOWN 1
+#define KNIGHT_SHIELDED 2
+
+static Level fixed_levels[LEVEL_COUNT];
+static Level nightmare_levels[NIGHTMARE_POOL][LEVEL_COUNT];
+static LevelLayout nightmare_layouts[NIGHTMARE_POOL][LEVEL_COUNT];
+static uint64_t base_seed;
+static int playthroughs;
+static atomic_int next_playthrough;
+
+static void level_prepare(Level *l, const LevelLayout *layout);
+static void *worker(void *arg);
+static void playthrough(int n, Stats *st);
+static int play_level(Play *p, Bot *bot, Stats *st, int level, int *nightmare_ms);
+static void spawn(Play *p, uint32_t now);
+static uint64_t splitmix(uint64_t *state);
+static void merge(Stats *into, const Stats *from);
+static int write_heatmap(const char *path, const Stats *st, int level, int d);
+static void outline(uint8_t *rgb, int width, int height, const Waypoint *w, uint8_t r, uint8_t g, uint8_t b);
+static int write_times(const char *path, const Stats *st);
+static double now_s(void);
+
+int main(int argc, char *argv[])
+{
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	int threads = (argc > 2) ? atoi(argv[2]) : (int)((cores > 0) ? cores : 1);
+	const char *outdir = (argc > 4) ? argv[4] : ".";
+	pthread_t *ids;
+	Stats **parts;
+	Stats *total;
+	char path[512];
+	double start, took;
+	playthroughs = (argc > 1) ? atoi(argv[1]) : 20000;
+	base_seed = (argc > 3) ? strtoull(argv[3], 0, 0) : 1;
+	if (threads < 1)
+		threads = 1;
+	// The fixed levels and a pool of Nightmare ones, made the way level_enter makes
+	// them from the card's seed
+	for (int l = 0; l < LEVEL_COUNT; l++)
+		level_prepare(&fixed_levels[l], &level_layouts[l]);
+	for (int i = 0; i < NIGHTMARE_POOL; i++)
+	{
+		uint64_t s = base_seed ^ (0x9e3779b97f4a7c15ull * (uint64_t)(i + 1));
+		uint32_t seed = (uint32_t)splitmix(&s);
+		for (int l = 0; l < LEVEL_COUNT; l++)
+		{
+			const LevelLayout *fixed = &level_layouts[l];
+			levelgen_generate(seed + (uint32_t)l + 1, fixed->num_keys, fixed->num_spikes, fixed->num_enemies, &nightmare_layouts[i][l]);
+			level_prepare(&nightmare_levels[i][l], &nightmare_layouts[i][l]);
+		}
+	}
+
+	ids = calloc((size_t)threads, sizeof(*ids));
+	parts = calloc((size_t)threads, sizeof(*parts));
+	total = calloc(1, sizeof(*total));
+	if (!ids || !parts || !total)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	atomic_init(&next_playthrough, 0);
+	start = now_s();
+	for (int t = 0; t < threads; t++)
+	{
+		parts[t] = calloc(1, sizeof(Stats));
+		if (!parts[t] || pthread_create(&ids[t], 0, worker, parts[t]) != 0)
+		{
+			fprintf(stderr, "couldn't start thread %d\n", t);
+			return 1;
+		}
+	}
+	for (int t = 0; t < threads; t++)
+	{
+		pthread_join(ids[t], 0);
+		merge(total, parts[t]);
+		free(parts[t]);
+	}
+	took = now_s() - start;
+
+	printf("Balance: %d playthroughs on %d threads, seed %llu, %.2fs, %.0f playthroughs/s\n",
+	       playthroughs, threads, (unsigned long long)base_seed, took, playthroughs / took);
+	printf("%-10s %5s %8s %10s %10s %12s %9s %9s\n", "difficulty", "level", "reached", "completed", "no time", "deaths/try", "median s", "p90 s");
+	for (int d = 0; d < DIFFICULTIES; d++)
+	{
+		for (int l = 0; l < LEVEL_COUNT; l++)
+		{
+			uint32_t reached = total->reached[l][d];
+			uint32_t done = total->completed[l][d];
+			int median = -1, p90 = -1;
+			uint32_t seen = 0;
+			for (int s = 0; s < SECONDS && done; s++)
+			{
+				seen += total->seconds[l][d][s];
+				if (median < 0 && seen * 2 >= done)
+					median = s;
+				if (p90 < 0 && seen * 10 >= done * 9)
+					p90 = s;
+			}
+			printf("%-10s %5d %8u %9.1f%% %9.1f%% %12.2f %9d %9d\n", difficulty_names[d], l + 1, (unsigned)reached,
+			       reached ? 100.0 * done / reached : 0.0, reached ? 100.0 * total->out_of_time[l][d] / reached : 0.0,
+			       reached ? (double)total->deaths[l][d] / reached : 0.0, median, p90);
+		}
+	}
+	for (int d = 0; d < DIFFICULTIES; d++)
+	{
+		printf("%-10s won %5.1f%% stuck %5.1f%% of %u\n", difficulty_names[d],
+		       total->runs[d] ? 100.0 * total->won[d] / total->runs[d] : 0.0,
+		       total->runs[d] ? 100.0 * total->stuck[d] / total->runs[d] : 0.0, (unsigned)total->runs[d]);
+	}
+
+	for (int l = 0; l < LEVEL_COUNT; l++)
+	{
+		for (int d = 0; d < DIFFICULTIES; d++)
+		{
+			snprintf(path, sizeof(path), "%s/deaths_l%d_%s.ppm", outdir, l + 1, difficulty_names[d]);
+			if (write_heatmap(path, total, l, d) != 0)
+			{
+				perror(path);
+				return 1;
+			}
+		}
+	}
+	snprintf(path, sizeof(path), "%s/complete_times.csv", outdir);
+	if (write_times(path, total) != 0)
+	{
+		perror(path);
+		return 1;
+	}
+	return 0;
+}
+
+// Fills in the level's size
+static void level_prepare(Level *l, const LevelLayout *layout)
+{
+	l->layout = layout;
+	l->width = layout->width ? layout->width : SCREEN_WIDTH;
+	l->height = layout->height ? layout->height : SCREEN_HEIGHT;
+}
+
+// Takes playthroughs from the shared counter until they are all done
+static void *worker(void *arg)
+{
+	Stats *st = arg;
+	int first;
+	while ((first = atomic_fetch_add(&next_playthrough, CHUNK)) < playthroughs)
+	{
+		int last = (first + CHUNK < playthroughs) ? first + CHUNK : playthroughs;
+		for (int n = first; n < last; n++)
+			playthrough(n, st);
+	}
+	return 0;
+}
+
+// Levels 1 to 3 in turn until one of them isn't completed
+static void playthrough(int n, Stats *st)
+{
+	uint64_t s = base_seed * 0xbf58476d1ce4e5b9ull + (uint64_t)n;
+	int d = n % DIFFICULTIES;
+	int nightmare_ms = 0; // Nightmare's minute, used up across the levels
+	int end = END_COMPLETE;
+	Play p;
+	Bot bot;
+	bot_init(&bot, BOT_GREEDY, splitmix(&s));
+	p.rng = splitmix(&s);
+	p.difficulty = d + 1;
+	st->runs[d]++;
+	for (int l = 0; l < LEVEL_COUNT && end == END_COMPLETE; l++)
+	{
+		p.level = (p.difficulty == NIGHTMARE) ? &nightmare_levels[(n / DIFFICULTIES) % NIGHTMARE_POOL][l] : &fixed_levels[l];
+		end = play_level(&p, &bot, st, l, &nightmare_ms);
+	}
+	if (end == END_COMPLETE)
+		st->won[d]++;
+	if (end == END_STUCK)
+		st->stuck[d]++;
+}
+
+// Plays one level to its end as level_enter and level_update would
+static int play_level(Play *p, Bot *bot, Stats *st, int level, int *nightmare_ms)
+{
+	const LevelLayout *layout = p->level->layout;
+	int d = p->difficulty - 1;
+	uint32_t now = 0;
+	st->reached[level][d]++;
+	p->hearts_gone = 0;
+	p->num_keys_found = 0;
+	memset(p->keys, 0, sizeof(p->keys));
+	// As level_enter
+	enemy_world_init(&p->world, now);
+	for (int i = 0; i < layout->num_spikes; i++)
+		grid_block(&p->world.grid, layout->spikes[i].x, layout->spikes[i].y, 12, 16);
+	for (int i = 0; i < layout->num_enemies; i++)
+		enemy_init(&p->enemies[i], layout->patrol[i], layout->patrol_len[i], p->difficulty);
+	memset(&p->knight, 0, sizeof(p->knight));
+	spawn(p, 0);
+	p->state = KNIGHT_ALIVE;
+	motion_set_area(&p->knight, (uint16_t)p->level->width, (uint16_t)p->level->height);
+	motion_set_difficulty(&p->knight, p->difficulty);
+	for (;; now += FRAME_MS)
+	{
+		BotView v;
+		int xdir, ydir;
+		// The countdown ticks a second after the level starts and every second after
+		if (p->difficulty == NIGHTMARE && *nightmare_ms + (int)(now / 1000) * 1000 >= NIGHTMARE_SECONDS * 1000)
+		{
+			st->out_of_time[level][d]++;
+			return END_TIME;
+		}
+		if (now >= LEVEL_LIMIT_MS)
+			return END_STUCK;
+		if (p->state == KNIGHT_DOWN && now - p->since >= KNIGHT_DOWN_MS)
+		{
+			if (p->hearts_gone >= hearts_for[d])
+				return END_HEARTS;
+			spawn(p, now);
+			p->state = KNIGHT_SHIELDED;
+		}
+		else if (p->state == KNIGHT_SHIELDED && now - p->since >= KNIGHT_SHIELD_MS)
+		{
+			p->state = KNIGHT_ALIVE;
+		}
+		if (p->state != KNIGHT_DOWN && bot_touching(&layout->door, p->x, p->y) && p->num_keys_found == layout->num_keys)
+		{
+			uint32_t s = now / 1000;
+			st->completed[level][d]++;
+			st->seconds[level][d][(s < SECONDS) ? s : SECONDS - 1]++;
+			*nightmare_ms += (int)(now / 1000) * 1000;
+			return END_COMPLETE;
+		}
+		for (int i = 0; i < layout->num_keys && p->state != KNIGHT_DOWN; i++)
+		{
+			if (!p->keys[i] && bot_touching(&layout->keys[i], p->x, p->y))
+			{
+				p->keys[i] = 1;
+				p->num_keys_found++;
+			}
+		}
+		// Skeletons move on their own tick, then anything touching him hurts
+		enemies_update(&p->world, p->enemies, layout->num_enemies, p->x, p->y, now);
+		if (p->state == KNIGHT_ALIVE)
+		{
+			int hit = 0;
+			for (int i = 0; i < layout->num_enemies && !hit; i++)
+				hit = enemy_hits(&p->enemies[i], p->x, p->y);
+			for (int i = 0; i < layout->num_spikes && !hit; i++)
+				hit = bot_touching(&layout->spikes[i], p->x, p->y);
+			if (hit)
+			{
+				p->hearts_gone++;
+				p->state = KNIGHT_DOWN;
+				p->since = now;
+				st->deaths[level][d]++;
+				for (int y = p->y; y < p->y + 16 && y < LEVEL_MAX_HEIGHT; y++)
+					for (int x = p->x; x < p->x + 12 && x < LEVEL_MAX_WIDTH; x++)
+						st->heat[level][d][y][x]++;
+			}
+		}
+		v.layout = layout;
+		v.x = p->x;
+		v.y = p->y;
+		v.down = (p->state == KNIGHT_DOWN);
+		v.key_pickup = p->keys;
+		v.enemies = p->enemies;
+		bot_move(bot, &v, &xdir, &ydir);
+		if (p->state == KNIGHT_DOWN)
+			continue;
+		motion_update(&p->knight, xdir, ydir, FRAME_MS);
+		p->x = motion_x(&p->knight);
+		p->y = motion_y(&p->knight);
+	}
+}
+
+// Puts the knight on one of the spawn points, standing still
+static void spawn(Play *p, uint32_t now)
+{
+	const Waypoint *w = &p->level->layout->spawn[splitmix(&p->rng) % LEVEL_SPAWNS];
+	p->x = w->x;
+	p->y = w->y;
+	p->since = now;
+	motion_init(&p->knight, p->x, p->y);
+}
+
+// Random numbers for seeding and spawn points
+// Reference : https://prng.di.unimi.it/splitmix64.c
+static uint64_t splitmix(uint64_t *state)
+{
+	uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+static void merge(Stats *into, const Stats *from)
+{
+	// Every field is a count, so the whole thing adds up as one array
+	uint32_t *a = (uint32_t *)into;
+	const uint32_t *b = (const uint32_t *)from;
+	for (size_t i = 0; i < sizeof(Stats) / sizeof(uint32_t); i++)
+		a[i] += b[i];
+}
+
+// Deaths over the level from black through red and yellow to white, on a square
+// root scale so the odd death still shows next to the worst spot
+static int write_heatmap(const char *path, const Stats *st, int level, int d)
+{
+	const Level *l = (d + 1 == NIGHTMARE) ? &nightmare_levels[0][level] : &fixed_levels[level];
+	int width = l->width, height = l->height;
+	uint32_t most = 0;
+	uint8_t *rgb = malloc((size_t)width * height * 3);
+	FILE *f;
+	if (!rgb)
+		return -1;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (st->heat[level][d][y][x] > most)
+				most = st->heat[level][d][y][x];
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			double t = most ? sqrt((double)st->heat[level][d][y][x] / most) * 3.0 : 0.0;
+			uint8_t *px = &rgb[(y * width + x) * 3];
+			px[0] = (uint8_t)(255 * ((t > 1.0) ? 1.0 : t));
+			px[1] = (uint8_t)(255 * ((t > 2.0) ? 1.0 : (t > 1.0) ? t - 1.0 : 0.0));
+			px[2] = (uint8_t)(255 * ((t > 2.0) ? t - 2.0 : 0.0));
+		}
+	}
+	// Nightmare levels are different every game, so there is nothing to outline
+	if (d + 1 != NIGHTMARE)
+	{
+		for (int i = 0; i < l->layout->num_spikes; i++)
+			outline(rgb, width, height, &l->layout->spikes[i], 128, 128, 128);
+		for (int i = 0; i < l->layout->num_keys; i++)
+			outline(rgb, width, height, &l->layout->keys[i], 0, 160, 255);
+		outline(rgb, width, height, &l->layout->door, 0, 255, 0);
+	}
+	f = fopen(path, "wb");
+	if (!f)
+	{
+		free(rgb);
+		return -1;
+	}
+	fprintf(f, "P6\n%d %d\n255\n", width, height);
+	fwrite(rgb, 3, (size_t)width * height, f);
+	free(rgb);
+	return fclose(f);
+}
+static void outline(uint8_t *rgb, int width, int height, const Waypoint *w, uint8_t r, uint8_t g, uint8_t b)
+{
+	for (int y = w->y; y < w->y + 16 && y < height; y++)
+	{
+		for (int x = w->x; x < w->x + 12 && x < width; x++)
+		{
+			if (x == w->x || x == w->x + 11 || y == w->y || y == w->y + 15)
+			{
+				uint8_t *px = &rgb[(y * width + x) * 3];
+				px[0] = r;
+				px[1] = g;
+				px[2] = b;
+			}
+		}
+	}
+}
+
+static int write_times(const char *path, const Stats *st)
+{
+	FILE *f = fopen(path, "w");
+	if (!f)
+		return -1;
+	fprintf(f, "level,difficulty,seconds,count\n");
+	for (int l = 0; l < LEVEL_COUNT; l++)
+		for (int d = 0; d < DIFFICULTIES; d++)
+			for (int s = 0; s < SECONDS; s++)
+				if (st->seconds[l][d][s])
+					fprintf(f, "%d,%s,%d,%u\n", l + 1, difficulty_names[d], s, (unsigned)st->seconds[l][d][s]);
+	return fclose(f);
+}
+
+static double now_s(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+// What enemy.c and path.c use from the rest of the game. Nothing is drawn here, and
+// the watchdog and clock are only there for the zone trail and path_set_budget_us.
+// That is never called, so every flow_step finishes its field, as the game's slices do
+// within a frame or two.
+void camera_fill(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t colour)
+{
+}
+void camera_put_image(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *image, int hflip, int vflip)
+{
+}
+void watchdog_enter(int zone)
+{
+}
+void watchdog_leave(int zone)
+{
+}
+uint64_t time_us(void)
+{
+	return 0;
+}
@@ -0,0 +1,233 @@
+// Host check that putImage and putImageRegion, which leave flips to the panel's MADCTL
+// mirroring, put the same pixels on the screen as the old versions did by walking the
+// image backwards. display.c is built against a model of the ST7735 that follows
+// CASET, RASET, RAMWR and the MX/MY bits of MADCTL into its own GRAM.
+//   putImage        every sprite in all four flips at 20 places, corners included
+//   putImageRegion  every part of a sprite on a grid of origins and sizes, all flips
+// MADCTL must be back to normal after every draw. Exits with 1 on any mismatch.
+//
+// Build from the repository root with:
+//   cc -O2 -Itools/host -I. -o blit_test tools/blit_test.c sprites.c format.c fastmath.c
+// Usage:
+//   ./blit_test
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static void panel_byte(uint8_t byte, int dc);
+#define PANEL_TAP(byte, dc) panel_byte((uint8_t)(byte), (dc))
+#include "../display.c"
+#include "sprites.h"
+
+#define GRAM_WIDTH PANEL_COLUMNS
+#define GRAM_HEIGHT PANEL_LINES
+#define PLACES 20
+#define MAX_REPORTED 10
+
+// The model: the window, where the next pixel goes and the half of it already sent
+typedef struct
+{
+	uint16_t gram[GRAM_HEIGHT][GRAM_WIDTH];
+	uint8_t madctl;
+	uint8_t cmd;
+	uint8_t args[4];
+	int argc;
+	int xs, xe, ys, ye, cx, cy;
+	int high; // first byte of a pixel, -1 if none yet
+} Panel;
+
+static Panel panel, reference;
+static Panel *target = &panel; // where panel_byte sends what display.c writes
+volatile uint32_t milliseconds_uptime = 0;
+static int failures = 0;
+
+static void ref_window(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+static void ref_pixel(uint16_t colour);
+static void old_putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation);
+static void old_putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh);
+static void start_case(void);
+static void end_case(const char *what, int id, int flips, int a, int b, int c, int d);
+static uint32_t next_random(void);
+
+int main(void)
+{
+	int cases = 0;
+	for (int id = 0; id < SPRITE_COUNT; id++)
+	{
+		for (int flips = 0; flips < 4; flips++)
+		{
+			for (int place = 0; place < PLACES; place++)
+			{
+				// The two opposite corners, then anywhere
+				int x = (place == 0) ? 0 : (place == 1) ? SCREEN_WIDTH - SPRITE_WIDTH : (int)(next_random() % (SCREEN_WIDTH - SPRITE_WIDTH + 1));
+				int y = (place == 0) ? 0 : (place == 1) ? SCREEN_HEIGHT - SPRITE_HEIGHT : (int)(next_random() % (SCREEN_HEIGHT - SPRITE_HEIGHT + 1));
+				start_case();
+				putImage(x, y, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE(id), flips & 1, flips >> 1);
+				old_putImage(x, y, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE(id), flips & 1, flips >> 1);
+				end_case("putImage", id, flips, x, y, -1, -1);
+				cases++;
+			}
+		}
+	}
+	for (int flips = 0; flips < 4; flips++)
+	{
+		for (int sx = 0; sx < SPRITE_WIDTH; sx++)
+		{
+			for (int sy = 0; sy < SPRITE_HEIGHT; sy += 3)
+			{
+				for (int sw = 1; sx + sw <= SPRITE_WIDTH; sw += 2)
+				{
+					for (int sh = 1; sy + sh <= SPRITE_HEIGHT; sh += 4)
+					{
+						start_case();
+						putImageRegion(70, 60, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE(SPRITE_KNIGHT1), flips & 1, flips >> 1, sx, sy, sw, sh);
+						old_putImageRegion(70, 60, SPRITE_WIDTH, SPRITE_HEIGHT, SPRITE(SPRITE_KNIGHT1), flips & 1, flips >> 1, sx, sy, sw, sh);
+						end_case("putImageRegion", SPRITE_KNIGHT1, flips, sx, sy, sw, sh);
+						cases++;
+					}
+				}
+			}
+		}
+	}
+	printf("%d cases, %d mismatches\n", cases, failures);
+	return failures ? 1 : 0;
+}
+
+// A byte on the SPI bus, a command with the D/C pin low and data with it high
+static void panel_byte(uint8_t byte, int dc)
+{
+	Panel *p = target;
+	if (!dc)
+	{
+		p->cmd = byte;
+		p->argc = 0;
+		p->high = -1;
+		if (byte == 0x2c) // RAMWR starts at the top left of the window
+		{
+			p->cx = p->xs;
+			p->cy = p->ys;
+		}
+		return;
+	}
+	if (p->cmd == 0x2c)
+	{
+		int x, y;
+		if (p->high < 0)
+		{
+			p->high = byte;
+			return;
+		}
+		// Mirroring turns the address round as the pixel is stored, the window itself
+		// is in mirrored coordinates
+		x = (p->madctl & MADCTL_MX) ? GRAM_WIDTH - 1 - p->cx : p->cx;
+		y = (p->madctl & MADCTL_MY) ? GRAM_HEIGHT - 1 - p->cy : p->cy;
+		if (x >= 0 && x < GRAM_WIDTH && y >= 0 && y < GRAM_HEIGHT)
+			p->gram[y][x] = (uint16_t)((p->high << 8) | byte);
+		p->high = -1;
+		if (++p->cx > p->xe)
+		{
+			p->cx = p->xs;
+			if (++p->cy > p->ye)
+				p->cy = p->ys;
+		}
+		return;
+	}
+	if (p->argc < 4)
+		p->args[p->argc++] = byte;
+	if (p->cmd == 0x36 && p->argc == 1)
+		p->madctl = byte;
+	if (p->cmd == 0x2a && p->argc == 4) // CASET
+	{
+		p->xs = (p->args[0] << 8) | p->args[1];
+		p->xe = (p->args[2] << 8) | p->args[3];
+	}
+	if (p->cmd == 0x2b && p->argc == 4) // RASET
+	{
+		p->ys = (p->args[0] << 8) | p->args[1];
+		p->ye = (p->args[2] << 8) | p->args[3];
+	}
+}
+
+// putImage and putImageRegion from before the atlas, drawn on the reference panel
+static void ref_window(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+	const uint8_t bytes[] = {x >> 8, x & 0xff, (x + w - 1) >> 8, (x + w - 1) & 0xff, y >> 8, y & 0xff, (y + h - 1) >> 8, (y + h - 1) & 0xff};
+	target = &reference;
+	panel_byte(0x2a, 0);
+	for (int i = 0; i < 4; i++)
+		panel_byte(bytes[i], 1);
+	panel_byte(0x2b, 0);
+	for (int i = 4; i < 8; i++)
+		panel_byte(bytes[i], 1);
+	panel_byte(0x2c, 0);
+}
+static void ref_pixel(uint16_t colour)
+{
+	panel_byte(colour >> 8, 1);
+	panel_byte(colour & 0xff, 1);
+}
+static void old_putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
+{
+	ref_window(x, y, width, height);
+	for (int row = 0; row < height; row++)
+	{
+		uint32_t offset = (vOrientation ? height - (row + 1) : row) * width;
+		for (int col = 0; col < width; col++)
+			ref_pixel(Image[offset + (hOrientation ? width - col - 1 : col)]);
+	}
+	target = &panel;
+}
+static void old_putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh)
+{
+	int32_t step = hOrientation ? -1 : 1;
+	ref_window(x, y, sw, sh);
+	for (uint16_t row = sy; row < sy + sh; row++)
+	{
+		const uint16_t *src = Image + (vOrientation ? (height - row - 1) : row) * width;
+		src += hOrientation ? (width - sx - 1) : sx;
+		for (uint16_t col = 0; col < sw; col++)
+		{
+			ref_pixel(*src);
+			src += step;
+		}
+	}
+	target = &panel;
+}
+
+static void start_case(void)
+{
+	// Both screens start out the same and not black, so a pixel left alone shows up
+	memset(&panel, 0, sizeof(panel));
+	memset(panel.gram, 0xaa, sizeof(panel.gram));
+	panel.madctl = MADCTL_DEFAULT;
+	panel.high = -1;
+	reference = panel;
+}
+static void end_case(const char *what, int id, int flips, int a, int b, int c, int d)
+{
+	int bad = memcmp(panel.gram, reference.gram, sizeof(panel.gram)) != 0;
+	if (panel.madctl != MADCTL_DEFAULT)
+		bad = 1;
+	if (bad && failures++ < MAX_REPORTED)
+		printf("%s: sprite %d flips %d (%d %d %d %d) differs%s\n", what, id, flips, a, b, c, d,
+		       (panel.madctl != MADCTL_DEFAULT) ? ", MADCTL left changed" : "");
+}
+
+// xorshift32, the places are the same every run
+static uint32_t next_random(void)
+{
+	static uint32_t state = 2463534242u;
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+// Stand-ins for what display.c uses from the rest of the game. tools/host/host.c has
+// the register blocks too but also its own display, which this needs to be the real one.
+GPIO_TypeDef host_gpioa;
+RCC_TypeDef host_rcc;
+SPI_TypeDef host_spi1;
+void delay(uint32_t dly)
+{
+}
@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include "bot.h"
+
+#define STEP 4            // pixels ahead checked for spikes, a few frames of walking
+#define SKELETON_NEAR_X 28
+#define SKELETON_NEAR_Y 32
+#define MIN_X 10          // where motion.c keeps the knight
+#define MIN_Y 32
+#define RIGHT_GAP 18
+#define BOTTOM_GAP 20
+
+static void wander(Bot *b, int *xdir, int *ydir);
+static int spiked(const LevelLayout *l, int x, int y);
+static void approach(const BotView *v, const Waypoint *o, int *tx, int *ty);
+
+void bot_init(Bot *b, int kind, uint64_t seed)
+{
+	b->kind = kind;
+	b->rng = seed ? seed : 1;
+	b->walk_x = b->walk_y = 0;
+	b->walk_frames = 0;
+	b->still = 0;
+	b->x = b->y = 0;
+	b->side = 1;
+	b->blocked = 0;
+}
+uint32_t bot_random(Bot *b)
+{
+	// xorshift64*
+	b->rng ^= b->rng >> 12;
+	b->rng ^= b->rng << 25;
+	b->rng ^= b->rng >> 27;
+	return (uint32_t)((b->rng * 0x2545f4914f6cdd1dull) >> 32);
+}
+int bot_touching(const Waypoint *o, int x, int y)
+{
+	// The same test as touching in main.c: a corner of the knight at x,y lies inside the
+	// 12x16 sprite at o, edges included
+	int x2 = o->x + 12, y2 = o->y + 16;
+	for (int i = 0; i < 4; i++)
+	{
+		int px = x + ((i & 1) ? 12 : 0);
+		int py = y + ((i & 2) ? 16 : 0);
+		if (px >= o->x && px <= x2 && py >= o->y && py <= y2)
+			return 1;
+	}
+	return 0;
+}
+void bot_move(Bot *b, const BotView *v, int *xdir, int *ydir)
+{
+	const LevelLayout *l = v->layout;
+	const Waypoint *target = &l->door;
+	int best = 1 << 30;
+	int tx, ty;
+	int blocked = 0; // 1 if a spike is in the way across, 2 if up or down
+	*xdir = *ydir = 0;
+	if (b->kind == BOT_RANDOM || b->walk_frames > 0)
+	{
+		wander(b, xdir, ydir);
+		return;
+	}
+	// Nearest key still to find, or the door once they are all found
+	for (int i = 0; i < l->num_keys; i++)
+	{
+		int d = abs(l->keys[i].x - v->x) + abs(l->keys[i].y - v->y);
+		if (!v->key_pickup[i] && d < best)
+		{
+			best = d;
+			target = &l->keys[i];
+		}
+	}
+	approach(v, target, &tx, &ty);
+	*xdir = (tx > v->x) - (tx < v->x);
+	*ydir = (ty > v->y) - (ty < v->y);
+	// Drop whichever part of the move would walk into a spike and go round it along
+	// the other axis. The side to go round starts out as the way the target is and
+	// flips if it runs into the edge of the level.
+	if (*xdir && spiked(l, v->x + STEP * *xdir, v->y))
+		blocked = 1;
+	else if (*ydir && spiked(l, v->x, v->y + STEP * *ydir))
+		blocked = 2;
+	if (blocked)
+	{
+		int along = (blocked == 1) ? *ydir : *xdir; // the target's way along the other axis
+		if (b->blocked != blocked)
+			b->side = along ? along : ((bot_random(b) & 1) ? 1 : -1);
+		else if (b->still > 5)
+		{
+			b->side = -b->side;
+			b->still = 0;
+		}
+		*xdir = (blocked == 1) ? 0 : b->side;
+		*ydir = (blocked == 1) ? b->side : 0;
+		if (spiked(l, v->x + STEP * *xdir, v->y + STEP * *ydir))
+			*xdir = *ydir = 0;
+		b->blocked = blocked;
+	}
+	else if (*xdir && *ydir && spiked(l, v->x + STEP * *xdir, v->y + STEP * *ydir))
+	{
+		// Cutting the corner, carry on past the spike the way it was in the way
+		if (b->blocked == 2)
+			*xdir = 0;
+		else
+			*ydir = 0;
+	}
+	else
+	{
+		b->blocked = 0;
+	}
+	// Back away from any skeleton that comes close, unless that means a spike
+	for (int i = 0; i < l->num_enemies; i++)
+	{
+		int dx = v->x - v->enemies[i].x;
+		int dy = v->y - v->enemies[i].y;
+		int ax = (dx > 0) ? 1 : -1;
+		int ay = (dy > 0) ? 1 : -1;
+		if (abs(dx) < SKELETON_NEAR_X && abs(dy) < SKELETON_NEAR_Y && !spiked(l, v->x + STEP * ax, v->y + STEP * ay))
+		{
+			*xdir = ax;
+			*ydir = ay;
+		}
+	}
+	// Stuck against the edge of the level or something the above doesn't handle,
+	// wander off for a bit and try again
+	if (v->x == b->x && v->y == b->y && !v->down)
+		b->still++;
+	else
+		b->still = 0;
+	b->x = v->x;
+	b->y = v->y;
+	if (b->still > 10)
+	{
+		b->still = 0;
+		b->walk_frames = 10 + (int)(bot_random(b) % 30);
+	}
+}
+
+// Keeps walking one way for a while, then picks another (which may be standing still)
+static void wander(Bot *b, int *xdir, int *ydir)
+{
+	if (b->walk_frames <= 0)
+	{
+		b->walk_x = (int)(bot_random(b) % 3) - 1;
+		b->walk_y = (int)(bot_random(b) % 3) - 1;
+		b->walk_frames = 5 + (int)(bot_random(b) % 30);
+	}
+	b->walk_frames--;
+	*xdir = b->walk_x;
+	*ydir = b->walk_y;
+}
+
+// 1 if the knight would touch a spike at x,y
+static int spiked(const LevelLayout *l, int x, int y)
+{
+	for (int i = 0; i < l->num_spikes; i++)
+	{
+		if (bot_touching(&l->spikes[i], x, y))
+			return 1;
+	}
+	return 0;
+}
+
+// The nearest place to the knight he can stand to touch o without touching a spike.
+// Keys can sit right up against a spike.
+static void approach(const BotView *v, const Waypoint *o, int *tx, int *ty)
+{
+	int width = v->layout->width ? v->layout->width : 128;
+	int height = v->layout->height ? v->layout->height : 160;
+	int best = 1 << 30;
+	*tx = o->x;
+	*ty = o->y;
+	for (int y = o->y - 16; y <= o->y + 16; y++)
+	{
+		for (int x = o->x - 12; x <= o->x + 12; x++)
+		{
+			int d = abs(x - v->x) + abs(y - v->y);
+			if (d >= best || x < MIN_X || y < MIN_Y || x > width - RIGHT_GAP || y > height - BOTTOM_GAP)
+				continue;
+			if (bot_touching(o, x, y) && !spiked(v->layout, x, y))
+			{
+				best = d;
+				*tx = x;
+				*ty = y;
+			}
+		}
+	}
+}
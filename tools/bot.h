@@ -0,0 +1,39 @@
+#ifndef BOT_H
+#define BOT_H
+#include <stdint.h>
+#include "level.h"
+
+// Scripted players for the host tools. The random bot walks a random direction for a
+// while and then picks another. The greedy bot heads for the nearest key it hasn't got
+// and then the door, goes round spikes and backs away from skeletons that come close.
+#define BOT_RANDOM 0
+#define BOT_GREEDY 1
+#define BOT_KINDS 2
+
+// What a bot can see of a level
+typedef struct
+{
+	const LevelLayout *layout;
+	uint16_t x, y;          // the knight
+	int down;               // the knight can't move at the moment
+	const int *key_pickup;  // non zero for each key found
+	const Enemy *enemies;   // layout->num_enemies of them
+} BotView;
+
+typedef struct
+{
+	int kind;
+	uint64_t rng;           // its own random numbers, so bots on different threads don't share
+	int walk_x, walk_y;     // direction being walked, random bot and unsticking
+	int walk_frames;        // frames left in walk
+	int still;              // frames the knight has stayed put
+	uint16_t x, y;          // where the knight was last frame
+	int side;               // which way to go round a spike
+	int blocked;            // the way a spike was last in the way, as in bot_move
+} Bot;
+
+void bot_init(Bot *b, int kind, uint64_t seed);
+uint32_t bot_random(Bot *b);
+void bot_move(Bot *b, const BotView *v, int *xdir, int *ydir);
+int bot_touching(const Waypoint *o, int x, int y);
+#endif
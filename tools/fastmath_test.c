@@ -0,0 +1,132 @@
+// Host check that the divide free arithmetic gives exactly what division does.
+//   divu10 and divmodu10  every 32 bit input
+//   DIVU8 and MODU8       every n from 0 to 255 with every d from 1 to 256
+//   digits10/fmt_uint_pad against printf: every 16 bit value at printNumber's width
+//                         and padding, every value below 2^24, every value within
+//                         1000 of a power of ten and of 2^32, and random ones
+// Exits with 1 on the first mismatch. Cycle counts come from the target, see
+// fastmath_bench.
+//
+// Build from the repository root with:
+//   cc -O2 -I. -o fastmath_test tools/fastmath_test.c fastmath.c format.c
+// Usage:
+//   ./fastmath_test [random values]
+// Defaults to 20 million random values.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fastmath.h"
+#include "format.h"
+
+static int check_digits(uint32_t value);
+static int check_padded(uint32_t value);
+static uint32_t xorshift(uint32_t *state);
+
+int main(int argc, char *argv[])
+{
+	long randoms = (argc > 1) ? atol(argv[1]) : 20000000;
+	uint32_t state = 88172645;
+	uint64_t power = 1;
+
+	// Every 32 bit value, counting down from 2^32 - 1 to 0
+	for (uint32_t n = 0xffffffffu;; n--)
+	{
+		uint32_t rem;
+		uint32_t q = divmodu10(n, &rem);
+		if (q != n / 10 || rem != n % 10 || divu10(n) != n / 10)
+		{
+			printf("divmodu10(%u) gave %u rem %u\n", n, q, rem);
+			return 1;
+		}
+		if (n == 0)
+			break;
+	}
+	printf("divu10, divmodu10: all 2^32 inputs match\n");
+
+	for (uint32_t d = 1; d <= 256; d++)
+	{
+		for (uint32_t n = 0; n < 256; n++)
+		{
+			if (DIVU8(n, d) != n / d || MODU8(n, d) != n % d)
+			{
+				printf("DIVU8(%u, %u) gave %u rem %u\n", n, d, (unsigned)DIVU8(n, d), (unsigned)MODU8(n, d));
+				return 1;
+			}
+		}
+	}
+	printf("DIVU8, MODU8: all 65536 pairs match\n");
+
+	for (uint32_t n = 0; n <= 0xffff; n++)
+	{
+		if (check_padded(n))
+			return 1;
+	}
+	for (uint32_t n = 0; n < (1u << 24); n++)
+	{
+		if (check_digits(n))
+			return 1;
+	}
+	for (int i = 0; i <= 10; i++, power *= 10)
+	{
+		for (int64_t n = (int64_t)power - 1000; n <= (int64_t)power + 1000; n++)
+		{
+			if (n >= 0 && n <= 0xffffffffll && check_digits((uint32_t)n))
+				return 1;
+		}
+	}
+	for (uint32_t n = 0xffffffffu - 1000; n != 0; n++)
+	{
+		if (check_digits(n))
+			return 1;
+	}
+	for (long i = 0; i < randoms; i++)
+	{
+		if (check_digits(xorshift(&state)))
+			return 1;
+	}
+	printf("digits10, fmt_uint_pad: match printf for %ld random values and the ranges above\n", randoms);
+	return 0;
+}
+
+static int check_digits(uint32_t value)
+{
+	char ours[12], theirs[12];
+	int len = digits10(value, ours);
+	ours[len] = 0;
+	snprintf(theirs, sizeof(theirs), "%u", value);
+	if (strcmp(ours, theirs) != 0)
+	{
+		printf("digits10(%u) gave %s\n", value, ours);
+		return 1;
+	}
+	fmt_uint_pad(ours, value, 10, '0');
+	snprintf(theirs, sizeof(theirs), "%010u", value);
+	if (strcmp(ours, theirs) != 0)
+	{
+		printf("fmt_uint_pad(%u, 10, '0') gave %s\n", value, ours);
+		return 1;
+	}
+	return 0;
+}
+static int check_padded(uint32_t value)
+{
+	// As printNumber formats them
+	char ours[12], theirs[12];
+	fmt_uint_pad(ours, value, 5, '0');
+	snprintf(theirs, sizeof(theirs), "%05u", value);
+	if (strcmp(ours, theirs) != 0)
+	{
+		printf("fmt_uint_pad(%u, 5, '0') gave %s\n", value, ours);
+		return 1;
+	}
+	return check_digits(value);
+}
+static uint32_t xorshift(uint32_t *state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
@@ -0,0 +1,175 @@
+// Host check of the formatter in format.c against printf, or for fmt_fixed against the
+// same sum done in 64 bits. Every function's return value must be the length written.
+//   fmt_uint      every 16 bit value, powers of ten either side, the top of the range
+//   fmt_int       the same both signs, INT32_MIN, INT32_MAX, -1 and 0
+//   fmt_uint_pad  widths 0 to 12 with '0' and ' ', wider values than width unclipped
+//   fmt_hex       0 to 10 digits, anything over 8 giving all 8
+//   fmt_fixed     0 to 27 fractional bits with 0 to 9 decimals, truncated towards zero
+//                 (so 0.99998 is 0.9999 and a tiny negative value -0.0000), INT32_MIN
+// plus random values for all of them. Exits with 1 on the first mismatch.
+//
+// Build from the repository root with:
+//   cc -O2 -I. -o format_test tools/format_test.c format.c fastmath.c
+// Usage:
+//   ./format_test [random values]
+// Defaults to 2 million random values.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "format.h"
+
+static const uint32_t edges[] = {0, 1, 9, 10, 99, 100, 65535, 65536, 999999999, 1000000000, 2147483647u, 2147483648u, 4294967294u, 4294967295u};
+#define EDGES (sizeof(edges) / sizeof(edges[0]))
+
+static int check(const char *what, const char *ours, int len, const char *expected);
+static int check_value(uint32_t value);
+static int check_fixed(int32_t value, int frac_bits, int decimals);
+static void fixed_reference(char *out, int32_t value, int frac_bits, int decimals);
+static uint32_t xorshift(uint32_t *state);
+
+int main(int argc, char *argv[])
+{
+	long randoms = (argc > 1) ? atol(argv[1]) : 2000000;
+	uint32_t state = 88172645;
+	uint64_t power = 1;
+	char ours[40];
+
+	for (uint32_t n = 0; n <= 0xffff; n++)
+	{
+		if (check_value(n))
+			return 1;
+	}
+	for (int i = 0; i <= 10; i++, power *= 10)
+	{
+		for (int64_t n = (int64_t)power - 100; n <= (int64_t)power + 100; n++)
+		{
+			if (n >= 0 && n <= 0xffffffffll && check_value((uint32_t)n))
+				return 1;
+		}
+	}
+	for (uint32_t i = 0; i < EDGES; i++)
+	{
+		if (check_value(edges[i]))
+			return 1;
+	}
+	for (long i = 0; i < randoms; i++)
+	{
+		if (check_value(xorshift(&state)))
+			return 1;
+	}
+	printf("fmt_uint, fmt_int, fmt_uint_pad, fmt_hex: match printf for %ld random values and the ranges above\n", randoms);
+
+	// The cases the game cares about, spelled out
+	if (check("fmt_int(INT32_MIN)", ours, fmt_int(ours, INT32_MIN), "-2147483648") ||
+	    check("fmt_int(INT32_MAX)", ours, fmt_int(ours, INT32_MAX), "2147483647") ||
+	    check("fmt_int(0)", ours, fmt_int(ours, 0), "0") ||
+	    check("fmt_uint_pad(12345, 3, '0')", ours, fmt_uint_pad(ours, 12345, 3, '0'), "12345") ||
+	    check("fmt_uint_pad(0, 5, '0')", ours, fmt_uint_pad(ours, 0, 5, '0'), "00000") ||
+	    check("fmt_hex(0xbeef, 10)", ours, fmt_hex(ours, 0xbeef, 10), "0000BEEF") ||
+	    check("fmt_hex(0, 0)", ours, fmt_hex(ours, 0, 0), "0") ||
+	    check("fmt_fixed(0.1 in Q16.16, 4)", ours, fmt_fixed(ours, 6554, 16, 4), "0.1000") ||
+	    check("fmt_fixed(0.99998 in Q16.16, 4)", ours, fmt_fixed(ours, 0xffff, 16, 4), "0.9999") ||
+	    check("fmt_fixed(-0.5 in Q16.16, 2)", ours, fmt_fixed(ours, -0x8000, 16, 2), "-0.50") ||
+	    check("fmt_fixed(-2^-16 in Q16.16, 4)", ours, fmt_fixed(ours, -1, 16, 4), "-0.0000") ||
+	    check("fmt_fixed(INT32_MIN in Q16.16, 4)", ours, fmt_fixed(ours, INT32_MIN, 16, 4), "-32768.0000") ||
+	    check("fmt_fixed(INT32_MAX in Q16.16, 5)", ours, fmt_fixed(ours, INT32_MAX, 16, 5), "32767.99998") ||
+	    check("fmt_fixed(1.5 in Q16.16, 0)", ours, fmt_fixed(ours, 0x18000, 16, 0), "1") ||
+	    check("fmt_fixed(-7 in Q0, 3)", ours, fmt_fixed(ours, -7, 0, 3), "-7.000"))
+		return 1;
+
+	for (int frac_bits = 0; frac_bits <= 27; frac_bits++)
+	{
+		for (int decimals = 0; decimals <= 9; decimals++)
+		{
+			int32_t near[] = {0, 1, -1, INT32_MIN, INT32_MAX, (int32_t)(1u << frac_bits), -(int32_t)(1u << frac_bits),
+			                  (int32_t)((1u << frac_bits) - 1), -(int32_t)((1u << frac_bits) - 1)};
+			for (uint32_t i = 0; i < sizeof(near) / sizeof(near[0]); i++)
+			{
+				if (check_fixed(near[i], frac_bits, decimals))
+					return 1;
+			}
+			for (long i = 0; i < randoms / 280; i++)
+			{
+				if (check_fixed((int32_t)xorshift(&state), frac_bits, decimals))
+					return 1;
+			}
+		}
+	}
+	printf("fmt_fixed: matches the 64 bit sum for every frac_bits and decimals, and the cases above\n");
+	return 0;
+}
+
+static int check(const char *what, const char *ours, int len, const char *expected)
+{
+	if (strcmp(ours, expected) != 0 || len != (int)strlen(ours))
+	{
+		printf("%s gave \"%s\" length %d, expected \"%s\"\n", what, ours, len, expected);
+		return 1;
+	}
+	return 0;
+}
+static int check_value(uint32_t value)
+{
+	char ours[40], expected[40], what[64];
+	int32_t s = (int32_t)value;
+	snprintf(what, sizeof(what), "fmt_uint(%u)", value);
+	snprintf(expected, sizeof(expected), "%u", value);
+	if (check(what, ours, fmt_uint(ours, value), expected))
+		return 1;
+	snprintf(what, sizeof(what), "fmt_int(%d)", s);
+	snprintf(expected, sizeof(expected), "%d", s);
+	if (check(what, ours, fmt_int(ours, s), expected))
+		return 1;
+	s = (int32_t)(0u - value);
+	snprintf(what, sizeof(what), "fmt_int(%d)", s);
+	snprintf(expected, sizeof(expected), "%d", s);
+	if (check(what, ours, fmt_int(ours, s), expected))
+		return 1;
+	for (int width = 0; width <= 12; width++)
+	{
+		snprintf(what, sizeof(what), "fmt_uint_pad(%u, %d, '0')", value, width);
+		snprintf(expected, sizeof(expected), "%0*u", width, value);
+		if (check(what, ours, fmt_uint_pad(ours, value, width, '0'), expected))
+			return 1;
+		snprintf(what, sizeof(what), "fmt_uint_pad(%u, %d, ' ')", value, width);
+		snprintf(expected, sizeof(expected), "%*u", width, value);
+		if (check(what, ours, fmt_uint_pad(ours, value, width, ' '), expected))
+			return 1;
+	}
+	for (int digits = 0; digits <= 10; digits++)
+	{
+		snprintf(what, sizeof(what), "fmt_hex(%u, %d)", value, digits);
+		snprintf(expected, sizeof(expected), "%0*X", digits > 8 ? 8 : digits, value);
+		if (check(what, ours, fmt_hex(ours, value, digits), expected))
+			return 1;
+	}
+	return 0;
+}
+static int check_fixed(int32_t value, int frac_bits, int decimals)
+{
+	char ours[40], expected[40], what[64];
+	snprintf(what, sizeof(what), "fmt_fixed(%d, %d, %d)", value, frac_bits, decimals);
+	fixed_reference(expected, value, frac_bits, decimals);
+	return check(what, ours, fmt_fixed(ours, value, frac_bits, decimals), expected);
+}
+static void fixed_reference(char *out, int32_t value, int frac_bits, int decimals)
+{
+	// The magnitude's fraction scaled up by 10^decimals and truncated, in one go
+	uint64_t magnitude = (value < 0) ? 0u - (uint32_t)value : (uint32_t)value;
+	uint64_t scale = 1;
+	for (int i = 0; i < decimals; i++)
+		scale *= 10;
+	uint64_t frac = ((magnitude & ((1ull << frac_bits) - 1)) * scale) >> frac_bits;
+	int n = sprintf(out, "%s%llu", (value < 0) ? "-" : "", (unsigned long long)(magnitude >> frac_bits));
+	if (decimals > 0)
+		sprintf(out + n, ".%0*llu", decimals, (unsigned long long)frac);
+}
+static uint32_t xorshift(uint32_t *state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
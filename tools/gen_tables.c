@@ -0,0 +1,127 @@
+// Generates the constant tables the game would otherwise work out at run time:
+//   note_periods.h  TIM14 auto reload value for every note in musical_notes.h, what
+//                   playNote used to divide out for each note played
+//   palette.h       the game's colours already packed the way RGBToWord packs them
+// Run from the repository root after changing musical_notes.h or the palette below,
+// and commit the headers it writes:
+//   cc -o gen_tables tools/gen_tables.c && ./gen_tables
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TIMER_HZ 65536 // TIM14's count rate, see initSound
+#define NEWLINE "\r\n" // the rest of the tree has DOS line endings
+
+// Name, red, green, blue
+static const struct
+{
+	const char *name;
+	uint8_t r, g, b;
+} palette[] =
+{
+	{"WHITE", 255, 255, 255},
+	{"BLACK", 0, 0, 0},
+	{"RED", 255, 0, 0},
+	{"GREEN", 0, 255, 0},
+	{"ORANGE", 255, 165, 0},
+	{"PURPLE", 128, 0, 128},
+	{"CREAM", 255, 255, 204},
+	{"GREY", 64, 64, 64},
+	{"DARK_GREY", 32, 32, 32},
+};
+
+static uint16_t rgb_to_word(uint16_t R, uint16_t G, uint16_t B);
+static int write_notes(const char *from, const char *to);
+static int write_palette(const char *to);
+
+int main(void)
+{
+	if (write_notes("musical_notes.h", "note_periods.h") != 0)
+		return 1;
+	if (write_palette("palette.h") != 0)
+		return 1;
+	return 0;
+}
+
+// The same packing as RGBToWord in display.c, which must stay in step with this
+static uint16_t rgb_to_word(uint16_t R, uint16_t G, uint16_t B)
+{
+	uint16_t rvalue = 0;
+	rvalue += G >> 5;
+	rvalue += (G & (7)) << 13;
+	rvalue += (R >> 3) << 8;
+	rvalue += (B >> 3) << 3;
+	return rvalue;
+}
+
+// A PERIOD_ define for every frequency defined in musical_notes.h
+static int write_notes(const char *from, const char *to)
+{
+	char line[256], name[64];
+	unsigned freq;
+	int count = 0;
+	FILE *in = fopen(from, "r");
+	FILE *out;
+	if (!in)
+	{
+		perror(from);
+		return 1;
+	}
+	out = fopen(to, "wb");
+	if (!out)
+	{
+		perror(to);
+		fclose(in);
+		return 1;
+	}
+	fprintf(out, "// Generated by tools/gen_tables.c from musical_notes.h, don't edit." NEWLINE);
+	fprintf(out, "// TIM14 auto reload values for each note, %d / frequency, for playNote." NEWLINE, TIMER_HZ);
+	fprintf(out, "// PERIOD_REST is silence." NEWLINE);
+	fprintf(out, "#define PERIOD_REST\t0" NEWLINE);
+	while (fgets(line, sizeof(line), in))
+	{
+		if (sscanf(line, "#define %63s %u", name, &freq) != 2 || freq == 0)
+			continue;
+		if (TIMER_HZ / freq > 0xffff)
+		{
+			fprintf(stderr, "%s: %s is too low for the timer\n", from, name);
+			fclose(in);
+			fclose(out);
+			return 1;
+		}
+		fprintf(out, "#define PERIOD_%s\t%u" NEWLINE, name, TIMER_HZ / freq);
+		count++;
+	}
+	fclose(in);
+	if (fclose(out) != 0)
+	{
+		perror(to);
+		return 1;
+	}
+	printf("%s: %d notes\n", to, count);
+	return 0;
+}
+
+static int write_palette(const char *to)
+{
+	FILE *out = fopen(to, "wb");
+	if (!out)
+	{
+		perror(to);
+		return 1;
+	}
+	fprintf(out, "// Generated by tools/gen_tables.c, don't edit." NEWLINE);
+	fprintf(out, "// The game's colours as RGBToWord would make them, bytes swapped for the panel." NEWLINE);
+	for (size_t i = 0; i < sizeof(palette) / sizeof(palette[0]); i++)
+	{
+		fprintf(out, "#define COLOUR_%s\t0x%04x // %u, %u, %u" NEWLINE, palette[i].name,
+		        rgb_to_word(palette[i].r, palette[i].g, palette[i].b), palette[i].r, palette[i].g, palette[i].b);
+	}
+	if (fclose(out) != 0)
+	{
+		perror(to);
+		return 1;
+	}
+	printf("%s: %d colours\n", to, (int)(sizeof(palette) / sizeof(palette[0])));
+	return 0;
+}
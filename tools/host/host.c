@@ -0,0 +1,180 @@
+// Host stand-ins for the hardware the game drives: register blocks for the fake
+// stm32f031x6.h, and the display, serial, sound and power modules. The display only
+// counts the pixels it would have pushed, serial is dropped unless echoed, and a sleep
+// lasts until the next SysTick like it does on the chip.
+#include <stdio.h>
+#include <string.h>
+#include <stm32f031x6.h>
+#include "display.h"
+#include "serial.h"
+#include "sound.h"
+#include "power.h"
+#include "host.h"
+
+#define FONT_WIDTH 5
+#define FONT_HEIGHT 7
+
+GPIO_TypeDef host_gpioa, host_gpiob;
+RCC_TypeDef host_rcc;
+FLASH_TypeDef host_flash;
+SPI_TypeDef host_spi1;
+USART_TypeDef host_usart1;
+TIM_TypeDef host_tim2, host_tim14, host_tim16;
+PWR_TypeDef host_pwr;
+EXTI_TypeDef host_exti;
+SYSCFG_TypeDef host_syscfg;
+IWDG_TypeDef host_iwdg;
+DBGMCU_TypeDef host_dbgmcu;
+RTC_TypeDef host_rtc;
+SysTick_Type host_systick;
+SCB_Type host_scb;
+
+uint64_t host_pixels = 0;
+uint16_t host_note = 0;
+uint32_t host_serial_bytes = 0;
+int host_serial_echo = 0;
+
+void SysTick_Handler(void);
+
+void host_tick(uint32_t ms)
+{
+	while (ms--)
+		SysTick_Handler();
+}
+
+// Display: the panel is always ready and every call costs what it would write
+void display_begin(int cold)
+{
+}
+int display_poll(uint32_t now)
+{
+	return 1;
+}
+void display_sleep(void)
+{
+}
+void display_wake(void)
+{
+}
+void display_scroll_area(uint16_t top, uint16_t height)
+{
+}
+void display_scroll_to(uint16_t line)
+{
+}
+void fillRectangle(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t colour)
+{
+	host_pixels += (uint32_t)width * height;
+}
+void putPixel(uint16_t x, uint16_t y, uint16_t colour)
+{
+	host_pixels++;
+}
+void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
+{
+	host_pixels += (uint32_t)width * height;
+}
+void putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh)
+{
+	host_pixels += (uint32_t)sw * sh;
+}
+void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t Colour)
+{
+	host_pixels += (x1 > x0 ? x1 - x0 : x0 - x1) + (y1 > y0 ? y1 - y0 : y0 - y1) + 1;
+}
+void drawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t Colour)
+{
+	host_pixels += 2u * (w + h);
+}
+void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
+{
+	host_pixels += 6u * radius;
+}
+void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t Colour)
+{
+	host_pixels += 3u * radius * radius;
+}
+void printText(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	host_pixels += strlen(Text) * FONT_WIDTH * FONT_HEIGHT;
+}
+void printTextX2(const char *Text, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	host_pixels += strlen(Text) * FONT_WIDTH * FONT_HEIGHT * 4;
+}
+void printNumber(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	host_pixels += 5 * FONT_WIDTH * FONT_HEIGHT;
+}
+void printNumberX2(uint16_t Number, uint16_t x, uint16_t y, uint16_t ForeColour, uint16_t BackColour)
+{
+	host_pixels += 5 * FONT_WIDTH * FONT_HEIGHT * 4;
+}
+uint16_t RGBToWord(uint16_t R, uint16_t G, uint16_t B)
+{
+	// Same byte swapped RGB565 as display.c
+	uint16_t rvalue = 0;
+	rvalue += G >> 5;
+	rvalue += (G & (7)) << 13;
+	rvalue += (R >> 3) << 8;
+	rvalue += (B >> 3) << 3;
+	return rvalue;
+}
+
+// Serial
+void initSerial(void)
+{
+}
+void eputchar(char c)
+{
+	host_serial_bytes++;
+	if (host_serial_echo && c != '\r')
+		putchar(c);
+}
+char egetchar(void)
+{
+	return 0;
+}
+void eputs(char *String)
+{
+	while (*String)
+		eputchar(*String++);
+}
+void printDecimal(int32_t Value)
+{
+	char text[12];
+	snprintf(text, sizeof(text), "%d", (int)Value);
+	eputs(text);
+}
+
+// Sound
+void initSound(void)
+{
+}
+void playNote(uint16_t Period)
+{
+	host_note = Period;
+}
+
+// Power: the only interrupt is SysTick, so that is what any sleep waits for
+void initPower(void)
+{
+}
+void power_sleep(void)
+{
+	host_tick(1);
+}
+void power_idle(void)
+{
+	host_tick(1);
+}
+void power_activity(void)
+{
+}
+void power_report(void)
+{
+}
+uint32_t power_idle_percent(void)
+{
+	return 0;
+}
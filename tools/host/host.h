@@ -0,0 +1,13 @@
+#ifndef HOST_H
+#define HOST_H
+#include <stdint.h>
+
+// What the stand-in peripherals in host.c saw. Tools clear these as they like.
+extern uint64_t host_pixels;      // pixels the game sent to the panel
+extern uint16_t host_note;        // period last passed to playNote, 0 when silent
+extern uint32_t host_serial_bytes; // bytes written to the serial port
+extern int host_serial_echo;      // copy serial output to stdout
+
+// Runs ms SysTick interrupts, which is what moves the game's clock and timers on
+void host_tick(uint32_t ms);
+#endif
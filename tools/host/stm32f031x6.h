@@ -0,0 +1,76 @@
+// Host stand-in for the STM32F031 device header, for building the game on a PC.
+// Every peripheral is a plain struct in RAM (see host.c) so register writes land
+// somewhere harmless and a test can set inputs such as GPIOx->IDR directly.
+// Only the parts of the CMSIS header the game uses are here.
+//
+// Put tools/host ahead of anything else on the include path:
+//   cc -Itools/host -I. ...
+#ifndef HOST_STM32F031X6_H
+#define HOST_STM32F031X6_H
+#include <stdint.h>
+
+#define __IO volatile
+#define __asm(x) // cpsie, cpsid and wfi: there are no interrupts to mask or wait for
+
+typedef struct { __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2], BRR; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CR, CFGR, CIR, APB2RSTR, APB1RSTR, AHBENR, APB2ENR, APB1ENR, BDCR, CSR, AHBRSTR, CFGR2, CFGR3, CR2; } RCC_TypeDef;
+typedef struct { __IO uint32_t ACR, KEYR, OPTKEYR, SR, CR, AR, RESERVED, OBR, WRPR; } FLASH_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, SR, DR, CRCPR, RXCRCR, TXCRCR, I2SCFGR, I2SPR; } SPI_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, CR3, BRR, GTPR, RTOR, RQR, ISR, ICR, RDR, TDR; } USART_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR, CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR; } TIM_TypeDef;
+typedef struct { __IO uint32_t CR, CSR; } PWR_TypeDef;
+typedef struct { __IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR; } EXTI_TypeDef;
+typedef struct { __IO uint32_t CFGR1, RESERVED, EXTICR[4], CFGR2; } SYSCFG_TypeDef;
+typedef struct { __IO uint32_t KR, PR, RLR, SR, WINR; } IWDG_TypeDef;
+typedef struct { __IO uint32_t IDCODE, CR, APB1FZ, APB2FZ; } DBGMCU_TypeDef;
+typedef struct { __IO uint32_t TR, DR, CR, ISR, PRER, WUTR, RESERVED0, ALRMAR, RESERVED1, WPR, SSR, SHIFTR, TSTR, TSDR, TSSSR, CALR, TAFCR, ALRMASSR; } RTC_TypeDef;
+typedef struct { __IO uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { __IO uint32_t CPUID, ICSR, RESERVED0, AIRCR, SCR, CCR, RESERVED1, SHP[2], SHCSR; } SCB_Type;
+
+extern GPIO_TypeDef host_gpioa, host_gpiob;
+extern RCC_TypeDef host_rcc;
+extern FLASH_TypeDef host_flash;
+extern SPI_TypeDef host_spi1;
+extern USART_TypeDef host_usart1;
+extern TIM_TypeDef host_tim2, host_tim14, host_tim16;
+extern PWR_TypeDef host_pwr;
+extern EXTI_TypeDef host_exti;
+extern SYSCFG_TypeDef host_syscfg;
+extern IWDG_TypeDef host_iwdg;
+extern DBGMCU_TypeDef host_dbgmcu;
+extern RTC_TypeDef host_rtc;
+extern SysTick_Type host_systick;
+extern SCB_Type host_scb;
+
+#define GPIOA (&host_gpioa)
+#define GPIOB (&host_gpiob)
+#define RCC (&host_rcc)
+#define FLASH (&host_flash)
+#define SPI1 (&host_spi1)
+#define USART1 (&host_usart1)
+#define TIM2 (&host_tim2)
+#define TIM14 (&host_tim14)
+#define TIM16 (&host_tim16)
+#define PWR (&host_pwr)
+#define EXTI (&host_exti)
+#define SYSCFG (&host_syscfg)
+#define IWDG (&host_iwdg)
+#define DBGMCU (&host_dbgmcu)
+#define RTC (&host_rtc)
+#define SysTick (&host_systick)
+#define SCB (&host_scb)
+
+typedef enum
+{
+	RTC_IRQn = 2,
+	EXTI4_15_IRQn = 7,
+	TIM2_IRQn = 15,
+	TIM14_IRQn = 19,
+	TIM16_IRQn = 21
+} IRQn_Type;
+
+#define SCB_SCR_SLEEPDEEP_Msk (1u << 2)
+#define NVIC_EnableIRQ(irq) ((void)(irq))
+#define NVIC_DisableIRQ(irq) ((void)(irq))
+#define NVIC_SetPriority(irq, priority) ((void)(irq), (void)(priority))
+#endif
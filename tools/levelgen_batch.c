@@ -0,0 +1,202 @@
+// Host batch mode for the procedural level generator.
+// Generates a range of seeds, checks every layout without the generator's own
+// validator and reports generation time percentiles. The fallback room that
+// levelgen_generate gives after LEVELGEN_ATTEMPTS is checked on its own first for
+// every number of keys, and any seed that ends up with it is counted. Reachability is checked by a
+// flood fill of every pixel the knight can stand on, with main.c's touching test,
+// rather than levelgen_validate's 8px lattice.
+//
+// Build from the repository root with:
+//   cc -O2 -I. -o levelgen_batch tools/levelgen_batch.c levelgen.c rng.c
+// Adding -DLEVELGEN_ATTEMPTS=1 sends every seed whose first attempt fails to the
+// fallback, which is then checked like any other layout.
+// Usage:
+//   ./levelgen_batch [seeds] [keys] [spikes] [enemies]
+// Defaults to a million seeds with Nightmare level 3 counts (3 keys, 3 spikes, 2 skeletons),
+// which takes a couple of minutes, mostly in the pixel flood fill.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "levelgen.h"
+
+// The area the knight can reach, as in levelgen.c
+#define MIN_X 10
+#define MAX_X 110
+#define MIN_Y 32
+#define MAX_Y 140
+#define AREA_W (MAX_X - MIN_X + 1)
+#define AREA_H (MAX_Y - MIN_Y + 1)
+
+static int check_layout(const LevelLayout *l);
+static int reachable(const LevelLayout *l);
+static int touching(const Waypoint *o, int x, int y);
+static int compare_u32(const void *a, const void *b);
+static uint64_t now_ns(void);
+
+int main(int argc, char *argv[])
+{
+	uint32_t seeds = (argc > 1) ? (uint32_t)strtoul(argv[1], 0, 0) : 1000000;
+	int keys = (argc > 2) ? atoi(argv[2]) : 3;
+	int spikes = (argc > 3) ? atoi(argv[3]) : 3;
+	int enemies = (argc > 4) ? atoi(argv[4]) : 2;
+	uint32_t *times = malloc(sizeof(uint32_t) * (seeds ? seeds : 1));
+	uint32_t failures = 0, nondeterministic = 0, max_attempts = 0, fell_back = 0;
+	uint64_t total_attempts = 0;
+	if (times == 0)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (int k = 0; k <= LEVEL_MAX_KEYS; k++)
+	{
+		LevelLayout f;
+		memset(&f, 0, sizeof(f));
+		levelgen_fallback(k, &f);
+		if (!check_layout(&f) || !levelgen_validate(&f))
+		{
+			printf("fallback room with %d keys: invalid layout\n", k);
+			free(times);
+			return 1;
+		}
+	}
+	for (uint32_t seed = 0; seed < seeds; seed++)
+	{
+		LevelLayout a, b;
+		uint64_t start;
+		memset(&a, 0, sizeof(a));
+		memset(&b, 0, sizeof(b));
+		start = now_ns();
+		int attempts = levelgen_generate(seed, keys, spikes, enemies, &a);
+		times[seed] = (uint32_t)(now_ns() - start);
+		total_attempts += attempts;
+		if ((uint32_t)attempts > max_attempts)
+			max_attempts = attempts;
+		if (attempts > LEVELGEN_ATTEMPTS)
+		{
+			fell_back++;
+			if (a.num_spikes || a.num_enemies)
+			{
+				if (failures < 10)
+					printf("seed %u: gave up but didn't return the fallback room\n", seed);
+				failures++;
+			}
+		}
+		if (!check_layout(&a))
+		{
+			if (failures < 10)
+				printf("seed %u: invalid layout\n", seed);
+			failures++;
+		}
+		levelgen_generate(seed, keys, spikes, enemies, &b);
+		if (memcmp(&a, &b, sizeof(a)) != 0)
+			nondeterministic++;
+	}
+	qsort(times, seeds, sizeof(uint32_t), compare_u32);
+	printf("seeds %u (keys %d spikes %d skeletons %d)\n", seeds, keys, spikes, enemies);
+	printf("invalid %u, not deterministic %u\n", failures, nondeterministic);
+	printf("attempts mean %.3f max %u, fell back to the open room %u\n", seeds ? (double)total_attempts / seeds : 0.0, max_attempts, fell_back);
+	if (seeds)
+	{
+		printf("generation time (host ns): p50 %u p90 %u p99 %u p99.9 %u max %u\n",
+		       times[seeds / 2], times[(uint64_t)seeds * 90 / 100], times[(uint64_t)seeds * 99 / 100],
+		       times[(uint64_t)seeds * 999 / 1000], times[seeds - 1]);
+	}
+	free(times);
+	return (failures || nondeterministic) ? 1 : 0;
+}
+int check_layout(const LevelLayout *l)
+{
+	// Checks made independently of the generator: everything inside the area the
+	// knight can reach, nothing sharing a tile, and everything reachable.
+	const Waypoint *all[2 + 1 + LEVEL_MAX_KEYS + LEVEL_MAX_SPIKES];
+	int n = 0;
+	all[n++] = &l->spawn[0];
+	all[n++] = &l->spawn[1];
+	all[n++] = &l->door;
+	for (int i = 0; i < l->num_keys; i++)
+		all[n++] = &l->keys[i];
+	for (int i = 0; i < l->num_spikes; i++)
+		all[n++] = &l->spikes[i];
+	for (int i = 0; i < n; i++)
+	{
+		if (all[i]->x < MIN_X || all[i]->x > MAX_X || all[i]->y < MIN_Y || all[i]->y > MAX_Y)
+			return 0;
+		for (int j = i + 1; j < n; j++)
+			if (all[i]->x == all[j]->x && all[i]->y == all[j]->y)
+				return 0;
+	}
+	for (int i = 0; i < l->num_enemies; i++)
+		if (l->patrol_len[i] < 2 || l->patrol[i][0].y != l->patrol[i][1].y)
+			return 0;
+	return reachable(l);
+}
+int reachable(const LevelLayout *l)
+{
+	// Flood fill one pixel at a time from the first spawn point, never touching a
+	// spike. Every key, the door and the second spawn point must be reached.
+	static uint8_t seen[AREA_H][AREA_W];
+	static uint16_t queue[AREA_H * AREA_W][2];
+	static const int8_t dir[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+	int head = 0, tail = 0;
+	int keys_found = 0, door_found = 0, spawn_found = 0;
+	int key_found[LEVEL_MAX_KEYS] = {0};
+	// Mark every place touching a spike as seen, so the fill never goes there
+	memset(seen, 0, sizeof(seen));
+	for (int i = 0; i < l->num_spikes; i++)
+		for (int y = l->spikes[i].y - 16; y <= l->spikes[i].y + 16; y++)
+			for (int x = l->spikes[i].x - 12; x <= l->spikes[i].x + 12; x++)
+				if (x >= MIN_X && x <= MAX_X && y >= MIN_Y && y <= MAX_Y)
+					seen[y - MIN_Y][x - MIN_X] = 1;
+	if (seen[l->spawn[0].y - MIN_Y][l->spawn[0].x - MIN_X] || seen[l->spawn[1].y - MIN_Y][l->spawn[1].x - MIN_X])
+		return 0;
+	seen[l->spawn[0].y - MIN_Y][l->spawn[0].x - MIN_X] = 1;
+	queue[tail][0] = l->spawn[0].x;
+	queue[tail++][1] = l->spawn[0].y;
+	while (head < tail)
+	{
+		int x = queue[head][0], y = queue[head++][1];
+		for (int k = 0; k < l->num_keys; k++)
+		{
+			if (!key_found[k] && touching(&l->keys[k], x, y))
+			{
+				key_found[k] = 1;
+				keys_found++;
+			}
+		}
+		door_found |= touching(&l->door, x, y);
+		spawn_found |= (x == l->spawn[1].x && y == l->spawn[1].y);
+		if (door_found && spawn_found && keys_found == l->num_keys)
+			return 1;
+		for (int d = 0; d < 4; d++)
+		{
+			int nx = x + dir[d][0], ny = y + dir[d][1];
+			if (nx < MIN_X || nx > MAX_X || ny < MIN_Y || ny > MAX_Y || seen[ny - MIN_Y][nx - MIN_X])
+				continue;
+			seen[ny - MIN_Y][nx - MIN_X] = 1;
+			queue[tail][0] = (uint16_t)nx;
+			queue[tail++][1] = (uint16_t)ny;
+		}
+	}
+	return 0;
+}
+int touching(const Waypoint *o, int x, int y)
+{
+	// touching in main.c, a corner of the knight at x,y inside the 12x16 sprite at o
+	// with edges included. Both are the same size, so that is the same as being no
+	// more than a sprite apart either way.
+	int dx = x - o->x, dy = y - o->y;
+	return dx >= -12 && dx <= 12 && dy >= -16 && dy <= 16;
+}
+int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
+uint64_t now_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Report where the firmware's flash and RAM go and how deep its stack can get.
+
+Compile every file with -fstack-usage, which leaves a .su file of stack bytes per
+function next to each object, link as usual and then:
+
+    tools/mem_report.py firmware.elf [build dir or .su files ...]
+
+The .su files are searched for under the given directories (default: the current
+one). The report has:
+
+  - flash and RAM used per section, against the STM32F031's 32KB and 4KB
+  - the biggest statics in RAM
+  - the functions with the biggest stack frames
+  - the worst case stack depth from main and from each interrupt handler, found by
+    walking the call graph taken from the disassembly, with the call chain
+  - whether the statics leave room for the window stack.c paints below main
+
+The worst case counts every interrupt as if it could nest on top of main's deepest
+call, with the 32 bytes the core stacks on entry. A call through a pointer (blx rN),
+such as a scene's update or a timer firing, is taken to reach any function whose
+address is stored somewhere: in .rodata or .data (the Scene tables, say) or in a
+literal pool in the code (a callback passed as an argument). Recursion can't be
+followed and is listed. Functions with no .su entry, such as libgcc's, count as 0 and
+are listed too.
+
+On a host build, link with -no-pie or the pointers are only filled in at load time,
+none are found and calls through them reach nothing. Even then the figures are the
+host compiler's, only good for trying the script out.
+
+Exits with 1 if the statics plus the worst case stack don't fit in RAM. Set OBJDUMP
+and NM to pick the tools (default arm-none-eabi-objdump and arm-none-eabi-nm).
+"""
+import os
+import re
+import subprocess
+import sys
+
+FLASH_SIZE = 32 * 1024
+RAM_ORIGIN = 0x20000000
+RAM_SIZE = 4 * 1024
+EXCEPTION_FRAME = 32  # r0-r3, r12, lr, pc and xPSR pushed by the core
+HANDLER = re.compile(r"(_Handler|_IRQHandler)$")
+
+
+def tool(name, default):
+    return os.environ.get(name, default)
+
+
+def run(args):
+    return subprocess.run(args, check=True, capture_output=True, text=True).stdout
+
+
+def sections(elf):
+    # "  0 .text  000012a4  08000000  08000000  00010000  2**2" then a line of flags
+    out = run([tool("OBJDUMP", "arm-none-eabi-objdump"), "-h", elf]).splitlines()
+    found = []
+    for i, line in enumerate(out):
+        parts = line.split()
+        if len(parts) == 7 and parts[0].isdigit() and i + 1 < len(out):
+            flags = out[i + 1]
+            if "ALLOC" not in flags:
+                continue
+            found.append({
+                "name": parts[1],
+                "size": int(parts[2], 16),
+                "vma": int(parts[3], 16),
+                "flash": "LOAD" in flags,         # has contents to put in flash
+                "ram": "READONLY" not in flags,   # written at run time
+            })
+    return found
+
+
+def ram_symbols(elf):
+    out = run([tool("NM", "arm-none-eabi-nm"), "-S", "--size-sort", elf])
+    syms = []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[2] in "bBdD":
+            syms.append((int(parts[1], 16), parts[3]))
+    return sorted(syms, reverse=True)
+
+
+def stack_sizes(paths):
+    # "display.c:463:6:printText	304	static", the name may carry a .constprop.0 or
+    # similar suffix. Statics with the same name in different files keep the bigger.
+    frames = {}
+    dynamic = set()
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, n) for n in names if n.endswith(".su")]
+        else:
+            files.append(path)
+    for path in files:
+        with open(path) as f:
+            for line in f:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) < 3:
+                    continue
+                name = parts[0].rsplit(":", 1)[-1]
+                frames[name] = max(frames.get(name, 0), int(parts[1]))
+                if "dynamic" in parts[2]:
+                    dynamic.add(name)
+    return frames, dynamic, len(files)
+
+
+def call_graph(elf):
+    # Function headers "08000120 <putImage>:" and calls "bl 8000298 <fillRectangle>".
+    # A branch to the start of another function is a tail call and counts as a call.
+    # x86 call and jmp are understood too so the report can be tried on a host build.
+    header = re.compile(r"^[0-9a-fA-F]+ <([^>]+)>:$")
+    direct = re.compile(r"\s(bl|b|b\.n|b\.w|call|callq|jmp|jmpq)\s+[0-9a-fA-F]+ <([^>+]+)>")
+    indirect = re.compile(r"\s(blx\s+r\d+|bx\s+r(?!14|lr)\d+|callq?\s+\*|jmpq?\s+\*)")
+    calls = {}
+    pointers = set()
+    current = None
+    for line in run([tool("OBJDUMP", "arm-none-eabi-objdump"), "-d", elf]).splitlines():
+        m = header.match(line)
+        if m:
+            current = m.group(1)
+            calls[current] = set()
+            continue
+        if current is None:
+            continue
+        m = direct.search(line)
+        if m and m.group(2) != current:
+            calls[current].add(m.group(2))
+        elif indirect.search(line) and "@plt" not in current:
+            pointers.add(current)  # a host build's PLT stubs jump through the GOT
+    return calls, pointers
+
+
+def address_taken(elf, secs):
+    # Functions whose address appears as a 32 bit word in the data sections or in a
+    # literal pool ("8000130:	08000121 	.word	0x08000121"). Thumb addresses have
+    # bit 0 set, so match with it cleared.
+    functions = {}
+    for line in run([tool("NM", "arm-none-eabi-nm"), elf]).splitlines():
+        parts = line.split()
+        if len(parts) == 3 and parts[1] in "tTwW":
+            functions[int(parts[0], 16) & ~1] = parts[2]
+    words = set()
+    names = [s["name"] for s in secs if s["name"].startswith((".rodata", ".data"))]
+    if names:
+        args = [tool("OBJDUMP", "arm-none-eabi-objdump"), "-s"]
+        for name in names:
+            args += ["-j", name]
+        data = bytearray()
+        # " 8000a00 01020304 05060708 090a0b0c 0d0e0f10  ................", the last
+        # line of a section may be short. Sections start word aligned.
+        for line in run(args + [elf]).splitlines():
+            if line.startswith("Contents of section"):
+                data += b"\0" * (-len(data) % 4)
+                continue
+            m = re.match(r"^ ([0-9a-f]+) ", line)
+            if m:
+                data += bytes.fromhex(line[len(m.group(0)):len(m.group(0)) + 35].replace(" ", ""))
+        for i in range(0, len(data) - 3, 4):
+            words.add(int.from_bytes(data[i:i + 4], "little"))
+    literal = re.compile(r"\.word\s+0x([0-9a-fA-F]+)")
+    for line in run([tool("OBJDUMP", "arm-none-eabi-objdump"), "-d", elf]).splitlines():
+        m = literal.search(line)
+        if m:
+            words.add(int(m.group(1), 16))
+    return set(functions[w & ~1] for w in words if w & ~1 in functions)
+
+
+def frame_of(name, frames):
+    if name in frames:
+        return frames[name]
+    return frames.get(name.split(".")[0])
+
+
+def worst(name, calls, frames, memo, path, recursive):
+    # Deepest stack from entering name, and the chain of calls that gets there
+    if name in memo:
+        return memo[name]
+    if name in path:
+        recursive.add(name)
+        return 0, []
+    path.add(name)
+    deepest, chain = 0, []
+    for callee in calls.get(name, ()):
+        depth, sub = worst(callee, calls, frames, memo, path, recursive)
+        if depth > deepest:
+            deepest, chain = depth, sub
+    path.discard(name)
+    own = frame_of(name, frames) or 0
+    memo[name] = (own + deepest, [name] + chain)
+    return memo[name]
+
+
+def paint_bytes():
+    # STACK_PAINT_BYTES and STACK_GUARD from stack.h
+    here = os.path.dirname(os.path.abspath(__file__))
+    values = {}
+    with open(os.path.join(here, "..", "stack.h")) as f:
+        for line in f:
+            m = re.match(r"#define (STACK_PAINT_BYTES|STACK_GUARD)\s+(\d+)", line)
+            if m:
+                values[m.group(1)] = int(m.group(2))
+    return values.get("STACK_PAINT_BYTES", 0) + values.get("STACK_GUARD", 0)
+
+
+def main():
+    if len(sys.argv) < 2 or sys.argv[1] in ("-h", "--help"):
+        sys.exit(__doc__)
+    elf = sys.argv[1]
+    frames, dynamic, su_files = stack_sizes(sys.argv[2:] or ["."])
+    if not su_files:
+        sys.exit("no .su files found, compile with -fstack-usage")
+
+    secs = sections(elf)
+    flash = sum(s["size"] for s in secs if s["flash"])
+    ram = sum(s["size"] for s in secs if s["ram"])
+    print("Sections")
+    print("  %-16s %7s %7s" % ("name", "flash", "ram"))
+    for s in secs:
+        print("  %-16s %7s %7s" % (s["name"], s["size"] if s["flash"] else "", s["size"] if s["ram"] else ""))
+    print("  %-16s %7d %7d" % ("total", flash, ram))
+    print("  flash %d of %d bytes (%.1f%%), static RAM %d of %d bytes (%.1f%%)"
+          % (flash, FLASH_SIZE, 100.0 * flash / FLASH_SIZE, ram, RAM_SIZE, 100.0 * ram / RAM_SIZE))
+
+    print("\nBiggest statics in RAM")
+    for size, name in ram_symbols(elf)[:10]:
+        print("  %6d  %s" % (size, name))
+
+    print("\nBiggest stack frames (from %d .su files)" % su_files)
+    for name, size in sorted(frames.items(), key=lambda kv: -kv[1])[:10]:
+        print("  %6d  %s%s" % (size, name, " (dynamic)" if name in dynamic else ""))
+
+    calls, pointers = call_graph(elf)
+    handlers = sorted(n for n in calls if HANDLER.search(n))
+    callbacks = set(n for n in address_taken(elf, secs) if n in calls and n != "main" and n not in handlers)
+    for name in pointers:
+        calls[name] |= callbacks - {name}
+    memo, recursive = {}, set()
+    main_depth, main_chain = worst("main", calls, frames, memo, set(), recursive)
+    print("\nWorst case stack")
+    print("  %6d  main: %s" % (main_depth, " > ".join(main_chain)))
+    interrupts = 0
+    for name in handlers:
+        depth, chain = worst(name, calls, frames, memo, set(), recursive)
+        interrupts += depth + EXCEPTION_FRAME
+        print("  %6d  %s: %s (+%d on entry)" % (depth, name, " > ".join(chain), EXCEPTION_FRAME))
+    total = main_depth + interrupts
+    print("  %6d  main with every interrupt nested on top" % total)
+    reached = set(memo)
+    unknown = sorted(n for n in reached if frame_of(n, frames) is None)
+    if unknown:
+        print("  no .su figure, counted as 0: " + ", ".join(unknown))
+    if pointers & reached:
+        print("  calls through pointers from %s taken to reach any of %d functions whose address is stored"
+              % (", ".join(sorted(pointers & reached)), len(callbacks)))
+    if recursive:
+        print("  recursion not followed in: " + ", ".join(sorted(recursive)))
+    dyn = sorted(dynamic & reached)
+    if dyn:
+        print("  frames that depend on run time values: " + ", ".join(dyn))
+
+    ok = ram + total <= RAM_SIZE
+    print("\nRAM: %d static + %d stack = %d of %d bytes, %s"
+          % (ram, total, ram + total, RAM_SIZE, "fits" if ok else "DOES NOT FIT"))
+    ram_secs = [s for s in secs if s["ram"] and RAM_ORIGIN <= s["vma"] < RAM_ORIGIN + RAM_SIZE]
+    if ram_secs:
+        statics_end = max(s["vma"] + s["size"] for s in ram_secs)
+        room = RAM_ORIGIN + RAM_SIZE - statics_end
+        window = paint_bytes() + (frame_of("main", frames) or 0)
+        print("Painted stack: %d bytes between the statics and the top of RAM, %d needed by "
+              "stack.c's window below main, %s" % (room, window, "clear" if room >= window else "OVERLAPS THE STATICS"))
+        ok = ok and room >= window
+    return 0 if ok else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
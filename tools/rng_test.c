@@ -0,0 +1,178 @@
+// Host check of the xorshift32 generator in rng.c.
+//   period       from the default seed the state comes back after exactly 2^32 - 1
+//                steps and not before, so it visits every non-zero state
+//   rng_fill     gives the same numbers as rng_next and leaves the same state
+//   rng_save     and rng_restore carry on the same sequence, seed 0 is not stuck
+//   rng_below    chi-squared over every value of a spread of bounds, in bounds
+//   rng_range    the same with a lower limit, and lower >= upper gives lower
+//   rng_fill     chi-squared over each byte of the words it fills
+// A chi-squared result fails if it is past the 0.1% critical value for its degrees of
+// freedom. Exits with 1 on the first failure.
+//
+// Build from the repository root with:
+//   cc -O2 -I. -o rng_test tools/rng_test.c rng.c -lm
+// Usage:
+//   ./rng_test [draws per bound]
+// Defaults to 1 million draws per bound.
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rng.h"
+
+#define DEFAULT_STATE 2463534242u // rng.c's starting state
+#define FILL_WORDS 4096
+#define Z_999 3.0902 // standard normal quantile for 99.9%
+
+static const uint32_t bounds[] = {2, 3, 5, 6, 7, 10, 12, 13, 16, 17, 60, 100, 128, 129, 255, 1000, 4096, 5000};
+#define BOUNDS (sizeof(bounds) / sizeof(bounds[0]))
+
+static uint32_t counts[5000];
+
+static double critical(uint32_t freedom);
+static double chi_squared(const uint32_t *count, uint32_t cells, double expected);
+
+int main(int argc, char *argv[])
+{
+	long draws = (argc > 1) ? atol(argv[1]) : 1000000;
+	uint32_t buffer[FILL_WORDS], filled[FILL_WORDS];
+	uint32_t first, steps;
+
+	// The period. rng_save reads the state without moving it.
+	rng_seed(DEFAULT_STATE);
+	first = rng_save();
+	steps = 0;
+	do
+	{
+		rng_next();
+		steps++;
+		if (rng_save() == 0)
+		{
+			printf("period: reached the zero state after %u steps\n", steps);
+			return 1;
+		}
+	} while (rng_save() != first && steps != 0xffffffffu);
+	if (rng_save() != first || steps != 0xffffffffu)
+	{
+		printf("period: back to the start after %u steps, expected 4294967295\n", steps);
+		return 1;
+	}
+	printf("period: 2^32 - 1 steps from the default seed, every non-zero state\n");
+
+	rng_seed(12345);
+	for (int i = 0; i < FILL_WORDS; i++)
+		buffer[i] = rng_next();
+	first = rng_save();
+	rng_seed(12345);
+	rng_fill(filled, FILL_WORDS);
+	if (memcmp(filled, buffer, sizeof(buffer)) != 0 || rng_save() != first)
+	{
+		printf("rng_fill: differs from rng_next\n");
+		return 1;
+	}
+	rng_seed(777);
+	rng_next();
+	first = rng_save();
+	steps = rng_next();
+	rng_restore(first);
+	if (rng_next() != steps)
+	{
+		printf("rng_restore: doesn't carry on the saved sequence\n");
+		return 1;
+	}
+	rng_seed(0);
+	if (rng_save() == 0)
+	{
+		printf("rng_seed(0): left the generator stuck at zero\n");
+		return 1;
+	}
+	printf("rng_fill, rng_save, rng_restore, rng_seed(0): as expected\n");
+
+	rng_seed(1);
+	for (uint32_t b = 0; b < BOUNDS; b++)
+	{
+		uint32_t bound = bounds[b];
+		double chi, limit = critical(bound - 1);
+		memset(counts, 0, sizeof(counts));
+		for (long i = 0; i < draws; i++)
+		{
+			uint32_t r = rng_below(bound);
+			if (r >= bound)
+			{
+				printf("rng_below(%u) gave %u\n", bound, r);
+				return 1;
+			}
+			counts[r]++;
+		}
+		chi = chi_squared(counts, bound, (double)draws / bound);
+		printf("rng_below(%u): chi-squared %.1f, 0.1%% critical %.1f\n", bound, chi, limit);
+		if (chi > limit)
+			return 1;
+	}
+	for (uint32_t b = 0; b < BOUNDS; b++)
+	{
+		uint32_t lower = 1000 * (b + 1);
+		uint32_t bound = bounds[b];
+		double chi, limit = critical(bound - 1);
+		memset(counts, 0, sizeof(counts));
+		for (long i = 0; i < draws; i++)
+		{
+			uint32_t r = rng_range(lower, lower + bound);
+			if (r < lower || r >= lower + bound)
+			{
+				printf("rng_range(%u, %u) gave %u\n", lower, lower + bound, r);
+				return 1;
+			}
+			counts[r - lower]++;
+		}
+		chi = chi_squared(counts, bound, (double)draws / bound);
+		printf("rng_range(%u, %u): chi-squared %.1f, 0.1%% critical %.1f\n", lower, lower + bound, chi, limit);
+		if (chi > limit)
+			return 1;
+	}
+	if (rng_range(5, 5) != 5 || rng_range(9, 3) != 9)
+	{
+		printf("rng_range: an empty range didn't give its lower limit\n");
+		return 1;
+	}
+
+	for (int byte = 0; byte < 4; byte++)
+	{
+		double chi, limit = critical(255);
+		long words = 0;
+		rng_seed(99);
+		memset(counts, 0, sizeof(counts));
+		while (words < draws)
+		{
+			rng_fill(buffer, FILL_WORDS);
+			for (int i = 0; i < FILL_WORDS; i++)
+				counts[(buffer[i] >> (8 * byte)) & 0xff]++;
+			words += FILL_WORDS;
+		}
+		chi = chi_squared(counts, 256, (double)words / 256);
+		printf("rng_fill byte %d: chi-squared %.1f, 0.1%% critical %.1f\n", byte, chi, limit);
+		if (chi > limit)
+			return 1;
+	}
+	return 0;
+}
+
+// The chi-squared value the statistic only passes 0.1% of the time, by the
+// Wilson-Hilferty approximation, which is close enough from a few degrees of freedom
+static double critical(uint32_t freedom)
+{
+	double k = freedom;
+	double t = 1.0 - 2.0 / (9.0 * k) + Z_999 * sqrt(2.0 / (9.0 * k));
+	return k * t * t * t;
+}
+static double chi_squared(const uint32_t *count, uint32_t cells, double expected)
+{
+	double sum = 0;
+	for (uint32_t i = 0; i < cells; i++)
+	{
+		double d = count[i] - expected;
+		sum += d * d / expected;
+	}
+	return sum;
+}
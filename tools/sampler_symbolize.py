@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Turn a sampler dump captured from the serial port into a flat profile.
+
+Build with SAMPLER defined, play for a while, go back to the main menu and
+capture the serial output. Then:
+
+    tools/sampler_symbolize.py firmware.elf capture.txt
+    tools/sampler_symbolize.py firmware.map capture.txt
+
+Symbols come from `nm` on the ELF (set NM to pick the tool, default
+arm-none-eabi-nm) or from a GNU ld map file. Each histogram bucket covers
+2^shift bytes of flash. A bucket that straddles several functions has its
+samples split between them in proportion to the bytes each one covers.
+"""
+import os
+import re
+import subprocess
+import sys
+from bisect import bisect_right
+
+
+def symbols_from_elf(path):
+    nm = os.environ.get("NM", "arm-none-eabi-nm")
+    out = subprocess.run([nm, "-n", "-S", "--defined-only", path],
+                         check=True, capture_output=True, text=True).stdout
+    syms = []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[2] in "tTwW":
+            # Thumb function addresses may carry the low bit
+            syms.append((int(parts[0], 16) & ~1, int(parts[1], 16), parts[3]))
+    return syms
+
+
+def symbols_from_map(path):
+    # Lines under .text look like "  0x08000120    putImage" once sections are laid out
+    pattern = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+([A-Za-z_][\w.]*)\s*$")
+    addrs = []
+    with open(path) as f:
+        for line in f:
+            m = pattern.match(line)
+            if m:
+                addrs.append((int(m.group(1), 16), m.group(2)))
+    addrs.sort()
+    # Map files don't give symbol sizes, assume each runs up to the next one
+    syms = []
+    for i, (addr, name) in enumerate(addrs):
+        end = addrs[i + 1][0] if i + 1 < len(addrs) else addr + 4
+        if end > addr:
+            syms.append((addr, end - addr, name))
+    return syms
+
+
+def read_dump(path):
+    header = None
+    buckets = []
+    src = sys.stdin if path == "-" else open(path, errors="replace")
+    for line in src:
+        line = line.strip()
+        if line.startswith("Sampler:"):
+            # Only the last dump in the capture counts
+            header = [int(v) for v in line.split()[1:5]]
+            buckets = []
+        elif line.startswith("S ") and header is not None:
+            _, addr, count = line.split()
+            buckets.append((int(addr), int(count)))
+    if header is None:
+        sys.exit("no 'Sampler:' dump found in " + path)
+    return header, buckets
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    image, capture = sys.argv[1], sys.argv[2]
+    syms = symbols_from_map(image) if image.endswith(".map") else symbols_from_elf(image)
+    syms.sort()
+    starts = [s[0] for s in syms]
+    (rate, shift, total, outside), buckets = read_dump(capture)
+    size = 1 << shift
+
+    profile = {}
+    for addr, count in buckets:
+        lo, hi = addr, addr + size
+        i = max(bisect_right(starts, lo) - 1, 0)
+        covered = []
+        while i < len(syms) and syms[i][0] < hi:
+            start, length, name = syms[i]
+            overlap = min(hi, start + length) - max(lo, start)
+            if overlap > 0:
+                covered.append((name, overlap))
+            i += 1
+        if not covered:
+            covered = [("?", size)]
+        span = sum(o for _, o in covered)
+        for name, overlap in covered:
+            profile[name] = profile.get(name, 0.0) + count * overlap / span
+
+    print("%d samples at %d Hz (%.1f s), %d outside flash, %d byte buckets"
+          % (total, rate, total / rate if rate else 0, outside, size))
+    print("%7s %9s  %s" % ("%", "samples", "function"))
+    for name, count in sorted(profile.items(), key=lambda kv: -kv[1]):
+        print("%6.2f%% %9.1f  %s" % (100.0 * count / total if total else 0, count, name))
+
+
+if __name__ == "__main__":
+    main()
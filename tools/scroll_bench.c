@@ -0,0 +1,216 @@
+// Host benchmark for the scrolling camera.
+// Walks the knight round level 3 with the display calls replaced by a model of the panel's
+// GRAM and vertical scroll. Reports the pixels pushed for each frame the camera moved,
+// and checks after every frame that whatever the panel shows matches the level.
+//
+// Build from the repository root with:
+//   cc -O2 -I. -o scroll_bench tools/scroll_bench.c camera.c
+// Usage:
+//   ./scroll_bench [laps]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "camera.h"
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 160
+#define LEVEL_WIDTH 256
+#define LEVEL_HEIGHT 256
+#define SPRITE_W 12
+#define SPRITE_H 16
+#define FULL_VIEW (CAMERA_VIEW_WIDTH * CAMERA_VIEW_HEIGHT)
+
+// Level 3 as laid out in main.c: keys, spikes and the door
+static const struct
+{
+	int x, y;
+} objects[] =
+{
+	{5, 140}, {230, 40}, {20, 225},
+	{25, 140}, {170, 60}, {120, 185},
+	{230, 225}
+};
+#define OBJECTS (int)(sizeof(objects) / sizeof(objects[0]))
+
+// Where the knight walks, one pixel per frame on each axis like the game at full speed
+static const struct
+{
+	int x, y;
+} route[] =
+{
+	{110, 40}, {110, 200}, {230, 200}, {230, 40}, {10, 40}, {10, 236}, {238, 236}, {120, 120}, {110, 40}
+};
+#define ROUTE (int)(sizeof(route) / sizeof(route[0]))
+
+static uint16_t gram[SCREEN_HEIGHT][SCREEN_WIDTH];
+static uint16_t scroll_top, scroll_height, scroll_start;
+static uint32_t pixels = 0;
+static uint16_t sprite[OBJECTS + 1][SPRITE_W * SPRITE_H]; // the last one is the knight
+static int knight_x, knight_y;
+
+static void level_redraw(int16_t x, int16_t y, uint16_t w, uint16_t h);
+static int in_area(int sx, int sy, int x, int y, int w, int h);
+static int view_matches(void);
+static uint16_t expected(int x, int y);
+static int compare_u32(const void *a, const void *b);
+
+// Stand-ins for display.c that draw into the model of GRAM
+void fillRectangle(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t colour)
+{
+	for (int j = 0; j < height; j++)
+		for (int i = 0; i < width; i++)
+			gram[y + j][x + i] = colour;
+	pixels += (uint32_t)width * height;
+}
+void putImageRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation, uint16_t sx, uint16_t sy, uint16_t sw, uint16_t sh)
+{
+	for (int j = 0; j < sh; j++)
+	{
+		int row = vOrientation ? height - (sy + j) - 1 : sy + j;
+		for (int i = 0; i < sw; i++)
+		{
+			int col = hOrientation ? width - (sx + i) - 1 : sx + i;
+			gram[y + j][x + i] = Image[row * width + col];
+		}
+	}
+	pixels += (uint32_t)sw * sh;
+}
+void putImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint16_t *Image, int hOrientation, int vOrientation)
+{
+	putImageRegion(x, y, width, height, Image, hOrientation, vOrientation, 0, 0, width, height);
+}
+void display_scroll_area(uint16_t top, uint16_t height)
+{
+	scroll_top = top;
+	scroll_height = height;
+}
+void display_scroll_to(uint16_t line)
+{
+	scroll_start = line;
+}
+void eputs(char *s)
+{
+	fputs(s, stdout);
+}
+void printDecimal(int32_t v)
+{
+	printf("%d", v);
+}
+
+int main(int argc, char *argv[])
+{
+	int laps = (argc > 1) ? atoi(argv[1]) : 1;
+	uint32_t *costs = malloc(sizeof(uint32_t) * 4096 * (laps > 0 ? laps : 1));
+	uint32_t frames = 0, moves = 0, total = 0, bad = 0, checks = 0;
+	int16_t last_x, last_y;
+	if (costs == 0)
+	{
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+	for (int n = 0; n <= OBJECTS; n++)
+		for (int i = 0; i < SPRITE_W * SPRITE_H; i++)
+			sprite[n][i] = (uint16_t)(((n + 1) << 8) | i);
+	knight_x = route[0].x;
+	knight_y = route[0].y;
+	camera_init(LEVEL_WIDTH, LEVEL_HEIGHT, knight_x, knight_y, level_redraw);
+	level_redraw(0, 0, LEVEL_WIDTH, LEVEL_HEIGHT); // what level_enter draws
+	camera_position(&last_x, &last_y);
+	for (int lap = 0; lap < laps; lap++)
+	{
+		for (int leg = 1; leg < ROUTE; leg++)
+		{
+			int still = 0;
+			while (!still)
+			{
+				int old_x = knight_x, old_y = knight_y;
+				int16_t cx, cy;
+				uint32_t before;
+				knight_x += (route[leg].x > knight_x) - (route[leg].x < knight_x);
+				knight_y += (route[leg].y > knight_y) - (route[leg].y < knight_y);
+				still = (knight_x == old_x && knight_y == old_y);
+				// Same order as level_render: follow, stream, then move the knight
+				camera_follow(knight_x, knight_y);
+				before = pixels;
+				camera_stream();
+				camera_position(&cx, &cy);
+				if (pixels != before || cx != last_x || cy != last_y)
+					costs[moves++] = pixels - before;
+				total += pixels - before;
+				last_x = cx;
+				last_y = cy;
+				camera_fill(old_x, old_y, SPRITE_W, SPRITE_H, 0);
+				for (int n = 0; n < OBJECTS; n++)
+					camera_put_image(objects[n].x, objects[n].y, SPRITE_W, SPRITE_H, sprite[n], 0, 0);
+				camera_put_image(knight_x, knight_y, SPRITE_W, SPRITE_H, sprite[OBJECTS], 0, 0);
+				frames++;
+				checks++;
+				if (!view_matches())
+				{
+					if (bad < 10)
+						printf("lap %d leg %d frame %u: view does not match the level\n", lap, leg, frames);
+					bad++;
+				}
+			}
+		}
+	}
+	qsort(costs, moves, sizeof(uint32_t), compare_u32);
+	printf("frames %u, camera moved on %u\n", frames, moves);
+	if (moves)
+	{
+		printf("pixels per scroll step: mean %u p50 %u p90 %u p99 %u max %u\n",
+		       total / moves, costs[moves / 2], costs[(uint64_t)moves * 90 / 100],
+		       costs[(uint64_t)moves * 99 / 100], costs[moves - 1]);
+		printf("redrawing the whole view instead: %u per step, %.1fx more\n",
+		       FULL_VIEW, (double)FULL_VIEW * moves / (total ? total : 1));
+	}
+	camera_report();
+	printf("views checked %u, mismatches %u\n", checks, bad);
+	free(costs);
+	return bad ? 1 : 0;
+}
+void level_redraw(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	// As main.c's, only the sprites that overlap the area
+	for (int n = 0; n < OBJECTS; n++)
+		if (in_area(objects[n].x, objects[n].y, x, y, w, h))
+			camera_put_image(objects[n].x, objects[n].y, SPRITE_W, SPRITE_H, sprite[n], 0, 0);
+	if (in_area(knight_x, knight_y, x, y, w, h))
+		camera_put_image(knight_x, knight_y, SPRITE_W, SPRITE_H, sprite[OBJECTS], 0, 0);
+}
+int in_area(int sx, int sy, int x, int y, int w, int h)
+{
+	return sx < x + w && sx + SPRITE_W > x && sy < y + h && sy + SPRITE_H > y;
+}
+int view_matches()
+{
+	// Read the view back the way the panel scans it out and compare with the level
+	int16_t cx, cy;
+	camera_position(&cx, &cy);
+	for (int line = scroll_top; line < scroll_top + scroll_height; line++)
+	{
+		int source = scroll_start + (line - scroll_top);
+		if (source >= scroll_top + scroll_height)
+			source -= scroll_height;
+		for (int col = 0; col < SCREEN_WIDTH; col++)
+			if (gram[source][col] != expected(cx + col, cy + line))
+				return 0;
+	}
+	return 1;
+}
+uint16_t expected(int x, int y)
+{
+	// The knight is drawn last so he is on top
+	if (x >= knight_x && x < knight_x + SPRITE_W && y >= knight_y && y < knight_y + SPRITE_H)
+		return sprite[OBJECTS][(y - knight_y) * SPRITE_W + (x - knight_x)];
+	for (int n = OBJECTS - 1; n >= 0; n--)
+		if (x >= objects[n].x && x < objects[n].x + SPRITE_W && y >= objects[n].y && y < objects[n].y + SPRITE_H)
+			return sprite[n][(y - objects[n].y) * SPRITE_W + (x - objects[n].x)];
+	return 0;
+}
+int compare_u32(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+	return (x > y) - (x < y);
+}
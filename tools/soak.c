@@ -0,0 +1,457 @@
+// Host soak test for the game logic.
+// Builds the game against the stand-in hardware in tools/host and has a bot play it
+// from the menu through to winning or losing, over and over in the same process so
+// anything a new game forgets to reset carries over into the next one. Games cycle
+// through the four difficulties and two bots: one that walks at random and one that
+// heads straight for the nearest key and then the door, stepping round spikes. The
+// state of the game is checked against its invariants every frame.
+//
+// Runs are shared out between one worker process per core. Reports completion rates,
+// frames per game, host time per frame and pixels sent to the panel per frame.
+// Exits with 1 if any invariant was broken.
+//
+// Build from the repository root with:
+//   cc -O2 -Itools/host -I. -o soak tools/soak.c tools/bot.c tools/host/host.c level.c anim.c boot.c camera.c enemy.c fastmath.c format.c grid.c hud.c levelgen.c motion.c path.c prbs.c profile.c rng.c scene.c sprites.c stack.c timebase.c transition.c watchdog.c
+// Usage:
+//   ./soak [runs] [workers] [seed]
+// Defaults to 2000 runs with a worker for every core.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host.h"
+#include "bot.h"
+
+// The game itself. Included rather than linked so the checks can see its state, with
+// its main renamed out of the way.
+#define main game_main
+#include "../main.c"
+#undef main
+
+#define RUN_LIMIT_MS (10 * 60 * 1000) // a game still going after this long is stuck
+#define FRAME_NS_BUCKETS 4096         // host time per frame, 100ns each, the last one is everything over
+#define FRAME_NS_BUCKET 100
+#define PIXEL_BUCKETS 321             // pixels per frame in 64s, up to a full screen and over
+#define PIXEL_BUCKET_SHIFT 6
+#define MAX_REPORTED 20               // violations each worker prints before going quiet
+
+static const char *const difficulty_names[DIFFICULTY_AMOUNT] = {"Easy", "Normal", "Hard", "Nightmare"};
+static const char *const bot_names[BOT_KINDS] = {"random", "greedy"};
+static const int hearts_for[DIFFICULTY_AMOUNT] = {3, 2, 1, 1};
+
+typedef struct
+{
+	uint32_t runs, won, lost, stuck;
+	uint32_t levels;  // levels completed
+	uint64_t frames;  // from leaving the menu to getting back to it
+} Outcome;
+
+typedef struct
+{
+	Outcome outcome[DIFFICULTY_AMOUNT][BOT_KINDS];
+	uint64_t frame_ns[FRAME_NS_BUCKETS];
+	uint64_t pixels[PIXEL_BUCKETS];
+	uint64_t frames;
+	uint64_t worst_ns;
+	uint64_t worst_pixels;
+	uint32_t violations;
+} Stats;
+
+typedef struct
+{
+	Bot bot;         // plays the levels, see bot.c
+	int difficulty;  // 1 to DIFFICULTY_AMOUNT, what to pick on the menus
+	uint8_t held;    // buttons held last frame
+	int card_frames; // frames left holding the buttons on the level card
+} Player;
+
+static Stats stats;
+static uint64_t rng_state;
+static int worker;
+static uint32_t run_id;
+static uint64_t run_frames;
+
+static uint32_t next_random(void);
+static uint64_t now_ns(void);
+static uint8_t player_buttons(Player *p);
+static uint8_t player_level(Player *p);
+static void frame(uint8_t held);
+static void check(void);
+static void violation(const char *what);
+static void play(int runs, int workers);
+static void merge(Stats *into, const Stats *from);
+static uint32_t percentile(const uint64_t *hist, int buckets, uint64_t total, int permille);
+
+int main(int argc, char *argv[])
+{
+	int runs = (argc > 1) ? atoi(argv[1]) : 2000;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	int workers = (argc > 2) ? atoi(argv[2]) : (int)((cores > 0) ? cores : 1);
+	uint32_t seed = (argc > 3) ? (uint32_t)strtoul(argv[3], 0, 0) : 1;
+	int *from;
+	Stats total, part;
+	if (workers < 1)
+		workers = 1;
+	if (workers > runs)
+		workers = runs ? runs : 1;
+	from = malloc(sizeof(int) * (size_t)workers);
+	if (from == 0)
+		return 1;
+	// Each worker starts from power on with its own stream of random numbers and
+	// sends its figures back when it is done. Stats is far bigger than PIPE_BUF, so
+	// writes from workers sharing a pipe could interleave and each gets its own.
+	for (int w = 0; w < workers; w++)
+	{
+		int fds[2];
+		pid_t pid;
+		if (pipe(fds) != 0)
+		{
+			perror("pipe");
+			return 1;
+		}
+		pid = fork();
+		if (pid < 0)
+		{
+			perror("fork");
+			return 1;
+		}
+		if (pid == 0)
+		{
+			const char *p = (const char *)&stats;
+			size_t left = sizeof(stats);
+			close(fds[0]);
+			for (int i = 0; i < w; i++)
+				close(from[i]);
+			worker = w;
+			rng_state = ((uint64_t)seed << 32) ^ (0x9e3779b97f4a7c15ull * (uint64_t)(w + 1));
+			play(runs, workers);
+			while (left)
+			{
+				ssize_t n = write(fds[1], p, left);
+				if (n <= 0)
+					_exit(2);
+				p += n;
+				left -= (size_t)n;
+			}
+			_exit(0);
+		}
+		close(fds[1]);
+		from[w] = fds[0];
+	}
+	memset(&total, 0, sizeof(total));
+	for (int w = 0; w < workers; w++)
+	{
+		char *p = (char *)&part;
+		size_t left = sizeof(part);
+		while (left)
+		{
+			ssize_t n = read(from[w], p, left);
+			if (n <= 0)
+			{
+				fprintf(stderr, "a worker died, see above\n");
+				return 1;
+			}
+			p += n;
+			left -= (size_t)n;
+		}
+		close(from[w]);
+		merge(&total, &part);
+	}
+	while (wait(0) > 0);
+	free(from);
+
+	printf("Soak: %d runs on %d workers, seed %u\n", runs, workers, (unsigned)seed);
+	printf("%-10s %-7s %6s %6s %6s %6s %11s %11s\n", "difficulty", "bot", "runs", "won", "lost", "stuck", "levels/run", "frames/run");
+	for (int d = 0; d < DIFFICULTY_AMOUNT; d++)
+	{
+		for (int b = 0; b < BOT_KINDS; b++)
+		{
+			Outcome *o = &total.outcome[d][b];
+			if (o->runs == 0)
+				continue;
+			printf("%-10s %-7s %6u %5.1f%% %5.1f%% %5.1f%% %11.2f %11.0f\n", difficulty_names[d], bot_names[b],
+			       (unsigned)o->runs, 100.0 * o->won / o->runs, 100.0 * o->lost / o->runs, 100.0 * o->stuck / o->runs,
+			       (double)o->levels / o->runs, (double)o->frames / o->runs);
+		}
+	}
+	printf("Frame time on this host (us): p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f over %llu frames\n",
+	       percentile(total.frame_ns, FRAME_NS_BUCKETS, total.frames, 500) * FRAME_NS_BUCKET / 1000.0,
+	       percentile(total.frame_ns, FRAME_NS_BUCKETS, total.frames, 900) * FRAME_NS_BUCKET / 1000.0,
+	       percentile(total.frame_ns, FRAME_NS_BUCKETS, total.frames, 990) * FRAME_NS_BUCKET / 1000.0,
+	       percentile(total.frame_ns, FRAME_NS_BUCKETS, total.frames, 999) * FRAME_NS_BUCKET / 1000.0,
+	       total.worst_ns / 1000.0, (unsigned long long)total.frames);
+	printf("Pixels per frame (64 pixel buckets): p50 %u p90 %u p99 %u p99.9 %u max %llu\n",
+	       (unsigned)(percentile(total.pixels, PIXEL_BUCKETS, total.frames, 500) << PIXEL_BUCKET_SHIFT),
+	       (unsigned)(percentile(total.pixels, PIXEL_BUCKETS, total.frames, 900) << PIXEL_BUCKET_SHIFT),
+	       (unsigned)(percentile(total.pixels, PIXEL_BUCKETS, total.frames, 990) << PIXEL_BUCKET_SHIFT),
+	       (unsigned)(percentile(total.pixels, PIXEL_BUCKETS, total.frames, 999) << PIXEL_BUCKET_SHIFT),
+	       (unsigned long long)total.worst_pixels);
+	printf("Invariant violations: %u\n", (unsigned)total.violations);
+	return total.violations ? 1 : 0;
+}
+
+// Plays this worker's share of the runs, one game after another
+static void play(int runs, int workers)
+{
+	Player player;
+	memset(&player, 0, sizeof(player));
+	// Set up as main does, then go straight to the frames. Nightmare is unlocked from
+	// the start so it gets played as often as the rest.
+	boot_start();
+	timebase_init();
+	path_set_budget_us(&enemy_world.flow, &enemy_world.grid, 400);
+	transition_set_budget(4096);
+	nightmare_enabled = 1;
+	GPIOA->IDR = GPIOB->IDR = 0xffff; // pull-ups, nothing pressed
+	game_init();
+	// The intro only plays once and leads straight to the difficulties, so the first
+	// run starts there and every one after it from the menu
+	while (scene_current() == &intro_scene)
+		frame(player_buttons(&player));
+	for (int r = worker; r < runs; r += workers)
+	{
+		int d = r % DIFFICULTY_AMOUNT;
+		int k = (r / DIFFICULTY_AMOUNT) % BOT_KINDS;
+		Outcome *o = &stats.outcome[d][k];
+		const Scene *last = scene_current();
+		uint32_t started = milliseconds_uptime;
+		int ended = 0;
+		run_id = (uint32_t)r;
+		run_frames = 0;
+		bot_init(&player.bot, k, ((uint64_t)next_random() << 32) | next_random());
+		player.difficulty = d + 1;
+		o->runs++;
+		// Leave the menu, play, and come back to it
+		while (!(ended && scene_current() == &menu_scene))
+		{
+			frame(player_buttons(&player));
+			if (scene_current() != last)
+			{
+				last = scene_current();
+				if (last == &complete_scene)
+					o->levels++;
+				if (last == &gameend_scene)
+				{
+					o->won++;
+					ended = 1;
+				}
+				if (last == &gameover_scene)
+				{
+					o->lost++;
+					ended = 1;
+				}
+			}
+			if (!ended && (milliseconds_uptime - started) > RUN_LIMIT_MS)
+			{
+				// Give up the way a game over would
+				o->stuck++;
+				ended = 1;
+				game_reset();
+				scene_change(&menu_scene);
+			}
+		}
+		o->frames += run_frames;
+	}
+}
+
+// One pass of the main loop: buttons, a game frame timed on the host, then the
+// rest of the frame's ticks
+static void frame(uint8_t held)
+{
+	uint32_t now = milliseconds_uptime;
+	uint64_t pixels = host_pixels;
+	uint64_t start, ns;
+	GPIOB->IDR = 0xffff & ~(((held & BUTTON_RIGHT) ? (1 << 4) : 0) | ((held & BUTTON_LEFT) ? (1 << 5) : 0));
+	GPIOA->IDR = 0xffff & ~(((held & BUTTON_UP) ? (1 << 11) : 0) | ((held & BUTTON_DOWN) ? (1 << 8) : 0));
+	SysTick->VAL = next_random() % 48000; // the level card's seed comes from here
+	watchdog_frame(scene_current() ? scene_current()->name : "boot");
+	start = now_ns();
+	game_frame(now);
+	ns = now_ns() - start;
+	pixels = host_pixels - pixels;
+	stats.frames++;
+	stats.frame_ns[(ns / FRAME_NS_BUCKET < FRAME_NS_BUCKETS) ? ns / FRAME_NS_BUCKET : FRAME_NS_BUCKETS - 1]++;
+	stats.pixels[((pixels >> PIXEL_BUCKET_SHIFT) < PIXEL_BUCKETS) ? (pixels >> PIXEL_BUCKET_SHIFT) : PIXEL_BUCKETS - 1]++;
+	if (ns > stats.worst_ns)
+		stats.worst_ns = ns;
+	if (pixels > stats.worst_pixels)
+		stats.worst_pixels = pixels;
+	run_frames++;
+	check();
+	host_tick(FRAME_MS);
+}
+
+// Works through the menus for the bot's difficulty, then hands over to its level play.
+// Menu choices are a press on one frame and a release on the next.
+static uint8_t player_buttons(Player *p)
+{
+	const Scene *s = scene_current();
+	uint8_t want = 0;
+	if (s == &level_scene)
+		return p->held = player_level(p);
+	if (s == &card_scene)
+	{
+		// Hold both for a few frames then let go
+		if (p->card_frames <= 0)
+			p->card_frames = 1 + (int)(next_random() % 8);
+		if (--p->card_frames > 0)
+			return p->held = BUTTON_LEFT | BUTTON_RIGHT;
+		return p->held = 0;
+	}
+	if (s == &intro_scene || s == &menu_scene || s == &gameover_scene)
+		want = BUTTON_UP;
+	else if (s == &difficulty_scene)
+		want = (p->difficulty == 1) ? BUTTON_LEFT : (p->difficulty == 2) ? BUTTON_DOWN : BUTTON_RIGHT;
+	else if (s == &nightmare_scene)
+		want = (p->difficulty == DIFFICULTY_AMOUNT) ? BUTTON_UP : BUTTON_DOWN;
+	else if (s == &complete_scene)
+		want = BUTTON_LEFT;
+	else if (s == &gameend_scene)
+		want = BUTTON_RIGHT;
+	p->card_frames = 0;
+	return p->held = p->held ? 0 : want;
+}
+
+// Buttons for a frame of a level, from the way the bot wants to go
+static uint8_t player_level(Player *p)
+{
+	BotView v;
+	int xdir, ydir;
+	v.layout = layout;
+	v.x = player_x;
+	v.y = player_y;
+	v.down = (knight_state == KNIGHT_DOWN);
+	v.key_pickup = key_pickup;
+	v.enemies = skeletons;
+	bot_move(&p->bot, &v, &xdir, &ydir);
+	return ((xdir > 0) ? BUTTON_RIGHT : 0) | ((xdir < 0) ? BUTTON_LEFT : 0) |
+	       ((ydir > 0) ? BUTTON_UP : 0) | ((ydir < 0) ? BUTTON_DOWN : 0);
+}
+
+// Things that should always be true of the game's state after a frame
+static void check(void)
+{
+	const Scene *s = scene_current();
+	if (s == 0)
+	{
+		violation("no scene");
+		return;
+	}
+	// Finishing level 3 takes it to 4 on the way to the end screen
+	if (current_level < 1 || current_level > 4 || (current_level == 4 && s != &complete_scene && s != &gameend_scene))
+		violation("current_level out of range");
+	if (difficulty < 0 || difficulty > DIFFICULTY_AMOUNT)
+		violation("difficulty out of range");
+	if (timer < 0 || timer > 60)
+		violation("Nightmare timer out of range");
+	if (s != &level_scene)
+	{
+		// The level's exit has run
+		if (timer_active(&countdown_timer) || timer_active(&music_timer))
+			violation("level timer still running outside a level");
+		if (host_note != 0)
+			violation("sound still playing outside a level");
+	}
+	if (s == &menu_scene && (current_level != 1 || timer != 60 || difficulty != 0))
+		violation("menu reached without a full reset");
+	// Only once level_update has got as far as moving the knight is this level's state
+	// all in place, before that it may still be the last level's
+	if (s == &level_scene && last_frame == milliseconds_uptime)
+	{
+		int found = 0;
+		int width = layout->width ? layout->width : 128;
+		int height = layout->height ? layout->height : 160;
+		if (difficulty < 1 || num_of_hearts != hearts_for[difficulty - 1])
+			violation("hearts don't match the difficulty");
+		if (heart_gone < 0 || heart_gone > num_of_hearts || (heart_gone == num_of_hearts && knight_state != KNIGHT_DOWN))
+			violation("heart_gone out of range");
+		for (int i = 0; i < LEVEL_MAX_KEYS; i++)
+		{
+			if (key_pickup[i] && i >= layout->num_keys)
+				violation("key picked up that isn't in the level");
+			found += key_pickup[i] != 0;
+		}
+		if (found != amount_keys)
+			violation("amount_keys doesn't match key_pickup");
+		if (knight_state > KNIGHT_SHIELDED)
+			violation("knight_state out of range");
+		if (player_x + 12 > width || player_y + 16 > height)
+			violation("knight outside the level");
+		for (int i = 0; i < layout->num_enemies; i++)
+		{
+			if (skeletons[i].x < 0 || skeletons[i].y < 0 || skeletons[i].x + ENEMY_WIDTH > width || skeletons[i].y + ENEMY_HEIGHT > height)
+				violation("skeleton outside the level");
+		}
+		if (knight_state != KNIGHT_DOWN && !timer_active(&music_timer))
+			violation("no music while the knight is up");
+		if ((difficulty == DIFFICULTY_AMOUNT) != timer_active(&countdown_timer))
+			violation("countdown running when it shouldn't be or not when it should");
+	}
+}
+
+static void violation(const char *what)
+{
+	if (stats.violations++ < MAX_REPORTED)
+		fprintf(stderr, "worker %d run %u frame %llu scene %s: %s\n", worker, (unsigned)run_id,
+		        (unsigned long long)run_frames, scene_current() ? scene_current()->name : "none", what);
+}
+
+static void merge(Stats *into, const Stats *from)
+{
+	for (int d = 0; d < DIFFICULTY_AMOUNT; d++)
+	{
+		for (int b = 0; b < BOT_KINDS; b++)
+		{
+			Outcome *o = &into->outcome[d][b];
+			const Outcome *f = &from->outcome[d][b];
+			o->runs += f->runs;
+			o->won += f->won;
+			o->lost += f->lost;
+			o->stuck += f->stuck;
+			o->levels += f->levels;
+			o->frames += f->frames;
+		}
+	}
+	for (int i = 0; i < FRAME_NS_BUCKETS; i++)
+		into->frame_ns[i] += from->frame_ns[i];
+	for (int i = 0; i < PIXEL_BUCKETS; i++)
+		into->pixels[i] += from->pixels[i];
+	into->frames += from->frames;
+	into->violations += from->violations;
+	if (from->worst_ns > into->worst_ns)
+		into->worst_ns = from->worst_ns;
+	if (from->worst_pixels > into->worst_pixels)
+		into->worst_pixels = from->worst_pixels;
+}
+
+// The bucket that permille thousandths of the samples are at or below
+static uint32_t percentile(const uint64_t *hist, int buckets, uint64_t total, int permille)
+{
+	uint64_t want = (total * permille + 999) / 1000;
+	uint64_t seen = 0;
+	for (int i = 0; i < buckets; i++)
+	{
+		seen += hist[i];
+		if (seen >= want && seen)
+			return (uint32_t)i;
+	}
+	return (uint32_t)(buckets - 1);
+}
+
+// xorshift64*, one stream per worker
+static uint32_t next_random(void)
+{
+	rng_state ^= rng_state >> 12;
+	rng_state ^= rng_state << 25;
+	rng_state ^= rng_state >> 27;
+	return (uint32_t)((rng_state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
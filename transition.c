@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include "display.h"
+#include "palette.h"
+#include "transition.h"
+
+// Without a frame buffer a transition can't blend the old screen into the new one, but
+// it can spread the full screen clear (20480 pixels, ~20ms of SPI) over several frames
+// so no single frame stalls and the buttons are still read while it runs.
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 160
+#define COLUMN_WIDTH 4
+#define COLUMNS (SCREEN_WIDTH / COLUMN_WIDTH)
+#define FADE_STEPS 3
+
+static uint32_t budget = 4096; // pixels per frame, roughly 4ms at the 24MHz SPI clock
+static int type = TRANSITION_NONE;
+static int busy = 0;
+static int position = 0; // row for wipes, strip for columns
+static int pass = 0;     // fade ramp entry being drawn
+static uint16_t ramp[FADE_STEPS];
+
+void transition_set_budget(uint32_t pixels)
+{
+	budget = pixels;
+}
+void transition_start(int new_type, uint16_t colour)
+{
+	type = new_type;
+	position = 0;
+	pass = 0;
+	busy = (type != TRANSITION_NONE);
+	// Greys stepping down to the target, brightest first. Colours come from
+	// palette.h since the panel wants the bytes of each pixel swapped.
+	ramp[0] = COLOUR_GREY;
+	ramp[1] = COLOUR_DARK_GREY;
+	ramp[2] = colour;
+	if (type == TRANSITION_CUT)
+		ramp[0] = colour;
+}
+int transition_busy()
+{
+	return busy;
+}
+static int strip_order(int i)
+{
+	// Reverse the five bits of the strip number so consecutive steps land far apart
+	int r = 0;
+	for (int b = 0; b < 5; b++)
+		r |= ((i >> b) & 1) << (4 - b);
+	return r;
+}
+int transition_step()
+{
+	// Draws at most one frame's budget of the transition, returns 1 once it is complete
+	uint32_t pixels = 0;
+	if (!busy)
+		return 1;
+	switch (type)
+	{
+		case TRANSITION_CUT:
+			fillRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, ramp[0]);
+			busy = 0;
+			break;
+		case TRANSITION_COLUMNS:
+			while (position < COLUMNS && (pixels == 0 || pixels + COLUMN_WIDTH * SCREEN_HEIGHT <= budget))
+			{
+				fillRectangle(strip_order(position) * COLUMN_WIDTH, 0, COLUMN_WIDTH, SCREEN_HEIGHT, ramp[FADE_STEPS - 1]);
+				pixels += COLUMN_WIDTH * SCREEN_HEIGHT;
+				position++;
+			}
+			busy = (position < COLUMNS);
+			break;
+		case TRANSITION_WIPE:
+		case TRANSITION_FADE:
+		{
+			// A wipe is a single pass in the target colour, a fade wipes through the ramp
+			uint16_t colour = (type == TRANSITION_WIPE) ? ramp[FADE_STEPS - 1] : ramp[pass];
+			int rows = budget / SCREEN_WIDTH;
+			if (rows < 1)
+				rows = 1;
+			if (rows > SCREEN_HEIGHT - position)
+				rows = SCREEN_HEIGHT - position;
+			fillRectangle(0, position, SCREEN_WIDTH, rows, colour);
+			position += rows;
+			if (position >= SCREEN_HEIGHT)
+			{
+				position = 0;
+				pass++;
+				if (type == TRANSITION_WIPE || pass >= FADE_STEPS)
+					busy = 0;
+			}
+			break;
+		}
+		default:
+			busy = 0;
+			break;
+	}
+	return !busy;
+}
@@ -0,0 +1,12 @@
+#include <stdint.h>
+// How the screen is cleared on the way into a scene
+#define TRANSITION_NONE 0     // leave the screen as it is
+#define TRANSITION_CUT 1      // all at once, as fillRectangle always did
+#define TRANSITION_WIPE 2     // top to bottom in bands
+#define TRANSITION_COLUMNS 3  // vertical strips revealed in an interleaved order
+#define TRANSITION_FADE 4     // passes through a ramp of colours that ends on the target
+
+void transition_set_budget(uint32_t pixels);
+void transition_start(int type, uint16_t colour);
+int transition_step(void);
+int transition_busy(void);
@@ -0,0 +1,108 @@
+#include <stm32f031x6.h>
+#include "watchdog.h"
+#include "profile.h"
+#include "serial.h"
+
+// The IWDG runs from the ~40kHz LSI, which can be anywhere between 30 and 50kHz, so
+// the reload is worked out for 40kHz and the real timeout may be 20% shorter.
+#define LSI_HZ 40000
+#define IWDG_PRESCALER 4 // divide by 64
+#define IWDG_RELOAD ((uint32_t)WATCHDOG_TIMEOUT_MS * (LSI_HZ / 64) / 1000)
+#define CRASH_MAGIC 0xdeadc0de
+#define ZONE_DEPTH 4 // nested zones remembered, deeper ones only count
+#define FLASH_START 0x08000000u
+#define FLASH_END 0x08008000u
+
+// What the game was doing, updated as it runs. Lives in .noinit so it is still there
+// after the watchdog has reset the chip, the magic word says it was written by us.
+typedef struct
+{
+	uint32_t magic;
+	uint32_t frames;     // frames since boot
+	uint32_t uptime;     // milliseconds_uptime at the last kick from the frame loop
+	const char *scene;   // name of the scene running, in flash
+	uint8_t depth;       // zones entered and not yet left
+	uint8_t zones[ZONE_DEPTH];
+} CrashRecord;
+
+extern volatile uint32_t milliseconds_uptime;
+
+static CrashRecord record __attribute__((section(".noinit")));
+
+void watchdog_start()
+{
+	// Call watchdog_report first, this starts a new record
+	record.magic = CRASH_MAGIC;
+	record.frames = 0;
+	record.uptime = 0;
+	record.scene = "boot";
+	record.depth = 0;
+	// Stop the count while a debugger has the core halted
+	RCC->APB2ENR |= (1 << 22);  // enable DBGMCU
+	DBGMCU->APB1FZ |= (1 << 12); // DBG_IWDG_STOP
+	IWDG->KR = 0xcccc; // start, this also turns the LSI on
+	IWDG->KR = 0x5555; // allow writes to PR and RLR
+	IWDG->PR = IWDG_PRESCALER;
+	IWDG->RLR = IWDG_RELOAD;
+	while (IWDG->SR != 0); // wait for both to reach the LSI clock domain
+	IWDG->KR = 0xaaaa;
+}
+void watchdog_kick()
+{
+	IWDG->KR = 0xaaaa;
+}
+void watchdog_frame(const char *scene)
+{
+	// Called once a frame by the frame loop, the only place that kicks in normal running.
+	// Every zone has been left by now, starting the count afresh keeps one missed
+	// WATCHDOG_ZONE_LEAVE from spoiling the trail for good.
+	record.frames++;
+	record.depth = 0;
+	record.uptime = milliseconds_uptime;
+	record.scene = scene;
+	IWDG->KR = 0xaaaa;
+}
+void watchdog_enter(int zone)
+{
+	if (record.depth < ZONE_DEPTH)
+		record.zones[record.depth] = (uint8_t)zone;
+	record.depth++;
+}
+void watchdog_leave(int zone)
+{
+	if (record.depth)
+		record.depth--;
+}
+void watchdog_report()
+{
+	// Only after a watchdog reset: say where the game was when it stopped kicking
+	uint8_t depth = record.depth;
+	if (record.magic != CRASH_MAGIC)
+	{
+		eputs("Watchdog: reset, no record\r\n");
+		return;
+	}
+	eputs("Watchdog: reset in ");
+	// The scene name is a pointer into flash, check it is one before following it
+	if ((uintptr_t)record.scene >= FLASH_START && (uintptr_t)record.scene < FLASH_END)
+		eputs((char *)record.scene);
+	else
+		eputs("?");
+	eputs(" after ");
+	printDecimal((int32_t)record.frames);
+	eputs(" frames, ");
+	printDecimal((int32_t)record.uptime);
+	eputs("ms up, zones");
+	if (depth > ZONE_DEPTH)
+		depth = ZONE_DEPTH;
+	if (depth == 0)
+		eputs(" none");
+	for (uint8_t i = 0; i < depth; i++)
+	{
+		eputs(" ");
+		eputs((char *)profile_zone_name(record.zones[i]));
+	}
+	if (record.depth > ZONE_DEPTH)
+		eputs(" ...");
+	eputs("\r\n");
+}
@@ -0,0 +1,27 @@
+#include <stdint.h>
+// The IWDG resets the chip if the frame loop stops kicking it, i.e. if anything hangs
+// or blocks for longer than WATCHDOG_TIMEOUT_MS. What was running is kept in RAM that
+// survives the reset and reported on the way back up.
+// The longest the loop blocks is the serial reports at the end of a game, around 0.7s
+// for the profile and stack lines at 9600 baud (the sampler kicks between its lines),
+// then display_wake's 120ms. 3s stays well clear of both even with a fast LSI.
+#define WATCHDOG_TIMEOUT_MS 3000
+
+void watchdog_start(void);
+void watchdog_kick(void);
+void watchdog_frame(const char *scene);
+void watchdog_enter(int zone);
+void watchdog_leave(int zone);
+void watchdog_report(void);
+
+// The zones the crash record lists, numbered as the profiler's. Each mark is a call, so
+// they only go round code that could block long enough to starve the watchdog, never
+// hot leaf code, and only in the main loop: an interrupt would race its updates.
+// Define WATCHDOG_NO_TRAIL to leave them out.
+#ifndef WATCHDOG_NO_TRAIL
+#define WATCHDOG_ZONE_ENTER(zone) watchdog_enter(zone)
+#define WATCHDOG_ZONE_LEAVE(zone) watchdog_leave(zone)
+#else
+#define WATCHDOG_ZONE_ENTER(zone) ((void)0)
+#define WATCHDOG_ZONE_LEAVE(zone) ((void)0)
+#endif